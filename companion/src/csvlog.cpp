@@ -0,0 +1,390 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "csvlog.h"
+#include <string.h>
+
+static const double powersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+
+static inline bool isBlank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline bool parseDigits(const char *& p, const char * end, int count, int & value)
+{
+  value = 0;
+  for (int i=0; i<count; i++, p++) {
+    if (p >= end || *p < '0' || *p > '9')
+      return false;
+    value = value * 10 + (*p - '0');
+  }
+  return true;
+}
+
+static inline bool parseSeparator(const char *& p, const char * end, char separator)
+{
+  if (p < end && *p == separator) {
+    p++;
+    return true;
+  }
+  return false;
+}
+
+// Same result as QString::toDouble(), the usual [-]ddd.ddd values don't need any allocation:
+// both the mantissa and the power of 10 are exact doubles, so is the rounding of their quotient
+static double parseDouble(const char * field, int length)
+{
+  const char * p = field;
+  const char * end = field + length;
+  bool negative = false;
+  qint64 mantissa = 0;
+  int digits = 0;
+  int decimals = -1;
+
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p++ == '-');
+  }
+  for (; p < end; p++) {
+    if (*p >= '0' && *p <= '9') {
+      mantissa = mantissa * 10 + (*p - '0');
+      digits++;
+      if (decimals >= 0)
+        decimals++;
+    }
+    else if (*p == '.' && decimals < 0) {
+      decimals = 0;
+    }
+    else {
+      break;
+    }
+  }
+
+  if (p == end && digits > 0 && digits <= 15) {
+    double result = (double)mantissa;
+    if (decimals > 0)
+      result /= powersOf10[decimals];
+    return negative ? -result : result;
+  }
+
+  return QByteArray(field, length).toDouble();
+}
+
+// Timestamps are in local time, as displayed by the plot, the offset is only computed when the hour changes
+class TimestampParser {
+  public:
+    TimestampParser():
+      hourKey(-1),
+      hourStart(0)
+    {
+    }
+
+    bool parse(const char * date, int dateLength, const char * time, int timeLength, qint64 & result)
+    {
+      int year, month, day, hours, minutes, seconds, msecs = 0;
+
+      const char * p = date;
+      const char * end = date + dateLength;
+      if (!parseDigits(p, end, 4, year) || !parseSeparator(p, end, '-') || !parseDigits(p, end, 2, month) ||
+          !parseSeparator(p, end, '-') || !parseDigits(p, end, 2, day) || p != end)
+        return false;
+
+      p = time;
+      end = time + timeLength;
+      if (!parseDigits(p, end, 2, hours) || !parseSeparator(p, end, ':') || !parseDigits(p, end, 2, minutes) ||
+          !parseSeparator(p, end, ':') || !parseDigits(p, end, 2, seconds))
+        return false;
+      if (parseSeparator(p, end, '.')) {
+        for (int scale = 100; p < end && *p >= '0' && *p <= '9'; p++, scale /= 10) {
+          msecs += (*p - '0') * scale;
+        }
+      }
+      if (p != end || minutes > 59 || seconds > 59)
+        return false;
+
+      qint64 key = ((qint64)year * 10000 + month * 100 + day) * 100 + hours;
+      if (key != hourKey) {
+        QDateTime hour(QDate(year, month, day), QTime(hours, 0));
+        if (!hour.isValid())
+          return false;
+        hourKey = key;
+        hourStart = hour.toMSecsSinceEpoch();
+      }
+
+      result = hourStart + (minutes * 60 + seconds) * 1000 + msecs;
+      return true;
+    }
+
+  protected:
+    qint64 hourKey;
+    qint64 hourStart;
+};
+
+CsvLog::CsvLog():
+  data(NULL),
+  dataEnd(NULL),
+  sorted(true),
+  invalidLines(0),
+  totalLines(0)
+{
+}
+
+CsvLog::~CsvLog()
+{
+  clear();
+}
+
+void CsvLog::clear()
+{
+  file.close(); // unmaps the file
+  data = NULL;
+  dataEnd = NULL;
+  contents.clear();
+  names.clear();
+  lineOffsets.clear();
+  timestamps.clear();
+  columns.clear();
+  pyramids.clear();
+  sessionsStart.clear();
+  sorted = true;
+  invalidLines = 0;
+  totalLines = 0;
+}
+
+bool CsvLog::load(const QString & filename)
+{
+  clear();
+
+  file.setFileName(filename);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  qint64 size = file.size();
+  data = (const char *)file.map(0, size);
+  if (!data) {
+    contents = file.readAll();
+    data = contents.constData();
+    size = contents.size();
+  }
+
+  if (size < 9 || strncmp(data, "Date,Time", 9)) {
+    clear();
+    return false;
+  }
+
+  TimestampParser timestampParser;
+  QVarLengthArray<const char *, 128> fields;
+  const char * end = dataEnd = data + size;
+  int numfields = -1;
+
+  for (const char * next = data; next < end; ) {
+    const char * start = next;
+    const char * eol = (const char *)memchr(start, '\n', end - start);
+    next = eol ? eol + 1 : end;
+    eol = eol ? eol : end;
+
+    while (start < eol && isBlank(*start)) start++;
+    while (eol > start && isBlank(eol[-1])) eol--;
+
+    // fields[i] is the start of the field i, fields[count] is after the end of the line
+    fields.clear();
+    fields.append(start);
+    for (const char * p = start; (p = (const char *)memchr(p, ',', eol - p)) != NULL; ) {
+      fields.append(++p);
+    }
+    fields.append(eol + 1);
+    int count = fields.size() - 1;
+
+    if (numfields < 0) {
+      names = QString::fromUtf8(start, eol - start).split(',');
+      numfields = count;
+      columns.resize(numfields);
+      pyramids.resize(numfields);
+      continue;
+    }
+
+    totalLines++;
+
+    qint64 timestamp;
+    if (count != numfields ||
+        !timestampParser.parse(fields[0], fields[1] - fields[0] - 1, fields[1], fields[2] - fields[1] - 1, timestamp)) {
+      invalidLines++;
+      continue;
+    }
+
+    if (timestamps.isEmpty() || (timestamp - timestamps.last()) / 1000 > CSVLOG_SESSION_GAP) {
+      sessionsStart.append(timestamps.size());
+    }
+    if (!timestamps.isEmpty() && timestamp < timestamps.last()) {
+      sorted = false;
+    }
+
+    lineOffsets.append(start - data);
+    timestamps.append(timestamp);
+    for (int i=2; i<numfields; i++) {
+      columns[i].append(parseDouble(fields[i], fields[i+1] - fields[i] - 1));
+    }
+  }
+
+  return true;
+}
+
+const char * CsvLog::lineEnd(int row) const
+{
+  const char * start = data + lineOffsets.at(row);
+  const char * end = (row + 1 < lineOffsets.size()) ? data + lineOffsets.at(row + 1) : dataEnd;
+  const char * eol = (const char *)memchr(start, '\n', end - start);
+  if (eol) end = eol;
+  while (end > start && isBlank(end[-1])) end--;
+  return end;
+}
+
+QByteArray CsvLog::line(int row) const
+{
+  const char * start = data + lineOffsets.at(row);
+  return QByteArray(start, lineEnd(row) - start);
+}
+
+const char * CsvLog::field(int row, int column, int & length) const
+{
+  const char * start = data + lineOffsets.at(row);
+  const char * end = lineEnd(row);
+  for (int i=0; i<column; i++) {
+    start = (const char *)memchr(start, ',', end - start) + 1;
+  }
+  const char * separator = (const char *)memchr(start, ',', end - start);
+  length = (separator ? separator : end) - start;
+  return start;
+}
+
+QString CsvLog::text(int row, int column) const
+{
+  int length;
+  const char * start = field(row, column, length);
+  return QString::fromUtf8(start, length);
+}
+
+void CsvLog::findRows(qint64 from, qint64 to, int & first, int & last) const
+{
+  first = 0;
+  last = rowCount() - 1;
+  if (sorted && rowCount() > 0) {
+    // one more record on each side, so that the lines go up to the plot borders
+    first = std::lower_bound(timestamps.begin(), timestamps.end(), from) - timestamps.begin() - 1;
+    last = std::upper_bound(timestamps.begin(), timestamps.end(), to) - timestamps.begin();
+    first = std::max(first, 0);
+    last = std::min(last, rowCount() - 1);
+  }
+}
+
+const CsvLog::Pyramid & CsvLog::pyramid(int column)
+{
+  Pyramid & result = pyramids[column];
+
+  if (result.isEmpty()) {
+    const QVector<double> & values = columns.at(column);
+    int count = values.size();
+
+    // level 0 would be the values themselves
+    result.append(QVector<int>());
+
+    QVector<int> level((count + 1) / 2 * 2);
+    for (int i=0; i<count; i+=2) {
+      int j = std::min(i + 1, count - 1);
+      level[i] = values.at(j) < values.at(i) ? j : i;
+      level[i+1] = values.at(j) > values.at(i) ? j : i;
+    }
+    result.append(level);
+
+    while (level.size() > 2) {
+      int buckets = level.size() / 2;
+      QVector<int> next((buckets + 1) / 2 * 2);
+      for (int b=0; b<buckets; b+=2) {
+        int c = std::min(b + 1, buckets - 1);
+        int minA = level.at(2*b), minB = level.at(2*c);
+        int maxA = level.at(2*b+1), maxB = level.at(2*c+1);
+        next[b] = values.at(minB) < values.at(minA) ? minB : minA;
+        next[b+1] = values.at(maxB) > values.at(maxA) ? maxB : maxA;
+      }
+      result.append(next);
+      level = next;
+    }
+  }
+
+  return result;
+}
+
+void CsvLog::appendPoint(int column, int row, QVector<double> & x, QVector<double> & y) const
+{
+  x.append(timestamps.at(row) / 1000.0);
+  y.append(columns.at(column).at(row));
+}
+
+void CsvLog::appendMinMax(int column, int minRow, int maxRow, QVector<double> & x, QVector<double> & y) const
+{
+  appendPoint(column, std::min(minRow, maxRow), x, y);
+  if (minRow != maxRow) {
+    appendPoint(column, std::max(minRow, maxRow), x, y);
+  }
+}
+
+void CsvLog::decimate(int column, int first, int last, int buckets, QVector<double> & x, QVector<double> & y)
+{
+  if (first > last) {
+    return;
+  }
+
+  int count = last - first + 1;
+  int level = 0;
+  while ((count >> level) > buckets) {
+    level++;
+  }
+
+  if (level == 0) {
+    for (int row=first; row<=last; row++) {
+      appendPoint(column, row, x, y);
+    }
+    return;
+  }
+
+  const Pyramid & levels = pyramid(column);
+  level = std::min(level, levels.size() - 1);
+  const QVector<int> & minMax = levels.at(level);
+  const QVector<double> & values = columns.at(column);
+
+  for (int b=(first >> level); b<=(last >> level); b++) {
+    int from = b << level;
+    int to = from + (1 << level) - 1;
+    if (from < first || to > last) {
+      // the blocks at the edges of the range are only partly in it
+      int minRow = std::max(from, first);
+      int maxRow = minRow;
+      for (int row=minRow+1; row<=std::min(to, last); row++) {
+        if (values.at(row) < values.at(minRow)) minRow = row;
+        if (values.at(row) > values.at(maxRow)) maxRow = row;
+      }
+      appendMinMax(column, minRow, maxRow, x, y);
+    }
+    else {
+      appendMinMax(column, minMax.at(2*b), minMax.at(2*b+1), x, y);
+    }
+  }
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef _CSVLOG_H_
+#define _CSVLOG_H_
+
+#include <QtCore>
+
+// Consecutive records further apart than this are in different flight sessions
+#define CSVLOG_SESSION_GAP             60 // seconds
+
+/*
+ * A telemetry log file (Date,Time,... CSV columns).
+ *
+ * The file is mapped in memory and parsed once: the timestamps and the values
+ * are converted to columns of numbers, the text of a cell is only extracted
+ * from the file when it is displayed or exported.
+ */
+class CsvLog {
+  public:
+    CsvLog();
+    ~CsvLog();
+
+    bool load(const QString & filename);
+    void clear();
+
+    int rowCount() const
+    {
+      return timestamps.size();
+    }
+
+    int columnCount() const
+    {
+      return names.size();
+    }
+
+    const QStringList & header() const
+    {
+      return names;
+    }
+
+    // lines with a wrong number of columns or an invalid timestamp, they are skipped
+    int errors() const
+    {
+      return invalidLines;
+    }
+
+    int lines() const
+    {
+      return totalLines;
+    }
+
+    // milliseconds since epoch (local time)
+    qint64 timestamp(int row) const
+    {
+      return timestamps.at(row);
+    }
+
+    QDateTime dateTime(int row) const
+    {
+      return QDateTime::fromMSecsSinceEpoch(timestamps.at(row));
+    }
+
+    double value(int row, int column) const
+    {
+      return columns.at(column).at(row);
+    }
+
+    QString text(int row, int column) const;
+
+    // the record as in the file, without the end of line
+    QByteArray line(int row) const;
+
+    // first row of each flight session
+    const QVector<int> & sessions() const
+    {
+      return sessionsStart;
+    }
+
+    // rows range [first, last] of the records between times from and to (in ms)
+    void findRows(qint64 from, qint64 to, int & first, int & last) const;
+
+    // appends the points of rows [first, last] to x (in seconds) and y, at most
+    // 2 * buckets of them: the min and the max of each bucket at their own time
+    void decimate(int column, int first, int last, int buckets, QVector<double> & x, QVector<double> & y);
+
+  protected:
+    // level k (k >= 1) holds the rows of the min and of the max of each block of 2^k rows
+    typedef QVector< QVector<int> > Pyramid;
+
+    const Pyramid & pyramid(int column);
+    void appendPoint(int column, int row, QVector<double> & x, QVector<double> & y) const;
+    void appendMinMax(int column, int minRow, int maxRow, QVector<double> & x, QVector<double> & y) const;
+    const char * lineEnd(int row) const;
+    const char * field(int row, int column, int & length) const;
+
+    QFile file;
+    const char * data;
+    const char * dataEnd;
+    QByteArray contents; // when the file can't be mapped
+    QStringList names;
+    QVector<qint64> lineOffsets;
+    QVector<qint64> timestamps;
+    QVector< QVector<double> > columns;
+    QVector<Pyramid> pyramids;
+    QVector<int> sessionsStart;
+    bool sorted;
+    int invalidLines;
+    int totalLines;
+};
+
+#endif // _CSVLOG_H_
@@ -24,7 +24,88 @@
 #include "customdebug.h"
 
 #include <QtCore>
-#include <QBitArray>
+
+/*
+ * The fields are packed LSB first, without any alignment, as in the firmware
+ * PACK() structures. The streams work on whole bytes: a field needs one
+ * shift and one mask per byte it spans, instead of one operation per bit.
+ */
+
+class BitsWriter {
+  public:
+    explicit BitsWriter(QByteArray & bytes):
+      bytes(bytes),
+      offset(0)
+    {
+    }
+
+    // the high bits of value above 64 bits are considered null (spare bits)
+    void write(uint64_t value, unsigned int bits)
+    {
+      reserve(offset + bits);
+      uint8_t * data = (uint8_t *)bytes.data();
+      if (bits < 64)
+        value &= ((uint64_t)1 << bits) - 1;
+      while (bits > 0) {
+        unsigned int shift = offset & 7;
+        unsigned int count = std::min(8 - shift, bits);
+        data[offset >> 3] |= (uint8_t)(value << shift);
+        value >>= count;
+        offset += count;
+        bits -= count;
+      }
+    }
+
+    unsigned int count() const
+    {
+      return offset;
+    }
+
+  protected:
+    void reserve(unsigned int bits)
+    {
+      int size = (bits + 7) / 8;
+      if (size > bytes.size()) {
+        int previous = bytes.size();
+        bytes.resize(size);
+        memset(bytes.data() + previous, 0, size - previous);
+      }
+    }
+
+    QByteArray & bytes;
+    unsigned int offset;
+};
+
+class BitsReader {
+  public:
+    BitsReader(const uint8_t * data, unsigned int size):
+      data(data),
+      size(size),
+      offset(0)
+    {
+    }
+
+    // reading after the end of the buffer returns null bits
+    uint64_t read(unsigned int bits)
+    {
+      uint64_t value = 0;
+      for (unsigned int done = 0; done < bits; ) {
+        unsigned int shift = offset & 7;
+        unsigned int count = std::min(8 - shift, bits - done);
+        unsigned int index = offset >> 3;
+        if (index < size && done < 64)
+          value |= (uint64_t)((data[index] >> shift) & ((1 << count) - 1)) << done;
+        offset += count;
+        done += count;
+      }
+      return value;
+    }
+
+  protected:
+    const uint8_t * data;
+    unsigned int size;
+    unsigned int offset;
+};
 
 class DataField {
   Q_DECLARE_TR_FUNCTIONS(DataField)
@@ -46,60 +127,42 @@ class DataField {
     }
 
     virtual unsigned int size() = 0;
-    virtual void ExportBits(QBitArray & output) = 0;
-    virtual void ImportBits(const QBitArray & input) = 0;
-
-    QBitArray bytesToBits(QByteArray bytes)
-    {
-      QBitArray bits(bytes.count()*8);
-      // Convert from QByteArray to QBitArray
-      for (int i=0; i<bytes.count(); ++i)
-        for (int b=0; b<8; ++b)
-          bits.setBit(i*8+b, bytes.at(i)&(1<<b));
-      return bits;
-    }
-
-    QByteArray bitsToBytes(QBitArray bits, int offset=0)
-    {
-      QByteArray bytes;
-      bytes.resize((offset+bits.count()+7)/8);
-      bytes.fill(0);
-      // Convert from QBitArray to QByteArray
-      for (int b=0; b<bits.count(); ++b)
-        bytes[(b+offset)/8] = ( bytes.at((b+offset)/8) | ((bits[b]?1:0)<<((b+offset)%8)));
-      return bytes;
-    }
+    // Each field writes / reads exactly size() bits
+    virtual void ExportBits(BitsWriter & output) = 0;
+    virtual void ImportBits(BitsReader & input) = 0;
 
     int Export(QByteArray & output)
     {
-      QBitArray result;
-      ExportBits(result);
-      output = bitsToBytes(result);
+      output.fill(0, (size()+7)/8);
+      BitsWriter writer(output);
+      ExportBits(writer);
+      output.resize((writer.count()+7)/8);
       return 0;
     }
 
     int Import(const QByteArray & input)
     {
-      QBitArray bits = bytesToBits(input);
-      if ((unsigned int)bits.size() < size()) {
+      if ((unsigned int)input.size()*8 < size()) {
         qDebug() << QString("Error importing %1: size to small %2/%3").arg(getName()).arg(input.size()).arg(size());
         return -1;
       }
-      ImportBits(bits);
+      BitsReader reader((const uint8_t *)input.constData(), input.size());
+      ImportBits(reader);
       return 0;
     }
 
     virtual int Dump(int level=0, int offset=0)
     {
-      QBitArray bits;
-      ExportBits(bits);
-      QByteArray bytes = bitsToBytes(bits);
-      int result = (offset+bits.count()) % 8;
+      QByteArray bytes;
+      BitsWriter writer(bytes);
+      ExportBits(writer);
+      int bits = writer.count();
+      int result = (offset+bits) % 8;
       for (int i=0; i<level; i++) printf("  ");
-      if (bits.count() % 8 == 0)
+      if (bits % 8 == 0)
         printf("%s (%dbytes) ", getName().toLatin1().constData(), bytes.count());
       else
-        printf("%s (%dbits) ", getName().toLatin1().constData(), bits.count());
+        printf("%s (%dbits) ", getName().toLatin1().constData(), bits);
       for (int i=0; i<bytes.count(); i++) {
         unsigned char c = bytes[i];
         if ((i==0 && offset) || (i==bytes.count()-1 && result!=0))
@@ -164,27 +227,18 @@ class BaseUnsignedField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitsWriter & output)
     {
       container value = field;
       if (value > max) value = max;
       if (value < min) value = min;
 
-      output.resize(N);
-      for (int i=0; i<N; i++) {
-        if (value & ((container)1<<i)) {
-          output.setBit(i);
-        }
-      }
+      output.write(value, N);
     }
 
-    virtual void ImportBits(const QBitArray & input)
+    virtual void ImportBits(BitsReader & input)
     {
-      field = 0;
-      for (int i=0; i<N; i++) {
-        if (input[i])
-          field |= ((container)1<<i);
-      }
+      field = (container)input.read(N);
       qCDebug(eepromImport) << QString("\timported %1<%2>: 0x%3(%4)").arg(name).arg(N).arg(field, 0, 16).arg(field);
     }
 
@@ -231,17 +285,14 @@ class BoolField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitsWriter & output)
     {
-      output.resize(N);
-      if (field) {
-        output.setBit(0);
-      }
+      output.write(field ? 1 : 0, N);
     }
 
-    virtual void ImportBits(const QBitArray & input)
+    virtual void ImportBits(BitsReader & input)
     {
-      field = input[0] ? true : false;
+      field = (input.read(N) & 1) ? true : false;
       qCDebug(eepromImport) << QString("\timported %1<%2>: 0x%3(%4)").arg(name).arg(N).arg(field, 0, 16).arg(field);
     }
 
@@ -284,31 +335,22 @@ class SignedField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitsWriter & output)
     {
       int value = field;
       if (value > max) value = max;
       if (value < min) value = min;
 
-      output.resize(N);
-      for (int i=0; i<N; i++) {
-        if (((unsigned int)value) & (1<<i))
-          output.setBit(i);
-      }
+      output.write((unsigned int)value, N);
     }
 
-    virtual void ImportBits(const QBitArray & input)
+    virtual void ImportBits(BitsReader & input)
     {
-      unsigned int value = 0;
-      for (int i=0; i<N; i++) {
-        if (input[i])
-          value |= (1<<i);
-      }
+      unsigned int value = input.read(N);
 
-      if (input[N-1]) {
-        for (unsigned int i=N; i<8*sizeof(int); i++) {
-          value |= (1<<i);
-        }
+      // sign extension
+      if (value & (1u << (N-1))) {
+        value |= ~((1u << (N-1)) - 1);
       }
 
       field = (int)value;
@@ -348,30 +390,18 @@ class CharField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitsWriter & output)
     {
-      output.resize(N*8);
-      int b = 0;
       int len = truncate ? strlen(field) : N;
       for (int i=0; i<N; i++) {
-        int idx = (i>=len ? 0 : field[i]);
-        for (int j=0; j<8; j++, b++) {
-          if (idx & (1<<j))
-            output.setBit(b);
-        }
+        output.write((uint8_t)(i>=len ? 0 : field[i]), 8);
       }
     }
 
-    virtual void ImportBits(const QBitArray & input)
+    virtual void ImportBits(BitsReader & input)
     {
-      unsigned int b = 0;
       for (int i=0; i<N; i++) {
-        int8_t idx = 0;
-        for (int j=0; j<8; j++) {
-          if (input[b++])
-            idx |= (1<<j);
-        }
-        field[i] = idx;
+        field[i] = (int8_t)input.read(8);
       }
       qCDebug(eepromImport) << QString("\timported %1<%2>: '%3'").arg(name).arg(N).arg(field);
     }
@@ -423,30 +453,18 @@ class ZCharField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitsWriter & output)
     {
-      output.resize(N*8);
-      int b = 0;
       int len = strlen(field);
       for (int i=0; i<N; i++) {
-        int idx = i>=len ? 0 : char2idx(field[i]);
-        for (int j=0; j<8; j++, b++) {
-          if (idx & (1<<j))
-            output.setBit(b);
-        }
+        output.write((uint8_t)(i>=len ? 0 : char2idx(field[i])), 8);
       }
     }
 
-    virtual void ImportBits(const QBitArray & input)
+    virtual void ImportBits(BitsReader & input)
     {
-      unsigned int b = 0;
       for (int i=0; i<N; i++) {
-        int8_t idx = 0;
-        for (int j=0; j<8; j++) {
-          if (input[b++])
-            idx |= (1<<j);
-        }
-        field[i] = idx2char(idx);
+        field[i] = idx2char((int8_t)input.read(8));
       }
 
       field[N] = '\0';
@@ -486,29 +504,18 @@ class StructField: public DataField {
       fields.append(field);
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitsWriter & output)
     {
-      int offset = 0;
-      output.resize(size());
       foreach(DataField *field, fields) {
-        QBitArray bits;
-        field->ExportBits(bits);
-        for (int i=0; i<bits.size(); i++)
-          output[offset++] = bits[i];
+        field->ExportBits(output);
       }
     }
 
-    virtual void ImportBits(const QBitArray & input)
+    virtual void ImportBits(BitsReader & input)
     {
       qCDebug(eepromImport) << QString("\timporting %1[%2]:").arg(name).arg(fields.size());
-      int offset = 0;
       foreach(DataField *field, fields) {
-        unsigned int size = field->size();
-        QBitArray bits(size);
-        for (unsigned int i=0; i<size; i++) {
-          bits[i] = input[offset++];
-        }
-        field->ImportBits(bits);
+        field->ImportBits(input);
       }
     }
 
@@ -547,13 +554,13 @@ class TransformedField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitsWriter & output)
     {
       beforeExport();
       field.ExportBits(output);
     }
 
-    virtual void ImportBits(const QBitArray & input)
+    virtual void ImportBits(BitsReader & input)
     {
       qCDebug(eepromImport) << QString("\timporting TransformedField %1:").arg(field.getName());
       field.ImportBits(input);
@@ -68,6 +68,9 @@ inline int switchIndex(int i, Board::Type board, unsigned int version)
     return i;
 }
 
+// The conversion tables caches are shared by the models decoded in parallel
+static QMutex conversionTablesMutex;
+
 class SwitchesConversionTable: public ConversionTable {
 
   public:
@@ -210,6 +213,7 @@ class SwitchesConversionTable: public ConversionTable {
 
     static SwitchesConversionTable * getInstance(Board::Type board, unsigned int version, unsigned long flags=0)
     {
+      QMutexLocker locker(&conversionTablesMutex);
       for (std::list<Cache>::iterator it=internalCache.begin(); it!=internalCache.end(); it++) {
         Cache & element = *it;
         if (element.board == board && element.version == version && element.flags == flags)
@@ -222,6 +226,7 @@ class SwitchesConversionTable: public ConversionTable {
     }
     static void Cleanup()
     {
+      QMutexLocker locker(&conversionTablesMutex);
       for (std::list<Cache>::iterator it=internalCache.begin(); it!=internalCache.end(); it++) {
         Cache & element = *it;
         if (element.table)
@@ -401,6 +406,7 @@ class SourcesConversionTable: public ConversionTable {
 
     static SourcesConversionTable * getInstance(Board::Type board, unsigned int version, unsigned int variant, unsigned long flags=0)
     {
+      QMutexLocker locker(&conversionTablesMutex);
       for (std::list<Cache>::iterator it=internalCache.begin(); it!=internalCache.end(); it++) {
         Cache & element = *it;
         if (element.board == board && element.version == version && element.variant == variant && element.flags == flags)
@@ -413,6 +419,7 @@ class SourcesConversionTable: public ConversionTable {
     }
     static void Cleanup()
     {
+      QMutexLocker locker(&conversionTablesMutex);
       for (std::list<Cache>::iterator it=internalCache.begin(); it!=internalCache.end(); it++) {
         Cache & element = *it;
         if (element.table)
@@ -2622,7 +2629,7 @@ class FrskyScreenField: public DataField {
       }
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitsWriter & output)
     {
       if (IS_ARM(board) && version >= 217) {
         if (screen.type == TELEMETRY_SCREEN_SCRIPT)
@@ -2642,7 +2649,7 @@ class FrskyScreenField: public DataField {
       }
     }
 
-    virtual void ImportBits(const QBitArray & input)
+    virtual void ImportBits(BitsReader & input)
     {
       qCDebug(eepromImport) << QString("importing %1: type: %2").arg(name).arg(screen.type);
 
@@ -3051,7 +3058,7 @@ OpenTxModelData::OpenTxModelData(ModelData & modelData, Board::Type board, unsig
   variant(variant),
   protocolsConversionTable(board)
 {
-  sprintf(name, "Model %s", modelData.name);
+  reset();
 
   qCDebug(eepromImport) << QString("OpenTxModelData::OpenTxModelData(name: %1, board: %2, ver: %3, var: %4)").arg(name).arg(board).arg(version).arg(variant);
 
@@ -3425,6 +3432,12 @@ OpenTxModelData::OpenTxModelData(ModelData & modelData, Board::Type board, unsig
   }
 }
 
+void OpenTxModelData::reset()
+{
+  sprintf(name, "Model %s", modelData.name);
+  _errors.clear();
+}
+
 void OpenTxModelData::beforeExport()
 {
   // qDebug() << QString("before export model") << modelData.name;
@@ -3552,12 +3565,12 @@ OpenTxGeneralData::OpenTxGeneralData(GeneralSettings & generalData, Board::Type
   generalData(generalData),
   board(board),
   version(version),
+  variant(variant),
   inputsCount(CPN_MAX_STICKS+MAX_POTS(board, version)+MAX_SLIDERS(board)+MAX_MOUSE_ANALOGS(board))
 {
   qCDebug(eepromImport) << QString("OpenTxGeneralData::OpenTxGeneralData(board: %1, version:%2, variant:%3)").arg(board).arg(version).arg(variant);
 
-  generalData.version = version;
-  generalData.variant = variant;
+  reset();
 
   internalField.Append(new UnsignedField<8>(this, generalData.version));
   if (version >= 213 || (!IS_ARM(board) && version >= 212))
@@ -3849,6 +3862,13 @@ OpenTxGeneralData::OpenTxGeneralData(GeneralSettings & generalData, Board::Type
   }
 }
 
+void OpenTxGeneralData::reset()
+{
+  generalData.version = version;
+  generalData.variant = variant;
+  _errors.clear();
+}
+
 void OpenTxGeneralData::beforeExport()
 {
   uint16_t sum = 0;
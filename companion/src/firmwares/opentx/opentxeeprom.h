@@ -48,6 +48,9 @@ class OpenTxGeneralData: public TransformedField {
       return _errors;
     }
 
+    // Prepares the fields tree to be used again, on new contents of the data it is bound to
+    void reset();
+
   protected:
     virtual void beforeExport();
     virtual void afterImport();
@@ -62,6 +65,7 @@ class OpenTxGeneralData: public TransformedField {
     GeneralSettings & generalData;
     Board::Type board;
     unsigned int version;
+    unsigned int variant;
     int inputsCount;
     unsigned int chkSum;
     QStringList _errors;
@@ -130,6 +134,9 @@ class OpenTxModelData: public TransformedField {
       return _errors;
     }
 
+    // Prepares the fields tree to be used again, on new contents of the data it is bound to
+    void reset();
+
   protected:
     virtual void beforeExport();
     virtual void afterImport();
@@ -25,6 +25,7 @@
 #include "constants.h"
 #include <bitset>
 #include <QMessageBox>
+#include <QThreadStorage>
 #include <QTime>
 #include <QUrl>
 #include <companion/src/storage/storage.h>
@@ -134,6 +135,56 @@ bool OpenTxEepromInterface::loadModelFromRLE(ModelData & model, RleFile * rleFil
   return true;
 }
 
+/*
+ * Building the fields tree costs more than the import / export itself, and the tree only
+ * depends on the board, the version and the variant. It is built once per thread and kept
+ * bound to a scratch copy of the data, which is swapped with the data to load or save.
+ */
+template <class T, class M>
+class DataManager {
+  public:
+    DataManager(Board::Type board, unsigned int version, unsigned int variant):
+      manager(data, board, version, variant)
+    {
+    }
+
+    T data;
+    M manager;
+};
+
+template <class T, class M>
+class DataManagersCache {
+  public:
+    ~DataManagersCache()
+    {
+      qDeleteAll(managers);
+    }
+
+    DataManager<T, M> * get(Board::Type board, unsigned int version, unsigned int variant)
+    {
+      quint64 key = ((quint64)board << 40) | ((quint64)version << 32) | variant;
+      DataManager<T, M> * result = managers.value(key);
+      if (!result) {
+        result = new DataManager<T, M>(board, version, variant);
+        managers.insert(key, result);
+      }
+      return result;
+    }
+
+  protected:
+    QHash<quint64, DataManager<T, M> *> managers;
+};
+
+template <class T, class M>
+static DataManager<T, M> * getDataManager(Board::Type board, unsigned int version, unsigned int variant)
+{
+  static QThreadStorage<DataManagersCache<T, M> *> caches;
+  if (!caches.hasLocalData()) {
+    caches.setLocalData(new DataManagersCache<T, M>());
+  }
+  return caches.localData()->get(board, version, variant);
+}
+
 template <class T, class M>
 bool OpenTxEepromInterface::saveToByteArray(const T & src, QByteArray & data, uint8_t version)
 {
@@ -141,10 +192,11 @@ bool OpenTxEepromInterface::saveToByteArray(const T & src, QByteArray & data, ui
     version = getLastDataVersion(getBoard());
   }
   QByteArray raw;
-  T srcCopy(src); // work on a copy of radio data, because Export() will modify it!
-  M manager(srcCopy, board, version, 0);
-  // manager.Dump();
-  manager.Export(raw);
+  DataManager<T, M> * cached = getDataManager<T, M>(board, version, 0);
+  cached->data = src; // work on a copy of radio data, because Export() will modify it!
+  cached->manager.reset();
+  // cached->manager.Dump();
+  cached->manager.Export(raw);
   data.resize(8);
   *((uint32_t*)&data.data()[0]) = Boards::getFourCC(board);
   data[4] = version;
@@ -157,11 +209,14 @@ bool OpenTxEepromInterface::saveToByteArray(const T & src, QByteArray & data, ui
 template <class T, class M>
 bool OpenTxEepromInterface::loadFromByteArray(T & dest, const QByteArray & data, uint8_t version, uint32_t variant)
 {
-  M manager(dest, board, version, variant);
-  if (manager.Import(data) != 0) {
+  DataManager<T, M> * cached = getDataManager<T, M>(board, version, variant);
+  cached->data = dest;
+  cached->manager.reset();
+  if (cached->manager.Import(data) != 0) {
     return false;
   }
-  // manager.Dump(); // Dumps the structure so that it's easy to check with firmware datastructs.h
+  // cached->manager.Dump(); // Dumps the structure so that it's easy to check with firmware datastructs.h
+  dest = cached->data;
   return true;
 }
 
@@ -29,6 +29,59 @@
 #include <unistd.h>
 #endif
 
+// The log table cells are only converted to text when they are displayed
+class LogsTableModel: public QAbstractTableModel
+{
+  public:
+    LogsTableModel(QObject * parent, CsvLog & log):
+      QAbstractTableModel(parent),
+      log(log)
+    {
+    }
+
+    bool load(const QString & filename)
+    {
+      beginResetModel();
+      bool result = log.load(filename);
+      endResetModel();
+      return result;
+    }
+
+    void clear()
+    {
+      beginResetModel();
+      log.clear();
+      endResetModel();
+    }
+
+    virtual int rowCount(const QModelIndex & parent = QModelIndex()) const
+    {
+      return parent.isValid() ? 0 : log.rowCount();
+    }
+
+    virtual int columnCount(const QModelIndex & parent = QModelIndex()) const
+    {
+      return parent.isValid() ? 0 : log.columnCount();
+    }
+
+    virtual QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const
+    {
+      if (index.isValid() && role == Qt::DisplayRole)
+        return log.text(index.row(), index.column());
+      return QVariant();
+    }
+
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const
+    {
+      if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section < log.columnCount())
+        return log.header().at(section);
+      return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+  protected:
+    CsvLog & log;
+};
+
 LogsDialog::LogsDialog(QWidget *parent) :
   QDialog(parent, Qt::WindowTitleHint | Qt::WindowSystemMenuHint),
   ui(new Ui::LogsDialog),
@@ -37,9 +90,9 @@ LogsDialog::LogsDialog(QWidget *parent) :
   cursorB(0),
   cursorLine(0)
 {
-  csvlog.clear();
-
   ui->setupUi(this);
+  logModel = new LogsTableModel(this, csvlog);
+  ui->logTable->setModel(logModel);
   setWindowIcon(CompanionIcon("logs.png"));
 
   plotLock=false;
@@ -110,13 +163,15 @@ LogsDialog::LogsDialog(QWidget *parent) :
 
   // make left axes transfer its range to right axes:
   connect(axisRect->axis(QCPAxis::atLeft), SIGNAL(rangeChanged(QCPRange)), this, SLOT(yAxisChangeRanges(QCPRange)));
+  // take the graphs points again for the new time range:
+  connect(axisRect->axis(QCPAxis::atBottom), SIGNAL(rangeChanged(QCPRange)), this, SLOT(xAxisChangeRange(QCPRange)));
 
   // connect some interaction slots:
   connect(ui->customPlot, SIGNAL(titleDoubleClick(QMouseEvent*, QCPPlotTitle*)), this, SLOT(titleDoubleClick(QMouseEvent*, QCPPlotTitle*)));
   connect(ui->customPlot, SIGNAL(axisDoubleClick(QCPAxis*,QCPAxis::SelectablePart,QMouseEvent*)), this, SLOT(axisLabelDoubleClick(QCPAxis*,QCPAxis::SelectablePart)));
   connect(ui->customPlot, SIGNAL(legendDoubleClick(QCPLegend*,QCPAbstractLegendItem*,QMouseEvent*)), this, SLOT(legendDoubleClick(QCPLegend*,QCPAbstractLegendItem*)));
   connect(ui->FieldsTW, SIGNAL(itemSelectionChanged()), this, SLOT(plotLogs()));
-  connect(ui->logTable, SIGNAL(itemSelectionChanged()), this, SLOT(plotLogs()));
+  connect(ui->logTable->selectionModel(), SIGNAL(selectionChanged(QItemSelection, QItemSelection)), this, SLOT(plotLogs()));
   connect(ui->Reset_PB, SIGNAL(clicked()), this, SLOT(plotLogs()));
   connect(ui->SaveSession_PB, SIGNAL(clicked()), this, SLOT(saveSession()));
 }
@@ -236,38 +291,33 @@ void LogsDialog::selectionChanged()
   }
 }
 
-QList<QStringList> LogsDialog::filterGePoints(const QList<QStringList> & input)
+QVector<int> LogsDialog::filterGePoints()
 {
-  QList<QStringList> result;
+  QVector<int> result;
 
-  int n = input.count();
+  int n = csvlog.rowCount();
   if (n == 0) {
     return result;
   }
 
-  int gpscol = 0;
-  for (int i=1; i<input.at(0).count(); i++) {
-    if (input.at(0).at(i) == "GPS") {
-      gpscol=i;
-    }
-  }
-  if (gpscol == 0) {
+  int gpscol = csvlog.header().lastIndexOf("GPS");
+  if (gpscol <= 0) {
     QMessageBox::critical(this, tr("Error: no GPS data found"),
       tr("The column containing GPS coordinates must be named \"GPS\".\n\n\
 The columns for altitude \"GAlt\" and for speed \"GSpd\" are optional"));
     return result;
   }
 
-  result.append(input.at(0));
-  bool rangeSelected = ui->logTable->selectionModel()->selectedRows().length() > 0;
+  QItemSelectionModel * selection = ui->logTable->selectionModel();
+  bool rangeSelected = selection->hasSelection();
 
   GpsGlitchFilter glitchFilter;
   GpsLatLonFilter latLonFilter;
 
-  for (int i = 1; i < n; i++) {
-    if ((ui->logTable->item(i-1, 1)->isSelected() && rangeSelected) || !rangeSelected) {
+  for (int i = 0; i < n; i++) {
+    if ((selection->isRowSelected(i, QModelIndex()) && rangeSelected) || !rangeSelected) {
 
-      GpsCoord coord = extractGpsCoordinates(input.at(i).at(gpscol));
+      GpsCoord coord = extractGpsCoordinates(csvlog.text(i, gpscol));
 
       // glitch filter
       if ( glitchFilter.isGlitch(coord) ) {
@@ -282,38 +332,40 @@ The columns for altitude \"GAlt\" and for speed \"GSpd\" are optional"));
       }
 
       // qDebug() << "point " << latitude << longitude;
-      result.append(input.at(i));
+      result.append(i);
     }
   }
 
-  // qDebug() << "filterGePoints(): filtered from" << input.count() << "to " << result.count() << "points";
+  // qDebug() << "filterGePoints(): filtered from" << n << "to " << result.count() << "points";
   return result;
 }
 
 void LogsDialog::exportToGoogleEarth()
 {
   // filter data points
-  QList<QStringList> dataPoints = filterGePoints(csvlog);
+  QVector<int> dataPoints = filterGePoints();
   int n = dataPoints.count(); // number of points to export
   if (n==0) return;
 
+  const QStringList & header = csvlog.header();
+
   int gpscol=0, altcol=0, speedcol=0;
   double altMultiplier = 1.0;
 
   QSet<int> nondataCols;
-  for (int i=1; i<dataPoints.at(0).count(); i++) {
+  for (int i=1; i<header.count(); i++) {
     // Long,Lat,Course,GPS Speed,GPS Alt
-    if (dataPoints.at(0).at(i) == "GPS") {
+    if (header.at(i) == "GPS") {
       gpscol=i;
     }
-    if (dataPoints.at(0).at(i).contains("GAlt")) {
+    if (header.at(i).contains("GAlt")) {
       altcol = i;
       nondataCols << i;
-      if (dataPoints.at(0).at(i).contains("(ft)")) {
+      if (header.at(i).contains("(ft)")) {
         altMultiplier = 0.3048;    // feet to meters
       }
     }
-    if (dataPoints.at(0).at(i).contains("GSpd")) {
+    if (header.at(i).contains("GSpd")) {
       speedcol = i;
       nondataCols << i;
     }
@@ -353,9 +405,9 @@ void LogsDialog::exportToGoogleEarth()
   outputStream << "\t\t\t<gx:SimpleArrayField name=\"GPSSpeed\" type=\"float\">\n\t\t\t\t<displayName>GPS Speed</displayName>\n\t\t\t</gx:SimpleArrayField>\n";
 
   // declare additional fields
-  for (int i=0; i<dataPoints.at(0).count()-2; i++) {
+  for (int i=0; i<header.count()-2; i++) {
     if (ui->FieldsTW->item(i, 0) && ui->FieldsTW->item(i, 0)->isSelected() && !nondataCols.contains(i+2)) {
-      QString origName = dataPoints.at(0).at(i+2);
+      QString origName = header.at(i+2);
       QString safeName = origName;
       safeName.replace(" ","_");
       outputStream << "\t\t\t<gx:SimpleArrayField name=\""<< safeName <<"\" ";
@@ -378,17 +430,17 @@ void LogsDialog::exportToGoogleEarth()
   outputStream << "\n\t\t\t\t\t<altitudeMode>absolute</altitudeMode>\n";
 
   // time data points
-  for (int i=1; i<n; i++) {
-    QString tstamp=dataPoints.at(i).at(0)+QString("T")+dataPoints.at(i).at(1)+QString("Z");
+  for (int i=0; i<n; i++) {
+    QString tstamp=csvlog.text(dataPoints.at(i), 0)+QString("T")+csvlog.text(dataPoints.at(i), 1)+QString("Z");
     outputStream << "\t\t\t\t\t<when>"<< tstamp <<"</when>\n";
   }
 
   // coordinate data points
   outputStream.setRealNumberNotation(QTextStream::FixedNotation);
   outputStream.setRealNumberPrecision(8);
-  for (int i=1; i<n; i++) {
-    GpsCoord coord = extractGpsCoordinates(dataPoints.at(i).at(gpscol));
-    int altitude = altcol ? (dataPoints.at(i).at(altcol).toFloat() * altMultiplier) : 0;
+  for (int i=0; i<n; i++) {
+    GpsCoord coord = extractGpsCoordinates(csvlog.text(dataPoints.at(i), gpscol));
+    int altitude = altcol ? (csvlog.value(dataPoints.at(i), altcol) * altMultiplier) : 0;
     outputStream << "\t\t\t\t\t<gx:coord>" << coord.longitude << " " << coord.latitude << " " << altitude << " </gx:coord>\n" ;
   }
 
@@ -398,20 +450,20 @@ void LogsDialog::exportToGoogleEarth()
   if (speedcol) {
     // gps speed data points
     outputStream << "\t\t\t\t\t\t\t<gx:SimpleArrayData name=\"GPSSpeed\">\n";
-    for (int i=1; i<n; i++) {
-      outputStream << "\t\t\t\t\t\t\t\t<gx:value>"<< dataPoints.at(i).at(speedcol) <<"</gx:value>\n";
+    for (int i=0; i<n; i++) {
+      outputStream << "\t\t\t\t\t\t\t\t<gx:value>"<< csvlog.text(dataPoints.at(i), speedcol) <<"</gx:value>\n";
     }
     outputStream << "\t\t\t\t\t\t\t</gx:SimpleArrayData>\n";
   }
 
   // add values for additional fields
-  for (int i=0; i<dataPoints.at(0).count()-2; i++) {
+  for (int i=0; i<header.count()-2; i++) {
     if (ui->FieldsTW->item(i, 0) && ui->FieldsTW->item(i, 0)->isSelected() && !nondataCols.contains(i+2)) {
-      QString safeName = dataPoints.at(0).at(i+2);;
+      QString safeName = header.at(i+2);
       safeName.replace(" ","_");
       outputStream << "\t\t\t\t\t\t\t<gx:SimpleArrayData name=\""<< safeName <<"\">\n";
-      for (int j=1; j<n; j++) {
-        outputStream << "\t\t\t\t\t\t\t\t<gx:value>"<< dataPoints.at(j).at(i+2) <<"</gx:value>\n";
+      for (int j=0; j<n; j++) {
+        outputStream << "\t\t\t\t\t\t\t\t<gx:value>"<< csvlog.text(dataPoints.at(j), i+2) <<"</gx:value>\n";
       }
       outputStream << "\t\t\t\t\t\t\t</gx:SimpleArrayData>\n";
     }
@@ -557,6 +609,7 @@ void LogsDialog::removeAllGraphs()
   axisRect->axis(QCPAxis::atRight, 1)->setVisible(false);
   axisRect->axis(QCPAxis::atRight, 1)->setSelectedParts(QCPAxis::spNone);
   axisRect->axis(QCPAxis::atBottom)->setSelectedParts(QCPAxis::spNone);
+  plottedCoords.clear();
   ui->customPlot->replot();
   tracerMaxAlt = 0;
   cursorA = 0;
@@ -573,36 +626,25 @@ void LogsDialog::on_fileOpen_BT_clicked()
     ui->FileName_LE->setText(fileName);
     if (cvsFileParse()) {
       ui->FieldsTW->clear();
-      ui->logTable->clear();
       ui->FieldsTW->setShowGrid(false);
       ui->FieldsTW->setContentsMargins(0,0,0,0);
-      ui->FieldsTW->setRowCount(csvlog.at(0).count()-2);
+      ui->FieldsTW->setRowCount(csvlog.columnCount()-2);
       ui->FieldsTW->setColumnCount(1);
       ui->FieldsTW->setHorizontalHeaderLabels(QStringList(tr("Available fields")));
       ui->logTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-      for (int i=2; i<csvlog.at(0).count(); i++) {
-        QTableWidgetItem* item= new QTableWidgetItem(csvlog.at(0).at(i));
+      for (int i=2; i<csvlog.columnCount(); i++) {
+        QTableWidgetItem* item= new QTableWidgetItem(csvlog.header().at(i));
         ui->FieldsTW->setItem(i-2, 0, item);
       }
       ui->FieldsTW->resizeRowsToContents();
-      ui->logTable->setColumnCount(csvlog.at(0).count());
-      ui->logTable->setRowCount(csvlog.count()-1);
-      ui->logTable->setHorizontalHeaderLabels(csvlog.at(0));
-
-      QAbstractItemModel *model = ui->logTable->model();
-      for (int i=1; i<csvlog.count(); i++) {
-        for (int j=0; j<csvlog.at(0).count(); j++) {
-          model->setData(model->index(i - 1, j, QModelIndex()), csvlog.at(i).at(j));
-        }
-      }
 
       ui->logTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
       QVarLengthArray<int> sizes;
-      for (int i = 0; i < ui->logTable->columnCount(); i++) {
+      for (int i = 0; i < csvlog.columnCount(); i++) {
         sizes.append(ui->logTable->columnWidth(i));
       }
       ui->logTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
-      for (int i = 0; i < ui->logTable->columnCount(); i++) {
+      for (int i = 0; i < csvlog.columnCount(); i++) {
         ui->logTable->setColumnWidth(i, sizes.at(i));
       }
     }
@@ -614,92 +656,40 @@ void LogsDialog::saveSession()
   int index = ui->sessions_CB->currentIndex();
   // ignore index 0 is its all sessions combined
   if(index > 0) {
-    int n = csvlog.count();
-    QList<QStringList> sessionCsvLog;
-    // add CSV headers from first row of source file
-    sessionCsvLog.push_back(csvlog[0]);
-    // find session breaks
-    int currentSession = 0;
-    QDateTime lastvalue;
-    for (int i = 1; i < n; i++) {
-      QDateTime tmp = getRecordTimeStamp(i);
-      if (!lastvalue.isValid() || lastvalue.secsTo(tmp) > 60) {
-        currentSession++;
-      }
-      lastvalue = tmp;
-      if(currentSession == index) {
-        // add records to filtered list
-        sessionCsvLog.push_back(csvlog[i]);
-      }
-      else if (currentSession > index) {
-        break;
-      }
-    }
-    // save the filtered records to a new file
+    const QVector<int> & sessions = csvlog.sessions();
+    int first = sessions.at(index - 1);
+    int last = (index < sessions.size() ? sessions.at(index) : csvlog.rowCount()) - 1;
+    // save the session records to a new file
     QString newFilename = logFilename;
     newFilename.append(QString("-Session%1.csv").arg(index));
     QString filename = QFileDialog::getSaveFileName(this, "Save log", newFilename, "CSV files (.csv);", 0, 0); // getting the filename (full path)
     QFile data(filename);
     if(data.open(QFile::WriteOnly |QFile::Truncate)) {
-      QTextStream output(&data);
-      int numRecords = sessionCsvLog.count();
-      for(int i = 0; i < numRecords; i++){
-        output << sessionCsvLog[i].join(",") << '\n';
+      // add CSV headers from first row of source file
+      data.write(csvlog.header().join(",").toUtf8() + '\n');
+      for(int i = first; i <= last; i++){
+        data.write(csvlog.line(i) + '\n');
       }
     }
-    sessionCsvLog.clear();
   }
 }
 
 bool LogsDialog::cvsFileParse()
 {
-  QFile file(ui->FileName_LE->text());
-  int errors=0;
-  int lines=-1;
+  logFilename.clear();
 
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) { // reading HEX TEXT file
+  if (!logModel->load(ui->FileName_LE->text())) {
     return false;
   }
-  else {
-    csvlog.clear();
-    logFilename.clear();
-    QTextStream inputStream(&file);
-    QString buffer = file.readLine();
-
-    if (buffer.startsWith("Date,Time")) {
-      file.reset();
-    }
-    else {
-      return false;
-    }
-
-    int numfields=-1;
-    while (!file.atEnd()) {
-      QString line = file.readLine().trimmed();
-      QStringList columns = line.split(',');
-      if (numfields==-1) {
-        numfields=columns.count();
-      }
-      if (columns.count()==numfields) {
-        csvlog.append(columns);
-      }
-      else {
-        errors++;
-      }
-      lines++;
-    }
 
-    logFilename = QFileInfo(file.fileName()).baseName();
-  }
+  logFilename = QFileInfo(ui->FileName_LE->text()).baseName();
 
-  file.close();
-  if (errors > 1) {
-    QMessageBox::warning(this, CPN_STR_APP_NAME, tr("The selected logfile contains %1 invalid lines out of  %2 total lines").arg(errors).arg(lines));
+  if (csvlog.errors() > 1) {
+    QMessageBox::warning(this, CPN_STR_APP_NAME, tr("The selected logfile contains %1 invalid lines out of  %2 total lines").arg(csvlog.errors()).arg(csvlog.lines()));
   }
 
-  int n = csvlog.count();
-  if (n == 1) {
-    csvlog.clear();
+  if (csvlog.rowCount() == 0) {
+    logModel->clear();
     return false;
   }
 
@@ -715,14 +705,6 @@ struct FlightSession {
   QDateTime end;
 };
 
-QDateTime LogsDialog::getRecordTimeStamp(int index)
-{
-  QString tstamp = csvlog.at(index).at(0) + " " + csvlog.at(index).at(1);
-  if (csvlog.at(index).at(1).contains("."))
-    return QDateTime::fromString(tstamp, "yyyy-MM-dd HH:mm:ss.zzz");
-  return QDateTime::fromString(tstamp, "yyyy-MM-dd HH:mm:ss");
-}
-
 QString LogsDialog::generateDuration(const QDateTime & start, const QDateTime & end)
 {
   int secs = start.secsTo(end);
@@ -740,38 +722,26 @@ void LogsDialog::setFlightSessions()
   ui->sessions_CB->clear();
   ui->SaveSession_PB->setEnabled(false);
 
-  int n = csvlog.count();
-  // qDebug() << "records" << n;
-
-  // find session breaks
-  QList<int> sessions;
-  QDateTime lastvalue;
-  for (int i = 1; i < n; i++) {
-    QDateTime tmp = getRecordTimeStamp(i);
-    if (!lastvalue.isValid() || lastvalue.secsTo(tmp) > 60) {
-      sessions.push_back(i-1);
-      // qDebug() << "session index" << i-1;
-    }
-    lastvalue = tmp;
-  }
-  sessions.push_back(n-1);
+  // the sessions breaks are found while parsing
+  const QVector<int> & sessions = csvlog.sessions();
+  int n = csvlog.rowCount();
 
   //now construct a list of sessions with their times
   //total time
-  int noSesions = sessions.size()-1;
+  int noSesions = sessions.size();
   QString label = QString("%1 ").arg(noSesions);
   label += tr(noSesions > 1 ? "sessions" : "session");
-  label += " <" + tr("total duration ") + generateDuration(getRecordTimeStamp(1), getRecordTimeStamp(n-1)) + ">";
+  label += " <" + tr("total duration ") + generateDuration(csvlog.dateTime(0), csvlog.dateTime(n-1)) + ">";
   ui->sessions_CB->addItem(label);
 
   // add individual sessions
-  if (sessions.size() > 2) {
-    for (int i = 1; i < sessions.size(); i++) {
-      QDateTime sessionStart = getRecordTimeStamp(sessions.at(i-1)+1);
-      QDateTime sessionEnd = getRecordTimeStamp(sessions.at(i));
+  if (sessions.size() > 1) {
+    for (int i = 0; i < sessions.size(); i++) {
+      QDateTime sessionStart = csvlog.dateTime(sessions.at(i));
+      QDateTime sessionEnd = csvlog.dateTime((i+1 < sessions.size() ? sessions.at(i+1) : n) - 1);
       QString label = sessionStart.toString("HH:mm:ss") + " <" + tr("duration ") + generateDuration(sessionStart, sessionEnd) + ">";
-      ui->sessions_CB->addItem(label, sessions.at(i-1));
-      // qDebug() << "added label" << label << sessions.at(i-1);
+      ui->sessions_CB->addItem(label, sessions.at(i));
+      // qDebug() << "added label" << label << sessions.at(i);
     }
   }
 }
@@ -788,13 +758,13 @@ void LogsDialog::on_sessions_CB_currentIndexChanged(int index)
     if (index < ui->sessions_CB->count() - 1) {
       bottom = ui->sessions_CB->itemData(index + 1, Qt::UserRole).toInt();
     } else {
-      bottom = ui->logTable->rowCount();
+      bottom = csvlog.rowCount();
     }
 
     QModelIndex topLeft = ui->logTable->model()->index(
       ui->sessions_CB->itemData(index, Qt::UserRole).toInt(), 0 , QModelIndex());
     QModelIndex bottomRight = ui->logTable->model()->index(
-      bottom - 1, ui->logTable->columnCount() - 1, QModelIndex());
+      bottom - 1, csvlog.columnCount() - 1, QModelIndex());
 
     QItemSelection selection(topLeft, bottomRight);
     ui->logTable->selectionModel()->select(selection, QItemSelectionModel::Select);
@@ -820,68 +790,54 @@ void LogsDialog::plotLogs()
 
   plotsCollection plots;
 
-  QModelIndexList selection = ui->logTable->selectionModel()->selectedRows();
-  int rowCount = selection.length();
-  bool hasLogSelection;
-  QVarLengthArray<int> selectedRows;
-
-  if (rowCount) {
-    hasLogSelection = true;
-    foreach (QModelIndex index, selection) {
-      selectedRows.append(index.row());
+  // the selected rows as sorted ranges, or all the rows
+  plottedRows.clear();
+  QItemSelection selection = ui->logTable->selectionModel()->selection();
+  if (selection.isEmpty()) {
+    plottedRows.append(qMakePair(0, csvlog.rowCount() - 1));
+  }
+  else {
+    QVarLengthArray<QPair<int, int> > ranges;
+    foreach (QItemSelectionRange range, selection) {
+      ranges.append(qMakePair(range.top(), range.bottom()));
+    }
+    qSort(ranges.begin(), ranges.end());
+    for (int i = 0; i < ranges.size(); i++) {
+      if (!plottedRows.isEmpty() && ranges.at(i).first <= plottedRows.last().second + 1)
+        plottedRows.last().second = std::max(plottedRows.last().second, ranges.at(i).second);
+      else
+        plottedRows.append(ranges.at(i));
     }
-    qSort(selectedRows.begin(), selectedRows.end());
-  } else {
-    hasLogSelection = false;
-    rowCount = ui->logTable->rowCount();
   }
 
   plots.min_x = QDateTime::currentDateTime().toTime_t();
   plots.max_x = 0;
 
+  for (int i = 0; i < plottedRows.size(); i++) {
+    for (int row = plottedRows.at(i).first; row <= plottedRows.at(i).second; row++) {
+      double time = csvlog.timestamp(row) / 1000.0;
+      if (plots.min_x > time) plots.min_x = time;
+      if (plots.max_x < time) plots.max_x = time;
+    }
+  }
+
   foreach (QTableWidgetItem *plot, ui->FieldsTW->selectedItems()) {
     coords_t plotCoords;
-    int plotColumn = plot->row() + 2; // Date and Time first
 
+    plotCoords.column = plot->row() + 2; // Date and Time first
+    plotCoords.offset = 0;
+    plotCoords.factor = 1;
     plotCoords.min_y = INVALID_MIN;
     plotCoords.max_y = INVALID_MAX;
     plotCoords.yaxis = firstLeft;
     plotCoords.name = plot->text();
 
-    for (int row = 0; row < rowCount; row++) {
-      QTableWidgetItem *logValue;
-      double y;
-      double time;
-      QString time_str;
-
-      if (hasLogSelection) {
-        logValue = ui->logTable->item(selectedRows.at(row), plotColumn);
-        time_str = ui->logTable->item(selectedRows.at(row), 0)->text() +
-          QString(" ") + ui->logTable->item(selectedRows.at(row), 1)->text();
-      } else {
-        logValue = ui->logTable->item(row, plotColumn);
-        time_str = ui->logTable->item(row, 0)->text() + QString(" ") +
-          ui->logTable->item(row, 1)->text();
-      }
-
-      y = logValue->text().toDouble();
-      plotCoords.y.push_back(y);
-
-      if (plotCoords.min_y > y) plotCoords.min_y = y;
-      if (plotCoords.max_y < y) plotCoords.max_y = y;
-
-      if (time_str.contains('.')) {
-        time = QDateTime::fromString(time_str, "yyyy-MM-dd HH:mm:ss.zzz")
-          .toTime_t();
-        time += time_str.mid(time_str.indexOf('.')).toDouble();
-      } else {
-        time = QDateTime::fromString(time_str, "yyyy-MM-dd HH:mm:ss")
-          .toTime_t();
+    for (int i = 0; i < plottedRows.size(); i++) {
+      for (int row = plottedRows.at(i).first; row <= plottedRows.at(i).second; row++) {
+        double y = csvlog.value(row, plotCoords.column);
+        if (plotCoords.min_y > y) plotCoords.min_y = y;
+        if (plotCoords.max_y < y) plotCoords.max_y = y;
       }
-      plotCoords.x.push_back(time);
-
-      if (plots.min_x > time) plots.min_x = time;
-      if (plots.max_x < time) plots.max_x = time;
     }
 
     double range_inc = (plotCoords.max_y - plotCoords.min_y) / 100;
@@ -956,11 +912,8 @@ void LogsDialog::plotLogs()
 
     for (int i = 0; i < plots.coords.size(); i++) {
       plots.coords[i].yaxis = firstLeft;
-
-      double factor = 100 / (plots.coords.at(i).max_y - plots.coords.at(i).min_y);
-      for (int j = 0; j < plots.coords.at(i).y.count(); j++) {
-        plots.coords[i].y[j] = factor * (plots.coords.at(i).y.at(j) - plots.coords.at(i).min_y);
-      }
+      plots.coords[i].offset = plots.coords.at(i).min_y;
+      plots.coords[i].factor = 100 / (plots.coords.at(i).max_y - plots.coords.at(i).min_y);
     }
   } else {
     for (int i = firstRight; i < AXES_LIMIT; i++) {
@@ -973,6 +926,7 @@ void LogsDialog::plotLogs()
 
   removeAllGraphs();
 
+  // no graph yet, the range change doesn't take their points
   axisRect->axis(QCPAxis::atBottom)->setRange(plots.min_x, plots.max_x);
 
   axisRect->axis(QCPAxis::atLeft)->setRange(yAxesRanges[firstLeft].min,
@@ -1004,6 +958,8 @@ void LogsDialog::plotLogs()
     }
   }
 
+  plottedCoords = plots.coords;
+
   for (int i = 0; i < plots.coords.size(); i++) {
     switch (plots.coords[i].yaxis) {
       case firstLeft:
@@ -1045,8 +1001,7 @@ void LogsDialog::plotLogs()
         break;
     }
 
-    ui->customPlot->graph(i)->setData(plots.coords.at(i).x,
-      plots.coords.at(i).y);
+    setGraphData(i);
     pen.setColor(colors.at(i % colors.size()));
     ui->customPlot->graph(i)->setPen(pen);
 
@@ -1108,18 +1063,67 @@ void LogsDialog::yAxisChangeRanges(QCPRange range)
   }
 }
 
+void LogsDialog::xAxisChangeRange(QCPRange range)
+{
+  Q_UNUSED(range);
+  for (int i = 0; i < plottedCoords.size(); i++) {
+    setGraphData(i);
+  }
+}
+
+// Only the points needed for the plot width are given to the graph: the min and the max of
+// each pixel column over the visible time range (with the point before and the one after)
+void LogsDialog::setGraphData(int index)
+{
+  const coords_t & c = plottedCoords.at(index);
+  QCPRange range = axisRect->axis(QCPAxis::atBottom)->range();
+  int first, last;
+
+  csvlog.findRows((qint64)floor(range.lower * 1000), (qint64)ceil(range.upper * 1000), first, last);
+
+  QVarLengthArray<QPair<int, int> > visibleRows;
+  int count = 0;
+  for (int i = 0; i < plottedRows.size(); i++) {
+    int from = std::max(first, plottedRows.at(i).first);
+    int to = std::min(last, plottedRows.at(i).second);
+    if (from <= to) {
+      visibleRows.append(qMakePair(from, to));
+      count += to - from + 1;
+    }
+  }
+
+  int width = std::max(axisRect->width(), 1);
+  QVector<double> x, y;
+  x.reserve(std::min(count, 2 * width + 4 * visibleRows.size()));
+  y.reserve(x.capacity());
+
+  for (int i = 0; i < visibleRows.size(); i++) {
+    int rows = visibleRows.at(i).second - visibleRows.at(i).first + 1;
+    int buckets = std::max(1, (int)((qint64)width * rows / count));
+    csvlog.decimate(c.column, visibleRows.at(i).first, visibleRows.at(i).second, buckets, x, y);
+  }
+
+  if (c.factor != 1 || c.offset != 0) {
+    for (int i = 0; i < y.size(); i++) {
+      y[i] = c.factor * (y.at(i) - c.offset);
+    }
+  }
+
+  ui->customPlot->graph(index)->setData(x, y);
+}
 
 void LogsDialog::addMaxAltitudeMarker(const coords_t & c, QCPGraph * graph) {
   // find max altitude
-  int positionIndex = 0;
+  int positionIndex = plottedRows.at(0).first;
   double maxAlt = -100000;
 
-  for(int i=0; i<c.x.count(); ++i) {
-    double alt = c.y.at(i);
-    if (alt > maxAlt) {
-      maxAlt = alt;
-      positionIndex = i;
-      // qDebug() << "max alt: " << maxAlt << "@" << result;
+  for (int i = 0; i < plottedRows.size(); i++) {
+    for (int row = plottedRows.at(i).first; row <= plottedRows.at(i).second; row++) {
+      double alt = csvlog.value(row, c.column);
+      if (alt > maxAlt) {
+        maxAlt = alt;
+        positionIndex = row;
+      }
     }
   }
   // qDebug() << "max alt: " << maxAlt << "@" << positionIndex;
@@ -1133,7 +1137,7 @@ void LogsDialog::addMaxAltitudeMarker(const coords_t & c, QCPGraph * graph) {
   tracerMaxAlt->setPen(QPen(Qt::blue));
   tracerMaxAlt->setBrush(Qt::NoBrush);
   tracerMaxAlt->setSize(7);
-  tracerMaxAlt->setGraphKey(c.x.at(positionIndex));
+  tracerMaxAlt->setGraphKey(csvlog.timestamp(positionIndex) / 1000.0);
   tracerMaxAlt->updatePosition();
 }
 
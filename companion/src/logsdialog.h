@@ -24,6 +24,7 @@
 #include <QtCore>
 #include <QDialog>
 #include "qcustomplot.h"
+#include "csvlog.h"
 
 #define INVALID_MIN 999999
 #define INVALID_MAX -999999
@@ -32,6 +33,8 @@ namespace Ui {
   class LogsDialog;
 }
 
+class LogsTableModel;
+
 class LogsDialog : public QDialog
 {
   Q_OBJECT
@@ -44,8 +47,11 @@ class LogsDialog : public QDialog
     AXES_LIMIT // = 4
   };
 
+  // the points are taken from the log column when the visible range changes
   struct coords_t {
-    QVector<double> x, y;
+    int column;
+    double offset;
+    double factor;
     double min_y;
     double max_y;
     yaxes_t yaxis;
@@ -82,9 +88,11 @@ private slots:
   void on_sessions_CB_currentIndexChanged(int index);
   void on_mapsButton_clicked();
   void yAxisChangeRanges(QCPRange range);
+  void xAxisChangeRange(QCPRange range);
 
 private:
-  QList<QStringList> csvlog;
+  CsvLog csvlog;
+  LogsTableModel *logModel;
   Ui::LogsDialog *ui;
   QCPAxisRect *axisRect;
   QCPLegend *rightLegend;
@@ -102,12 +110,16 @@ private:
   QCPItemTracer * cursorB;
   QCPItemStraightLine * cursorLine;
 
+  // plotted rows ranges and graphs
+  QVarLengthArray<QPair<int, int> > plottedRows;
+  QVarLengthArray<coords_t> plottedCoords;
+
   bool cvsFileParse();
-  QList<QStringList> filterGePoints(const QList<QStringList> & input);
+  QVector<int> filterGePoints();
   void exportToGoogleEarth();
-  QDateTime getRecordTimeStamp(int index);
   QString generateDuration(const QDateTime & start, const QDateTime & end);
   void setFlightSessions();
+  void setGraphData(int index);
 
   void addMaxAltitudeMarker(const coords_t & c, QCPGraph * graph);
   void countNumberOfThrows(const coords_t & c, QCPGraph * graph);
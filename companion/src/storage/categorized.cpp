@@ -21,6 +21,39 @@
 #include "categorized.h"
 #include "firmwares/opentx/opentxinterface.h"
 
+#include <QSemaphore>
+#include <QThreadPool>
+
+// A model extracted from the archive, the models are decoded in parallel once all are extracted
+struct CategorizedModel {
+  QString fileName;
+  QByteArray buffer;
+  int index;
+  int category;
+  bool loaded;
+};
+
+class CategorizedModelDecoder: public QRunnable {
+  public:
+    CategorizedModelDecoder(CategorizedModel & model, ModelData & modelData, QSemaphore & done):
+      model(model),
+      modelData(modelData),
+      done(done)
+    {
+    }
+
+    virtual void run()
+    {
+      model.loaded = (loadModelFromByteArray(modelData, model.buffer) != NULL);
+      done.release();
+    }
+
+  protected:
+    CategorizedModel & model;
+    ModelData & modelData;
+    QSemaphore & done;
+};
+
 bool CategorizedStorageFormat::load(RadioData & radioData)
 {
   QByteArray radioSettingsBuffer;
@@ -43,6 +76,7 @@ bool CategorizedStorageFormat::load(RadioData & radioData)
   }
 
   QList<QByteArray> lines = modelsListBuffer.split('\n');
+  QList<CategorizedModel> models;
   int modelIndex = 0;
   int categoryIndex = -1;
   foreach (const QByteArray & lineArray, lines) {
@@ -77,30 +111,18 @@ bool CategorizedStorageFormat::load(RadioData & radioData)
       parts.removeFirst();
     }
     if (parts.size() == 1) {
-      // parse model file name and load
-      QString fileName = parts[0];
-      qDebug() << "Loading model from file" << fileName << "into slot" << modelIndex;
-      QByteArray modelBuffer;
-      if (!loadFile(modelBuffer, QString("MODELS/%1").arg(fileName))) {
-        setError(tr("Can't extract %1").arg(fileName));
+      // parse model file name and extract it
+      CategorizedModel model;
+      model.fileName = parts[0];
+      model.index = modelIndex;
+      model.category = categoryIndex;
+      model.loaded = false;
+      qDebug() << "Extracting model from file" << model.fileName << "for slot" << modelIndex;
+      if (!loadFile(model.buffer, QString("MODELS/%1").arg(model.fileName))) {
+        setError(tr("Can't extract %1").arg(model.fileName));
         return false;
       }
-      if ((int)radioData.models.size() <= modelIndex) {
-        radioData.models.resize(modelIndex + 1);
-      }
-      if (!loadModelFromByteArray(radioData.models[modelIndex], modelBuffer)) {
-        setError(tr("Error loading models"));
-        return false;
-      }
-      strncpy(radioData.models[modelIndex].filename, qPrintable(fileName), sizeof(radioData.models[modelIndex].filename));
-      if (IS_HORUS(board) && !strcmp(radioData.generalSettings.currModelFilename, qPrintable(fileName))) {
-        radioData.generalSettings.currModelIndex = modelIndex;
-        qDebug() << "currModelIndex =" << modelIndex;
-      }
-      if (getCurrentFirmware()->getCapability(HasModelCategories)) {
-        radioData.models[modelIndex].category = categoryIndex;
-      }
-      radioData.models[modelIndex].used = true;
+      models.append(model);
       modelIndex++;
       continue;
     }
@@ -110,6 +132,35 @@ bool CategorizedStorageFormat::load(RadioData & radioData)
     qDebug() << "Invalid line" <<line;
     continue;
   }
+
+  if ((int)radioData.models.size() < modelIndex) {
+    radioData.models.resize(modelIndex);
+  }
+
+  // each model goes to its own slot, the decoders don't share anything else
+  QSemaphore done;
+  for (int i=0; i<models.size(); i++) {
+    QThreadPool::globalInstance()->start(new CategorizedModelDecoder(models[i], radioData.models[models[i].index], done));
+  }
+  done.acquire(models.size());
+
+  foreach (const CategorizedModel & model, models) {
+    ModelData & modelData = radioData.models[model.index];
+    if (!model.loaded) {
+      setError(tr("Error loading models"));
+      return false;
+    }
+    strncpy(modelData.filename, qPrintable(model.fileName), sizeof(modelData.filename));
+    if (IS_HORUS(board) && !strcmp(radioData.generalSettings.currModelFilename, qPrintable(model.fileName))) {
+      radioData.generalSettings.currModelIndex = model.index;
+      qDebug() << "currModelIndex =" << model.index;
+    }
+    if (getCurrentFirmware()->getCapability(HasModelCategories)) {
+      modelData.category = model.category;
+    }
+    modelData.used = true;
+  }
+
   return true;
 }
 
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Measures the time needed to load and to save a complete models file:
+ *   storage-benchmark [-n iterations] [-f firmware-id] [-j threads] models.otx
+ * The models of .otx files are decoded on the global thread pool, -j 1 gives the serial time.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QThreadPool>
+
+#include "eeprominterface.h"
+#include "storage.h"
+
+static void messageHandler(QtMsgType type, const QMessageLogContext & context, const QString & msg)
+{
+  Q_UNUSED(context);
+  // the storage classes are verbose, only the warnings are kept
+  if (type != QtDebugMsg && type != QtInfoMsg) {
+    fprintf(stderr, "%s\n", qPrintable(msg));
+  }
+}
+
+struct BenchmarkResult {
+  qint64 min = std::numeric_limits<qint64>::max();
+  qint64 total = 0;
+
+  void add(qint64 elapsed)
+  {
+    min = std::min(min, elapsed);
+    total += elapsed;
+  }
+};
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+  app.setApplicationName("storage-benchmark");
+
+  QCommandLineParser parser;
+  parser.addHelpOption();
+  const QCommandLineOption optIterations(QStringList() << "iterations" << "n", "Number of loads and saves (default 10).", "count", "10");
+  const QCommandLineOption optFirmware(QStringList() << "firmware" << "f", "Firmware id used as current variant (default variant otherwise).", "id");
+  const QCommandLineOption optThreads(QStringList() << "threads" << "j", "Number of threads used to decode the models (default one per core).", "count");
+  parser.addOption(optIterations);
+  parser.addOption(optFirmware);
+  parser.addOption(optThreads);
+  parser.addPositionalArgument("file", "Models file (.otx/.bin/.eepe) to load and save.");
+  parser.process(app);
+
+  if (parser.positionalArguments().size() != 1) {
+    parser.showHelp(1);
+  }
+
+  qInstallMessageHandler(messageHandler);
+
+  registerStorageFactories();
+  registerOpenTxFirmwares();
+
+  if (parser.isSet(optFirmware))
+    Firmware::setCurrentVariant(Firmware::getFirmwareForId(parser.value(optFirmware)));
+  else
+    Firmware::setCurrentVariant(Firmware::getDefaultVariant());
+
+  if (parser.isSet(optThreads))
+    QThreadPool::globalInstance()->setMaxThreadCount(std::max(1, parser.value(optThreads).toInt()));
+
+  QString input = parser.positionalArguments().at(0);
+  QString output = QDir::temp().filePath("storage-benchmark." + QFileInfo(input).suffix());
+  int iterations = std::max(1, parser.value(optIterations).toInt());
+  int models = 0;
+  int result = 0;
+  BenchmarkResult load, save;
+
+  for (int i = 0; i < iterations && result == 0; i++) {
+    QSharedPointer<RadioData> radioData = QSharedPointer<RadioData>(new RadioData());
+    QElapsedTimer timer;
+
+    timer.start();
+    Storage source(input);
+    if (!source.load(*radioData)) {
+      fprintf(stderr, "Cannot load %s: %s\n", qPrintable(input), qPrintable(source.error()));
+      result = 1;
+      break;
+    }
+    load.add(timer.nsecsElapsed());
+
+    timer.restart();
+    Storage destination(output);
+    if (!destination.write(*radioData)) {
+      fprintf(stderr, "Cannot save %s: %s\n", qPrintable(output), qPrintable(destination.error()));
+      result = 1;
+      break;
+    }
+    save.add(timer.nsecsElapsed());
+
+    models = 0;
+    for (unsigned j = 0; j < radioData->models.size(); j++) {
+      if (!radioData->models[j].isEmpty())
+        models++;
+    }
+  }
+
+  if (result == 0) {
+    printf("%s: %d models, %d iterations, %d threads\n", qPrintable(input), models, iterations, QThreadPool::globalInstance()->maxThreadCount());
+    printf("load: min %.2fms, avg %.2fms\n", load.min / 1e6, load.total / 1e6 / iterations);
+    printf("save: min %.2fms, avg %.2fms\n", save.min / 1e6, save.total / 1e6 / iterations);
+  }
+
+  QFile::remove(output);
+  unregisterOpenTxFirmwares();
+  unregisterStorageFactories();
+
+  return result;
+}
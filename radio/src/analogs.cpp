@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "opentx.h"
+
+static_assert(NUM_ANALOGS <= 32, "analogs.otherFilters is too small");
+
+AnalogsData analogs;
+
+// 1-euro filter: the input weight (/256) grows with the speed from ONE_EURO_MIN_ALPHA
+#define ONE_EURO_MIN_ALPHA     16
+#define ONE_EURO_SPEED_SHIFT   2    // speed low pass filter
+#define ONE_EURO_BETA_SHIFT    2    // weight increase with the speed
+
+// Jitter filter:
+//    * pass trough any big change directly
+//    * for small change use Modified moving average (MMA) filter
+//
+// Explanation:
+//
+// Normal MMA filter has this formula:
+//            <out> = ((ALPHA-1)*<out> + <in>)/ALPHA
+//
+// If calculation is done this way with integer arithmetics, then any small change in
+// input signal is lost. One way to combat that, is to rearrange the formula somewhat,
+// to store a more precise (larger) number between iterations. The basic idea is to
+// store undivided value between iterations. Therefore an new variable <filtered> is
+// used. The new formula becomes:
+//           <filtered> = <filtered> - <filtered>/ALPHA + <in>
+//           <out> = <filtered>/ALPHA  (use only when out is needed)
+//
+// The above formula with a maximum allowed ALPHA value (we are limited by
+// the 16 bit s_anaFilt[]) was tested on the radio. The resulting signal still had
+// some jitter (a value of 1 was observed). The jitter might be bigger on other
+// radios.
+//
+// So another idea is to use larger input values for filtering. So instead of using
+// input in a range from 0 to 2047, we use twice larger number (temp[x] is divided less)
+//
+// This also means that ALPHA must be lowered (remember 16 bit limit), but test results
+// have proved that this kind of filtering gives better results. So the recommended values
+// for filter are:
+//     JITTER_FILTER_STRENGTH  4
+//     ANALOG_SCALE            1
+//
+// Variables mapping:
+//   * <in> = value
+//   * <out> = filtered / JITTER_ALPHA
+//
+// Without VIRTUAL_INPUTS JITTER_ALPHA is 1 and the filter gives the input value.
+static inline uint16_t mmaFilter(uint16_t filtered, uint16_t value, uint16_t threshold)
+{
+  uint16_t previous = filtered >> JITTER_FILTER_STRENGTH;
+  uint16_t diff = (value > previous) ? (value - previous) : (previous - value);
+  return diff < threshold ? (filtered - previous) + value : value * JITTER_ALPHA;
+}
+
+#if defined(__ARM_FEATURE_DSP) && !defined(SIMU)
+// Same as mmaFilter() on 2 analogs at once, one per 16 bits half. The values are 12 bits
+// ADC values, so the differences fit in the signed halves. SEL selects each half with the
+// GE flags set by the SSUB16 just before it, in the same asm block so that nothing runs between them.
+static inline uint32_t mmaFilter2(uint32_t filtered, uint32_t value, uint32_t threshold)
+{
+  const uint32_t mask = (0xFFFFu >> JITTER_FILTER_STRENGTH) * 0x00010001u;
+  uint32_t previous = (filtered >> JITTER_FILTER_STRENGTH) & mask;
+  uint32_t average = __UADD16(__USUB16(filtered, previous), value);
+  uint32_t reset = (value & mask) << JITTER_FILTER_STRENGTH;
+  uint32_t diff, below, result;
+  __asm volatile ("ssub16 %1, %2, %3\n\t"    // below = previous - value
+                  "ssub16 %0, %3, %2\n\t"    // diff = value - previous, GE where value >= previous
+                  "sel %0, %0, %1"
+                  : "=&r" (diff), "=&r" (below) : "r" (previous), "r" (value) : "cc");
+  __asm volatile ("ssub16 %0, %1, %2\n\t"    // GE where diff >= threshold
+                  "sel %0, %3, %4"
+                  : "=&r" (result) : "r" (diff), "r" (threshold), "r" (reset), "r" (average) : "cc");
+  return result;
+}
+#endif
+
+static inline uint16_t median3(uint16_t a, uint16_t b, uint16_t c)
+{
+  return max(min(a, b), min(max(a, b), c));
+}
+
+void setAnalogFilter(uint8_t index, uint8_t filter)
+{
+  uint16_t value = analogs.raw[index];
+
+  analogs.filter[index] = filter;
+  analogs.smoothed[index] = value * JITTER_ALPHA;
+  analogs.speed[index] = 0;
+  analogs.history[0][index] = value;
+  analogs.history[1][index] = value;
+
+  if (filter == ANALOG_FILTER_MMA)
+    analogs.otherFilters &= ~(1u << index);
+  else
+    analogs.otherFilters |= (1u << index);
+}
+
+void processAnalogs(uint16_t * filtered)
+{
+  // MMA filter on all analogs, the other filters overwrite its result
+  uint16_t threshold = (g_eeGeneral.jitterFilter ? 0 : 10*ANALOG_MULTIPLIER); // g_eeGeneral.jitterFilter is inverted, 0 - active
+  uint8_t x = 0;
+#if defined(__ARM_FEATURE_DSP) && !defined(SIMU)
+  uint32_t threshold2 = threshold * 0x00010001u;
+  for (; x+1<NUM_ANALOGS; x+=2) {
+    uint32_t result = mmaFilter2(filtered[x] | (filtered[x+1] << 16), analogs.raw[x] | (analogs.raw[x+1] << 16), threshold2);
+    filtered[x] = result;
+    filtered[x+1] = result >> 16;
+  }
+#endif
+  for (; x<NUM_ANALOGS; x++) {
+    filtered[x] = mmaFilter(filtered[x], analogs.raw[x], threshold);
+  }
+
+  for (uint32_t mask=analogs.otherFilters; mask; mask&=mask-1) {
+    x = __builtin_ctz(mask);
+    uint16_t value = analogs.raw[x];
+    if (analogs.filter[x] == ANALOG_FILTER_MEDIAN3) {
+      filtered[x] = median3(value, analogs.history[0][x], analogs.history[1][x]) * JITTER_ALPHA;
+      analogs.history[1][x] = analogs.history[0][x];
+      analogs.history[0][x] = value;
+    }
+    else {
+      int32_t delta = value * JITTER_ALPHA - analogs.smoothed[x];
+      int32_t speed = analogs.speed[x] + ((delta - analogs.speed[x]) >> ONE_EURO_SPEED_SHIFT);
+      int32_t alpha = min<int32_t>(256, ONE_EURO_MIN_ALPHA + (abs(speed) >> ONE_EURO_BETA_SHIFT));
+      analogs.speed[x] = speed;
+      analogs.smoothed[x] += (delta * alpha + 128) >> 8;
+      filtered[x] = analogs.smoothed[x];
+    }
+  }
+
+  // multipos pots
+  for (x=POT_FIRST; x<=POT_LAST; x++) {
+    StepsCalibData * calib = (StepsCalibData *) &g_eeGeneral.calib[x];
+    if (IS_POT_MULTIPOS(x) && IS_MULTIPOS_CALIBRATED(calib)) {
+      // TODO: consider adding another low pass filter to eliminate multipos switching glitches
+      uint8_t vShifted = filtered[x] / (JITTER_ALPHA * ANALOG_MULTIPLIER) >> 4;
+      filtered[x] = ANAFILT_MAX;
+      for (uint32_t i=0; i<calib->count; i++) {
+        if (vShifted < calib->steps[i]) {
+          filtered[x] = (i * ANAFILT_MAX) / calib->count;
+          break;
+        }
+      }
+    }
+  }
+
+  // calibration, normalization [0..2048] -> [-1024..1024]
+  for (x=0; x<NUM_STICKS+NUM_POTS+NUM_SLIDERS; x++) {
+    int16_t v = filtered[x] / (JITTER_ALPHA * ANALOG_MULTIPLIER);
+    const CalibData * calib = &g_eeGeneral.calib[x];
+    int16_t centered = v - calib->mid;
+    int16_t span = max((int16_t)100, (centered > 0 ? calib->spanPos : calib->spanNeg));
+    int16_t result = centered * (int32_t)RESX / span;
+    result = (IS_POT_MULTIPOS(x) ? v - RESX : result);
+    analogs.calibrated[x] = analogCenterCurve(limit<int16_t>(-RESX, result, RESX));
+  }
+}
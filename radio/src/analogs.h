@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef _ANALOGS_H_
+#define _ANALOGS_H_
+
+#if defined(VIRTUAL_INPUTS)
+  #define JITTER_FILTER_STRENGTH  4         // tune this value, bigger value - more filtering (range: 1-5) (see explanation in analogs.cpp)
+  #define ANALOG_SCALE            1         // tune this value, bigger value - more filtering (range: 0-1) (see explanation in analogs.cpp)
+
+  #define JITTER_ALPHA            (1<<JITTER_FILTER_STRENGTH)
+  #define ANALOG_MULTIPLIER       (1<<ANALOG_SCALE)
+  #define ANA_FILT(chan)          (s_anaFilt[chan] / (JITTER_ALPHA * ANALOG_MULTIPLIER))
+  #if (JITTER_ALPHA * ANALOG_MULTIPLIER > 32)
+    #error "JITTER_FILTER_STRENGTH and ANALOG_SCALE are too big, their summ should be <= 5 !!!"
+  #endif
+#else
+  #define JITTER_FILTER_STRENGTH  0
+  #define ANALOG_SCALE            0
+  #define JITTER_ALPHA            1
+  #define ANALOG_MULTIPLIER       1
+  #define ANA_FILT(chan)          (s_anaFilt[chan])
+#endif
+
+#define ANAFILT_MAX               (2 * RESX * JITTER_ALPHA * ANALOG_MULTIPLIER - 1)
+
+// Filter applied to each analog before its calibration
+enum AnalogFilters {
+  ANALOG_FILTER_MMA,        // modified moving average of the small changes (the jitter filter)
+  ANALOG_FILTER_ONE_EURO,   // low pass filter with a cutoff which increases with the speed
+  ANALOG_FILTER_MEDIAN3,    // median of the 3 last values, removes the single glitches
+  ANALOG_FILTER_COUNT
+};
+
+/*
+ * The analogs are processed in one pass at each mixer cycle: filter, multipos
+ * pots decoding, calibration and sticks center curve. The data is stored as
+ * one array per value so that each stage is a loop over all the analogs.
+ */
+struct AnalogsData {
+  uint16_t raw[NUM_ANALOGS];              // ADC values, ANALOG_SCALE applied
+  uint16_t smoothed[NUM_ANALOGS];         // 1-euro filter output, same scale as s_anaFilt
+  int32_t  speed[NUM_ANALOGS];            // 1-euro filter, smoothed variation of the input
+  uint16_t history[2][NUM_ANALOGS];       // median filter, previous raw values
+  int16_t  calibrated[NUM_STICKS+NUM_POTS+NUM_SLIDERS];
+  uint8_t  filter[NUM_ANALOGS];
+  uint32_t otherFilters;                  // the analogs which don't use the MMA filter
+};
+
+extern AnalogsData analogs;
+
+void setAnalogFilter(uint8_t index, uint8_t filter);
+
+// Filters analogs.raw into filtered (s_anaFilt on the radio), then calibrates the sticks, pots and sliders
+void processAnalogs(uint16_t * filtered);
+
+// Sticks center: gain of CENTER_VALUE/CENTER_OFFSET up to CENTER_OFFSET,
+// then a line up to (RESX, RESX)
+#define CENTER_OFFSET             30
+#define CENTER_VALUE              9
+
+inline int16_t analogCenterCurve(int16_t value)
+{
+  int32_t a = (value < 0 ? -value : value);
+  int32_t center = a * CENTER_VALUE / CENTER_OFFSET;
+  int32_t outside = ((RESX - CENTER_VALUE) * a - (int32_t)RESX * (CENTER_OFFSET - CENTER_VALUE)) / (RESX - CENTER_OFFSET);
+  int16_t result = (a > CENTER_OFFSET ? outside : center);
+  return value < 0 ? -result : result;
+}
+
+#endif // _ANALOGS_H_
@@ -506,10 +506,6 @@ AudioQueue::AudioQueue()
 {
 }
 
-#define CODEC_ID_PCM_S16LE  1
-#define CODEC_ID_PCM_ALAW   6
-#define CODEC_ID_PCM_MULAW  7
-
 #if !defined(SIMU)
 TASK_FUNCTION(audioTask)
 {
@@ -551,9 +547,105 @@ TASK_FUNCTION(audioTask)
 }
 #endif
 
+// saturation to the audio samples range, with the DSP instructions on the radio
+#if defined(STM32) && !defined(SIMU) && AUDIO_DATA_MIN < 0
+  #define AUDIO_SATURATE(value)        __SSAT((value), AUDIO_BITS_PER_SAMPLE)
+#elif defined(STM32) && !defined(SIMU)
+  #define AUDIO_SATURATE(value)        __USAT((value), AUDIO_BITS_PER_SAMPLE)
+#else
+  #define AUDIO_SATURATE(value)        limit<int>(AUDIO_DATA_MIN, (value), AUDIO_DATA_MAX)
+#endif
+
 inline void mixSample(audio_data_t * result, int sample, unsigned int fade)
 {
-  *result = limit(AUDIO_DATA_MIN, *result + ((sample >> fade) >> (16-AUDIO_BITS_PER_SAMPLE)), AUDIO_DATA_MAX);
+  *result = AUDIO_SATURATE(*result + ((sample >> fade) >> (16-AUDIO_BITS_PER_SAMPLE)));
+}
+
+// The WAV samples are processed by blocks, with plain loops on arrays that
+// the compiler can unroll / vectorize: the whole block is decoded in place,
+// then resampled and mixed in one pass.
+
+unsigned int decodeWavSamples(int16_t * samples, unsigned int count, uint8_t codec)
+{
+  const uint8_t * data = (const uint8_t *)samples;
+
+  switch (codec) {
+    case CODEC_ID_PCM_S16LE:
+      return count / 2;
+
+    case CODEC_ID_PCM_ALAW:
+      // backwards, as each byte becomes a 16 bits sample
+      for (int i=count-1; i>=0; i--) {
+        samples[i] = alawTable[data[i]];
+      }
+      return count;
+
+    case CODEC_ID_PCM_MULAW:
+      for (int i=count-1; i>=0; i--) {
+        samples[i] = ulawTable[data[i]];
+      }
+      return count;
+
+    default:
+      return 0;
+  }
+}
+
+unsigned int mixWavSamples(audio_data_t * result, const int16_t * samples, unsigned int count, unsigned int ratio, int16_t previous, unsigned int shift)
+{
+  shift += 16 - AUDIO_BITS_PER_SAMPLE;
+
+  switch (ratio) {
+    case 1:
+      for (unsigned int i=0; i<count; i++) {
+        result[i] = AUDIO_SATURATE(result[i] + (samples[i] >> shift));
+      }
+      break;
+
+    // The usual 16kHz and 8kHz files get their own loops. The samples between the
+    // previous and the current one are their successive halves, computed on samples
+    // which are shifted first. This keeps the linear interpolation as fast as
+    // repeating each sample
+    case 2:
+      previous >>= shift;
+      for (unsigned int i=0; i<count; i++) {
+        int32_t current = samples[i] >> shift;
+        result[0] = AUDIO_SATURATE(result[0] + ((previous + current) >> 1));
+        result[1] = AUDIO_SATURATE(result[1] + current);
+        result += 2;
+        previous = current;
+      }
+      break;
+
+    case 4:
+      previous >>= shift;
+      for (unsigned int i=0; i<count; i++) {
+        int32_t current = samples[i] >> shift;
+        int32_t middle = (previous + current) >> 1;
+        result[0] = AUDIO_SATURATE(result[0] + ((previous + middle) >> 1));
+        result[1] = AUDIO_SATURATE(result[1] + middle);
+        result[2] = AUDIO_SATURATE(result[2] + ((middle + current) >> 1));
+        result[3] = AUDIO_SATURATE(result[3] + current);
+        result += 4;
+        previous = current;
+      }
+      break;
+
+    default:
+      for (unsigned int i=0; i<count; i++) {
+        int32_t current = samples[i];
+        int32_t delta = current - previous;
+        for (unsigned int j=0; j<ratio; j++) {
+          int32_t sample = previous + (delta * int32_t(j+1)) / int32_t(ratio);
+          *result = AUDIO_SATURATE(*result + (sample >> shift));
+          result++;
+        }
+        previous = current;
+      }
+      break;
+  }
+
+  return count * ratio;
 }
 
 #if defined(SDCARD)
@@ -561,91 +653,248 @@ inline void mixSample(audio_data_t * result, int sample, unsigned int fade)
 #define RIFF_CHUNK_SIZE 12
 uint8_t wavBuffer[AUDIO_BUFFER_SIZE*2] __DMA;
 
+// The parsed headers of the last played files, to go straight to their
+// samples next time (the system prompts are played again and again)
+#define WAV_HEADERS_CACHE_SIZE 8
+
+struct WavHeadersCacheEntry {
+  uint32_t hash;                 // of the file name, 0 when the entry is free
+  uint32_t fileSize;
+  uint32_t dataOffset;
+  uint32_t lastUse;
+  WavHeader header;
+};
+
+static WavHeadersCacheEntry wavHeadersCache[WAV_HEADERS_CACHE_SIZE];
+static uint32_t wavHeadersCacheUses;
+
+// The next file in the queue, opened and positioned on its samples while
+// the current one is played
+static struct {
+  FIL file;
+  WavHeader header;
+  char filename[AUDIO_FILENAME_MAXLEN+1]; // empty when no file is opened
+} wavNextFile;
+
+// set by stopSD(), the cache and the next file are dropped by the audio task
+static volatile bool wavFilesReset;
+
+static uint32_t getWavFilenameHash(const char * filename)
+{
+  uint32_t hash = 2166136261u;
+  while (*filename) {
+    hash = (hash ^ uint8_t(*filename++)) * 16777619u;
+  }
+  return hash ? hash : 1;
+}
+
+static FRESULT readWavHeader(FIL * file, WavHeader & header)
+{
+  UINT read = 0;
+
+  FRESULT result = f_read(file, wavBuffer, RIFF_CHUNK_SIZE+8, &read);
+  if (result == FR_OK && read == RIFF_CHUNK_SIZE+8 && !memcmp(wavBuffer, "RIFF", 4) && !memcmp(wavBuffer+8, "WAVEfmt ", 8)) {
+    uint32_t size = *((uint32_t *)(wavBuffer+16));
+    result = (size < 256 ? f_read(file, wavBuffer, size+8, &read) : FR_DENIED);
+    if (result == FR_OK && read == size+8) {
+      header.codec = ((uint16_t *)wavBuffer)[0];
+      header.freq = ((uint16_t *)wavBuffer)[2];
+      uint32_t *wavSamplesPtr = (uint32_t *)(wavBuffer + size);
+      uint32_t size = wavSamplesPtr[1];
+      if (header.freq == 0 || header.freq * (AUDIO_SAMPLE_RATE / header.freq) != AUDIO_SAMPLE_RATE) {
+        result = FR_DENIED;
+      }
+      while (result == FR_OK && memcmp(wavSamplesPtr, "data", 4) != 0) {
+        result = f_lseek(file, f_tell(file)+size);
+        if (result == FR_OK) {
+          result = f_read(file, wavBuffer, 8, &read);
+          if (read != 8) result = FR_DENIED;
+          wavSamplesPtr = (uint32_t *)wavBuffer;
+          size = wavSamplesPtr[1];
+        }
+      }
+      header.size = size;
+    }
+    else {
+      result = FR_DENIED;
+    }
+  }
+  else {
+    result = FR_DENIED;
+  }
+
+  return result;
+}
+
+// opens the file and moves to its samples
+static FRESULT openWavFile(FIL * file, const char * filename, WavHeader & header)
+{
+  if (wavFilesReset) {
+    wavFilesReset = false;
+    memclear(wavHeadersCache, sizeof(wavHeadersCache));
+    wavNextFile.filename[0] = '\0';
+  }
+
+  FRESULT result = f_open(file, filename, FA_OPEN_EXISTING | FA_READ);
+  if (result != FR_OK) {
+    return result;
+  }
+
+  uint32_t hash = getWavFilenameHash(filename);
+  WavHeadersCacheEntry * entry = &wavHeadersCache[0];
+  for (int i=0; i<WAV_HEADERS_CACHE_SIZE; i++) {
+    WavHeadersCacheEntry & it = wavHeadersCache[i];
+    if (it.hash == hash && it.fileSize == f_size(file)) {
+      it.lastUse = ++wavHeadersCacheUses;
+      header = it.header;
+      return f_lseek(file, it.dataOffset);
+    }
+    if (it.lastUse < entry->lastUse) {
+      entry = &it;
+    }
+  }
+
+  result = readWavHeader(file, header);
+  if (result == FR_OK) {
+    entry->hash = hash;
+    entry->fileSize = f_size(file);
+    entry->dataOffset = f_tell(file);
+    entry->lastUse = ++wavHeadersCacheUses;
+    entry->header = header;
+  }
+  else {
+    f_close(file);
+  }
+
+  return result;
+}
+
+static void prefetchWavFile(const char * filename)
+{
+  if (wavNextFile.filename[0] && !wavFilesReset) {
+    if (filename && !strcmp(filename, wavNextFile.filename)) {
+      return;
+    }
+    f_close(&wavNextFile.file);
+  }
+
+  wavNextFile.filename[0] = '\0';
+
+  if (filename && openWavFile(&wavNextFile.file, filename, wavNextFile.header) == FR_OK) {
+    strcpy(wavNextFile.filename, filename);
+  }
+}
+
+static void resetWavFiles()
+{
+  wavFilesReset = true;
+}
+
+#if defined(AUDIO_FILE_CHUNK_SIZE)
+FRESULT WavContext::readChunk(uint8_t idx)
+{
+  // the chunks end on sectors boundaries, then whole sectors are read
+  // directly into the buffer
+  uint32_t size = AUDIO_FILE_CHUNK_SIZE - (f_tell(&state.file) % 512);
+  if (size > state.size) {
+    size = state.size;
+  }
+
+  UINT read = 0;
+  FRESULT result = f_read(&state.file, state.chunks[idx], size, &read);
+  state.size -= read;
+  state.chunksSize[idx] = read;
+  return result;
+}
+
+void WavContext::readAhead()
+{
+  // the file is opened on its first buffer, as before
+  if (!fragment.file[1] && state.size > 0) {
+    uint8_t idx = state.chunkIdx ^ 1;
+    if (state.chunksSize[idx] == 0) {
+      readChunk(idx);
+    }
+  }
+}
+#else
+void WavContext::readAhead()
+{
+}
+#endif
+
 int WavContext::mixBuffer(AudioBuffer *buffer, int volume, unsigned int fade)
 {
   FRESULT result = FR_OK;
   UINT read = 0;
 
   if (fragment.file[1]) {
-    result = f_open(&state.file, fragment.file, FA_OPEN_EXISTING | FA_READ);
+    WavHeader header;
+    if (wavNextFile.filename[0] && !wavFilesReset && !strcmp(fragment.file, wavNextFile.filename)) {
+      state.file = wavNextFile.file;
+      header = wavNextFile.header;
+      wavNextFile.filename[0] = '\0';
+    }
+    else {
+      result = openWavFile(&state.file, fragment.file, header);
+    }
     fragment.file[1] = 0;
     if (result == FR_OK) {
-      result = f_read(&state.file, wavBuffer, RIFF_CHUNK_SIZE+8, &read);
-      if (result == FR_OK && read == RIFF_CHUNK_SIZE+8 && !memcmp(wavBuffer, "RIFF", 4) && !memcmp(wavBuffer+8, "WAVEfmt ", 8)) {
-        uint32_t size = *((uint32_t *)(wavBuffer+16));
-        result = (size < 256 ? f_read(&state.file, wavBuffer, size+8, &read) : FR_DENIED);
-        if (result == FR_OK && read == size+8) {
-          state.codec = ((uint16_t *)wavBuffer)[0];
-          state.freq = ((uint16_t *)wavBuffer)[2];
-          uint32_t *wavSamplesPtr = (uint32_t *)(wavBuffer + size);
-          uint32_t size = wavSamplesPtr[1];
-          if (state.freq != 0 && state.freq * (AUDIO_SAMPLE_RATE / state.freq) == AUDIO_SAMPLE_RATE) {
-            state.resampleRatio = (AUDIO_SAMPLE_RATE / state.freq);
-            state.readSize = (state.codec == CODEC_ID_PCM_S16LE ? 2*AUDIO_BUFFER_SIZE : AUDIO_BUFFER_SIZE) / state.resampleRatio;
-          }
-          else {
-            result = FR_DENIED;
-          }
-          while (result == FR_OK && memcmp(wavSamplesPtr, "data", 4) != 0) {
-            result = f_lseek(&state.file, f_tell(&state.file)+size);
-            if (result == FR_OK) {
-              result = f_read(&state.file, wavBuffer, 8, &read);
-              if (read != 8) result = FR_DENIED;
-              wavSamplesPtr = (uint32_t *)wavBuffer;
-              size = wavSamplesPtr[1];
-            }
-          }
-          state.size = size;
-        }
-        else {
-          result = FR_DENIED;
-        }
-      }
-      else {
-        result = FR_DENIED;
-      }
+      state.codec = header.codec;
+      state.freq = header.freq;
+      state.size = header.size;
+      state.resampleRatio = (AUDIO_SAMPLE_RATE / state.freq);
+      state.readSize = (state.codec == CODEC_ID_PCM_S16LE ? 2*AUDIO_BUFFER_SIZE : AUDIO_BUFFER_SIZE) / state.resampleRatio;
+      state.lastSample = 0;
+#if defined(AUDIO_FILE_CHUNK_SIZE)
+      state.chunksSize[0] = state.chunksSize[1] = 0;
+      state.chunkPos = 0;
+      state.chunkIdx = 0;
+#endif
     }
   }
 
   if (result == FR_OK) {
-    read = 0;
-    result = f_read(&state.file, wavBuffer, state.readSize, &read);
-    if (result == FR_OK) {
-      if (read > state.size) {
-        read = state.size;
+#if defined(AUDIO_FILE_CHUNK_SIZE)
+    while (read < state.readSize) {
+      if (state.chunkPos >= state.chunksSize[state.chunkIdx]) {
+        // this chunk is done, the next one should have been read ahead
+        state.chunksSize[state.chunkIdx] = 0;
+        state.chunkIdx ^= 1;
+        state.chunkPos = 0;
+        if (state.chunksSize[state.chunkIdx] == 0) {
+          if (state.size == 0)
+            break;
+          result = readChunk(state.chunkIdx);
+          if (result != FR_OK || state.chunksSize[state.chunkIdx] == 0)
+            break;
+        }
       }
-      state.size -= read;
+      uint32_t size = min<uint32_t>(state.readSize - read, state.chunksSize[state.chunkIdx] - state.chunkPos);
+      memcpy(wavBuffer + read, (uint8_t *)state.chunks[state.chunkIdx] + state.chunkPos, size);
+      state.chunkPos += size;
+      read += size;
+    }
+#else
+    result = f_read(&state.file, wavBuffer, min<uint32_t>(state.readSize, state.size), &read);
+    state.size -= read;
+#endif
 
+    if (result == FR_OK) {
       if (read != state.readSize) {
         f_close(&state.file);
         fragment.clear();
       }
 
-      audio_data_t * samples = buffer->data;
-      if (state.codec == CODEC_ID_PCM_S16LE) {
-        read /= 2;
-        for (uint32_t i=0; i<read; i++) {
-          for (uint8_t j=0; j<state.resampleRatio; j++) {
-            mixSample(samples++, ((int16_t *)wavBuffer)[i], fade+2-volume);
-          }
-        }
-      }
-      else if (state.codec == CODEC_ID_PCM_ALAW) {
-        for (uint32_t i=0; i<read; i++) {
-          for (uint8_t j=0; j<state.resampleRatio; j++) {
-            mixSample(samples++, alawTable[wavBuffer[i]], fade+2-volume);
-          }
-        }
-      }
-      else if (state.codec == CODEC_ID_PCM_MULAW) {
-        for (uint32_t i=0; i<read; i++) {
-          for (uint8_t j=0; j<state.resampleRatio; j++) {
-            mixSample(samples++, ulawTable[wavBuffer[i]], fade+2-volume);
-          }
-        }
+      int16_t * samples = (int16_t *)wavBuffer;
+      unsigned int count = decodeWavSamples(samples, read, state.codec);
+      if (count > 0) {
+        int16_t previous = state.lastSample;
+        state.lastSample = samples[count-1];
+        count = mixWavSamples(buffer->data, samples, count, state.resampleRatio, previous, fade+2-volume);
       }
 
-      return samples - buffer->data;
+      return count;
     }
   }
 
@@ -654,11 +903,36 @@ int WavContext::mixBuffer(AudioBuffer *buffer, int volume, unsigned int fade)
   }
   return 0;
 }
+
+void AudioQueue::readAhead()
+{
+  normalContext.readAhead();
+  backgroundContext.readAhead();
+
+  // the next file in the queue
+  char filename[AUDIO_FILENAME_MAXLEN+1];
+  filename[0] = '\0';
+  RTOS_LOCK_MUTEX(audioMutex);
+  const AudioFragment * fragment = fragmentsFifo.next();
+  if (fragment && fragment->type == FRAGMENT_FILE) {
+    strcpy(filename, fragment->file);
+  }
+  RTOS_UNLOCK_MUTEX(audioMutex);
+  prefetchWavFile(filename[0] ? filename : NULL);
+}
 #else
 int WavContext::mixBuffer(AudioBuffer *buffer, int volume, unsigned int fade)
 {
   return 0;
 }
+
+void WavContext::readAhead()
+{
+}
+
+void AudioQueue::readAhead()
+{
+}
 #endif
 
 const unsigned int toneVolumes[] = { 10, 8, 6, 4, 2 };
@@ -832,6 +1106,9 @@ void AudioQueue::wakeup()
     audioConsumeCurrentBuffer();
     DEBUG_TIMER_STOP(debugTimerAudioConsume);
   }
+
+  // the buffers are filled, the next samples can be read from the SD card
+  readAhead();
 }
 
 inline unsigned int getToneLength(uint16_t len)
@@ -949,6 +1226,7 @@ void AudioQueue::stopPlay(uint8_t id)
 void AudioQueue::stopSD()
 {
   sdAvailableSystemAudioFiles.reset();
+  resetWavFiles();
   stopAll();
   playTone(0, 0, 100, PLAY_NOW);        // insert a 100ms pause
 }
@@ -126,6 +126,13 @@ struct AudioBuffer {
 
 extern AudioBuffer audioBuffers[AUDIO_BUFFER_COUNT];
 
+#define CODEC_ID_PCM_S16LE             1
+#define CODEC_ID_PCM_ALAW              6
+#define CODEC_ID_PCM_MULAW             7
+
+unsigned int decodeWavSamples(int16_t * samples, unsigned int count, uint8_t codec);
+unsigned int mixWavSamples(audio_data_t * result, const int16_t * samples, unsigned int count, unsigned int ratio, int16_t previous, unsigned int shift);
+
 enum FragmentTypes {
   FRAGMENT_EMPTY,
   FRAGMENT_TONE,
@@ -209,12 +216,26 @@ class ToneContext {
 
 };
 
+// The WAV samples are read ahead by chunks, 2 per WavContext (normal and background),
+// which takes 4*AUDIO_FILE_CHUNK_SIZE = 4KB of RAM. Only the radios with an SDRAM
+// do it, the other ones read the samples when each buffer is filled
+#if defined(SDRAM)
+#define AUDIO_FILE_CHUNK_SIZE          (1024) // read-ahead of 2 sectors, at least 2*AUDIO_BUFFER_SIZE
+#endif
+
+struct WavHeader {
+  uint32_t size;                 // size of the samples
+  uint16_t freq;
+  uint8_t  codec;
+};
+
 class WavContext {
   public:
 
     inline void clear() { fragment.clear(); };
 
     int mixBuffer(AudioBuffer *buffer, int volume, unsigned int fade);
+    void readAhead();
     bool hasPromptId(uint8_t id) const { return fragment.id == id; };
 
     void setFragment(const char * filename, uint8_t repeat, uint8_t id)
@@ -239,7 +260,20 @@ class WavContext {
       uint32_t size;
       uint8_t  resampleRatio;
       uint16_t readSize;
+      int16_t  lastSample;
+#if defined(AUDIO_FILE_CHUNK_SIZE)
+      // the samples are read by chunks, one is consumed while the other one
+      // is read ahead
+      uint32_t chunks[2][AUDIO_FILE_CHUNK_SIZE / sizeof(uint32_t)];
+      uint16_t chunksSize[2];
+      uint16_t chunkPos;
+      uint8_t  chunkIdx;
+#endif
     } state;
+
+#if defined(AUDIO_FILE_CHUNK_SIZE)
+    FRESULT readChunk(uint8_t idx);
+#endif
 };
 
 class MixedContext {
@@ -277,6 +311,11 @@ class MixedContext {
       return 0;
     }
 
+    void readAhead()
+    {
+      if (isFile()) wav.readAhead();
+    }
+
   private:
     union {
       AudioFragment fragment;   // a hack: fragment is used to access the fragment members of tone and wav
@@ -457,6 +496,11 @@ class AudioFragmentFifo
       widx = ridx;                      // clean the queue
     }
 
+    const AudioFragment * next() const
+    {
+      return empty() ? 0 : &fragments[ridx];
+    }
+
     const AudioFragment * get()
     {
       if (!empty()) {
@@ -507,6 +551,8 @@ class AudioQueue {
     AudioBufferFifo buffersFifo;
 
   private:
+    void readAhead();
+
     volatile bool _started;
     MixedContext normalContext;
     WavContext   backgroundContext;
@@ -415,6 +415,27 @@ void testDrawTextVertical()
   lcdDrawText(30, LCD_H, "The quick brown fox ", TEXT_COLOR|VERTICAL);
 }
 
+// a telemetry-like screen: the same labels and values redrawn on each refresh
+void testDrawTextScreen()
+{
+  static const char * const labels[] = { "RxBt", "RSSI", "VFAS", "Curr", "Alt", "GSpd", "Hdg", "Tmp1" };
+  static const LcdFlags fonts[] = { SMLSIZE, 0, MIDSIZE };
+  for (int i=0; i<24; i++) {
+    coord_t y = (i % 12) * 38;
+    coord_t x = (i / 12) * (LCD_W/2);
+    LcdFlags font = fonts[i % DIM(fonts)];
+    lcdDrawText(x + 2, y + 2, labels[i % DIM(labels)], font | TEXT_COLOR);
+    lcdDrawNumber(x + LCD_W/2 - 4, y + 2, 100 + i, font | PREC1 | RIGHT | ((i & 1) ? ALARM_COLOR : TEXT_COLOR));
+  }
+}
+
+void testDrawTextScreenWithoutCache()
+{
+  textRunCache.enabled = false;
+  testDrawTextScreen();
+  textRunCache.enabled = true;
+}
+
 void testClear()
 {
   lcdClear();
@@ -467,6 +488,10 @@ int cliTestGraphics()
   result += RUN_GRAPHICS_TEST(testDrawBlackOverlay, 1000);
   result += RUN_GRAPHICS_TEST(testDrawText, 1000);
   result += RUN_GRAPHICS_TEST(testDrawTextVertical, 1000);
+  result += RUN_GRAPHICS_TEST(testDrawTextScreenWithoutCache, 1000);
+  textRunCache.clear();
+  result += RUN_GRAPHICS_TEST(testDrawTextScreen, 1000);
+  serialPrint("Text run cache: %d hits, %d misses, %d evictions, %d bytes", textRunCache.hits, textRunCache.misses, textRunCache.evictions, textRunCache.size);
   result += RUN_GRAPHICS_TEST(testClear, 1000);
 
   serialPrint("Total speed: %0.2f", result);
@@ -723,6 +748,9 @@ int cliStackInfo(const char ** argv)
   serialPrint("[MENUS] %d available / %d", menusStack.available(), menusStack.size());
   serialPrint("[MIXER] %d available / %d", mixerStack.available(), mixerStack.size());
   serialPrint("[AUDIO] %d available / %d", audioStack.available(), audioStack.size());
+#if defined(LOGS_BINARY)
+  serialPrint("[LOGS] %d available / %d", logsStack.available(), logsStack.size());
+#endif
   serialPrint("[CLI] %d available / %d", cliStack.available(), cliStack.size());
   return 0;
 }
@@ -836,6 +864,19 @@ int cliSet(const char ** argv)
     return 0;
   }
 #endif
+  else if (!strcmp(argv[1], "filter")) {
+    static const char * const filters[] = { "mma", "euro", "median" };
+    int index = 0;
+    if (toInt(argv, 2, &index) > 0 && index >= 0 && index < NUM_ANALOGS) {
+      for (uint8_t filter=0; filter<ANALOG_FILTER_COUNT; filter++) {
+        if (argv[3] && !strcmp(argv[3], filters[filter])) {
+          setAnalogFilter(index, filter);
+          return 0;
+        }
+      }
+    }
+    serialPrint("%s: Invalid arguments, usage: set filter <index> mma|euro|median", argv[0]);
+  }
   return 0;
 }
 
@@ -876,6 +917,11 @@ void printTaskSwitchLog()
     else if (audioTaskId == n) {
       serialPrint("%d: audio", n);
     }
+#if defined(LOGS_BINARY)
+    else if (logsTaskId == n) {
+      serialPrint("%d: logs", n);
+    }
+#endif
   }
   serialCrlf();
 
@@ -1084,11 +1130,24 @@ int cliDisplay(const char ** argv)
   else if (!strcmp(argv[1], "audio")) {
     printAudioVars();
   }
+#if defined(DEBUG)
+  else if (!strcmp(argv[1], "telemetry")) {
+    tmr10ms_t duration = get_tmr10ms() - telemetryLookupStats.start;
+    uint32_t lookups = telemetryLookupStats.lookups;
+    serialPrint("Telemetry lookups: %u (%u/s), time: %uus (%uus/s), index rebuilds: %u",
+                lookups, duration ? lookups * 100 / duration : 0,
+                telemetryLookupStats.time / 2, duration ? telemetryLookupStats.time * 50 / duration : 0,
+                telemetryLookupStats.rebuilds);
+    memclear(&telemetryLookupStats, sizeof(telemetryLookupStats));
+    telemetryLookupStats.start = get_tmr10ms();
+  }
+#endif
 #if defined(DISK_CACHE)
   else if (!strcmp(argv[1], "dc")) {
     DiskCacheStats stats = diskCache.getStats();
     uint32_t hitRate = diskCache.getHitRate();
     serialPrint("Disk Cache stats: w:%u r: %u, h: %u(%0.1f%%), m: %u", stats.noWrites, (stats.noHits + stats.noMisses), stats.noHits, hitRate*0.1f, stats.noMisses);
+    serialPrint("Disk Cache evictions: %u, disk writes: %u", stats.noEvictions, stats.noDiskWrites);
   }
 #endif
   else if (toLongLongInt(argv, 1, &address) > 0) {
@@ -1115,6 +1174,45 @@ int cliDebugVars(const char ** argv)
   return 0;
 }
 
+void printTimingHistogram(const char * name, const TimingHistogram & histogram)
+{
+  serialPrintf("  %s:", name);
+  for (int i=0; i<TIMING_HISTOGRAM_BUCKETS; i++) {
+    uint32_t count = histogram.getCount(i);
+    if (count) {
+      if (i == 0)
+        serialPrintf(" 0us:%u", count);
+      else if (i == TIMING_HISTOGRAM_BUCKETS - 1)
+        serialPrintf(" >=%uus:%u", 1 << (i-1), count);
+      else
+        serialPrintf(" %u-%uus:%u", 1 << (i-1), (1 << i) - 1, count);
+    }
+  }
+  serialPrint(" max:%uus", histogram.getMax());
+}
+
+int cliMixerStats(const char ** argv)
+{
+  if (argv[1] && !strcmp(argv[1], "reset")) {
+    resetMixerStats();
+    return 0;
+  }
+
+  for (int i=0; i<=MIXER_STATS_TIMEOUT; i++) {
+    if (i == MIXER_STATS_TIMEOUT)
+      serialPrint("Runs without module:");
+    else
+      serialPrint("Runs for module %d:", i);
+    printTimingHistogram("duration", mixerStats[i].duration);
+    if (i != MIXER_STATS_TIMEOUT) {
+      printTimingHistogram("latency", mixerStats[i].latency);
+    }
+    printTimingHistogram("period", mixerStats[i].period);
+  }
+
+  return 0;
+}
+
 int cliRepeat(const char ** argv)
 {
   int interval = 0;
@@ -1227,6 +1325,7 @@ const CliCommand cliCommands[] = {
 #endif
   { "help", cliHelp, "[<command>]" },
   { "debugvars", cliDebugVars, "" },
+  { "mixerstats", cliMixerStats, "[reset]" },
   { "repeat", cliRepeat, "<interval> <command>" },
 #if defined(JITTER_MEASURE)
   { "jitter", cliShowJitter, "" },
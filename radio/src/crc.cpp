@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "crc.h"
+
+/*
+ * The tables are generated by the compiler and stored in flash.
+ *
+ * slice[0] is the usual byte table, slice[k] gives the CRC of a byte followed
+ * by k null bytes. As the CRC is linear, the CRC of 4 bytes is the XOR of the
+ * 4 slices entries, which removes 3 dependent table lookups out of 4.
+ */
+
+template<unsigned... I> struct CrcSequence {};
+template<unsigned N, unsigned... I> struct MakeCrcSequence : MakeCrcSequence<N-1, N-1, I...> {};
+template<unsigned... I> struct MakeCrcSequence<0, I...> : CrcSequence<I...> {};
+
+constexpr uint8_t crc8Bits(uint8_t crc, int bits)
+{
+  return bits == 0 ? crc : crc8Bits((crc & 0x80) ? (crc << 1) ^ 0xD5 : crc << 1, bits - 1);
+}
+
+// CCITT implementation, MSB first
+constexpr uint16_t crc16Bits(uint16_t crc, int bits)
+{
+  return bits == 0 ? crc : crc16Bits((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1, bits - 1);
+}
+
+// The PXX table holds the entries of the LSB first CCITT implementation (0x8408),
+// it is used MSB first as the 0x1021 one
+constexpr uint16_t crc16ReflectedBits(uint16_t crc, int bits)
+{
+  return bits == 0 ? crc : crc16ReflectedBits((crc & 0x0001) ? (crc >> 1) ^ 0x8408 : crc >> 1, bits - 1);
+}
+
+constexpr uint16_t crc16Entry(uint8_t index, uint16_t value)
+{
+  return index == CRC_1021 ? crc16Bits(value << 8, 8) : crc16ReflectedBits(value, 8);
+}
+
+// One null byte through the CRC
+constexpr uint16_t crc16Shift(uint8_t index, uint16_t crc)
+{
+  return uint16_t(crc << 8) ^ crc16Entry(index, crc >> 8);
+}
+
+constexpr uint16_t crc16SliceEntry(uint8_t index, int slice, uint16_t value)
+{
+  return slice == 0 ? crc16Entry(index, value) : crc16Shift(index, crc16SliceEntry(index, slice - 1, value));
+}
+
+static_assert(CRC_SLICES == 4, "The tables generators need to be updated");
+
+template<unsigned... I>
+constexpr Crc8Table crc8Table(CrcSequence<I...>)
+{
+  return {{ { crc8Bits(I, 8)... }, { crc8Bits(I, 16)... }, { crc8Bits(I, 24)... }, { crc8Bits(I, 32)... } }};
+}
+
+template<unsigned... I>
+constexpr Crc16Table crc16Table(uint8_t index, CrcSequence<I...>)
+{
+  return {{ { crc16SliceEntry(index, 0, I)... }, { crc16SliceEntry(index, 1, I)... }, { crc16SliceEntry(index, 2, I)... }, { crc16SliceEntry(index, 3, I)... } }};
+}
+
+constexpr Crc8Table crc8tab = crc8Table(MakeCrcSequence<256>());
+
+constexpr Crc16Table crc16tab[CRC16_COUNT] = {
+  crc16Table(CRC_1021, MakeCrcSequence<256>()),
+  crc16Table(CRC_1189, MakeCrcSequence<256>()),
+};
+
+uint8_t crc8(const uint8_t * buf, uint32_t len, uint8_t crc)
+{
+  const uint8_t (* tab)[256] = crc8tab.slice;
+  while (len >= 4) {
+    crc = tab[3][crc ^ buf[0]] ^ tab[2][buf[1]] ^ tab[1][buf[2]] ^ tab[0][buf[3]];
+    buf += 4;
+    len -= 4;
+  }
+  while (len--) {
+    crc = tab[0][crc ^ *buf++];
+  }
+  return crc;
+}
+
+uint16_t crc16(uint8_t index, const uint8_t * buf, uint32_t len, uint16_t crc)
+{
+  const uint16_t (* tab)[256] = crc16tab[index].slice;
+  while (len >= 4) {
+    crc = tab[3][(crc >> 8) ^ buf[0]] ^ tab[2][(crc & 0xFF) ^ buf[1]] ^ tab[1][buf[2]] ^ tab[0][buf[3]];
+    buf += 4;
+    len -= 4;
+  }
+  while (len--) {
+    crc = (crc << 8) ^ tab[0][(crc >> 8) ^ *buf++];
+  }
+  return crc;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef CRC_H
+#define CRC_H
+
+#include <inttypes.h>
+
+// Number of tables per CRC, buffers are processed 4 bytes at a time (slice-by-4)
+#define CRC_SLICES                     4
+
+// CRC16 variants
+enum {
+  CRC_1021,     // CCITT (S.Port, FlySky hall sticks and RF module)
+  CRC_1189,     // PXX
+  CRC16_COUNT
+};
+
+struct Crc8Table {
+  uint8_t slice[CRC_SLICES][256];
+};
+
+struct Crc16Table {
+  uint16_t slice[CRC_SLICES][256];
+};
+
+extern const Crc8Table crc8tab;
+extern const Crc16Table crc16tab[CRC16_COUNT];
+
+// CRC8 with polynom = x^8+x^7+x^6+x^4+x^2+1 (0xD5), used by Crossfire
+uint8_t crc8(const uint8_t * buf, uint32_t len, uint8_t crc = 0);
+
+// The result of a first call may be given as start value of the next one
+// to compute the CRC of a frame received in several parts
+uint16_t crc16(uint8_t index, const uint8_t * buf, uint32_t len, uint16_t crc = 0);
+
+// Byte by byte updates, for the frames built or parsed one byte at a time
+inline uint8_t crc8Update(uint8_t crc, uint8_t byte)
+{
+  return crc8tab.slice[0][crc ^ byte];
+}
+
+inline uint16_t crc16Update(uint8_t index, uint16_t crc, uint8_t byte)
+{
+  return (crc << 8) ^ crc16tab[index].slice[0][(crc >> 8) ^ byte];
+}
+
+#endif // CRC_H
@@ -53,6 +53,10 @@ void loadCurves()
     curveEnd[i] = tmp;
 
   }
+#if defined(CURVES_LUT)
+  invalidateCurvesLut();
+#endif
+
   if (showWarning) {
     POPUP_WARNING("Invalid curve data repaired");
     const char * w = "check your curves, logic switches";
@@ -80,6 +84,7 @@ bool moveCurve(uint8_t index, int8_t shift)
   }
   
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
   return true;
 }
 
@@ -309,6 +314,219 @@ int intpol(int x, uint8_t idx) // -100, -75, -50, -25, 0 ,25 ,50, 75, 100
 }
 
 #if defined(CPUARM)
+#if defined(CURVES_LUT)
+// Lookup tables for the custom curves and expos used by the mixer. The
+// tables cover the whole -RESX..RESX range with one entry per input value,
+// so that a lookup returns exactly what applyCustomCurve() / expo() would.
+// They are (re)built in the mixer task, a chunk at a time, after the model
+// has been loaded or edited. Until a table is complete the value is computed.
+#define CURVE_LUT_SIZE         (2*RESX+1)
+#define EXPO_LUT_SIZE          (RESX+1) // expo(-x) == -expo(x)
+#define LUT_BUILD_STEP         256
+
+struct CurveLut {
+  uint32_t checksum;
+  uint8_t curve;         // curve index + 1, 0 when the slot is free
+  uint16_t built;        // number of values already computed
+  int16_t values[CURVE_LUT_SIZE];
+};
+
+struct ExpoLut {
+  int8_t k;              // expo weight, 0 when the slot is free
+  uint16_t built;
+  int16_t values[EXPO_LUT_SIZE];
+};
+
+static CurveLut curvesLut[MAX_CURVES_LUT] __SDRAM;
+static ExpoLut exposLut[MAX_EXPOS_LUT] __SDRAM;
+static int8_t curveLutSlot[MAX_CURVES];
+static bool curvesLutDirty = true;
+
+void invalidateCurvesLut()
+{
+  curvesLutDirty = true;
+}
+
+static uint32_t getCurveChecksum(uint8_t idx)
+{
+  CurveInfo & crv = g_model.curves[idx];
+  uint8_t * data = (uint8_t *)curveAddress(idx);
+  uint8_t size = (crv.type == CURVE_TYPE_CUSTOM ? 8+2*crv.points : 5+crv.points);
+  uint32_t result = 2166136261u; // FNV-1a
+  for (uint8_t i=0; i<sizeof(CurveInfo); i++) {
+    result = (result ^ ((uint8_t *)&crv)[i]) * 16777619u;
+  }
+  for (uint8_t i=0; i<size; i++) {
+    result = (result ^ data[i]) * 16777619u;
+  }
+  return result;
+}
+
+static void useCurveRef(CurveRef & curve, bool * used)
+{
+  if (curve.type == CURVE_REF_CUSTOM && curve.value != 0 && abs(curve.value) <= MAX_CURVES) {
+    used[abs(curve.value) - 1] = true;
+  }
+}
+
+static void useExpoLut(int8_t k)
+{
+  if (k == 0) return;
+  for (uint8_t i=0; i<MAX_EXPOS_LUT; i++) {
+    if (exposLut[i].k == k) return;
+  }
+  for (uint8_t i=0; i<MAX_EXPOS_LUT; i++) {
+    if (exposLut[i].k == 0) {
+      exposLut[i].k = k;
+      exposLut[i].built = 0;
+      return;
+    }
+  }
+}
+
+static int8_t getStaticExpo(CurveRef & curve)
+{
+  if (curve.type != CURVE_REF_EXPO || GV_IS_GV_VALUE(curve.value, -100, 100))
+    return 0;
+  return curve.value;
+}
+
+static void allocateCurvesLut()
+{
+  bool used[MAX_CURVES];
+  bool expoUsed[MAX_EXPOS_LUT];
+  memclear(used, sizeof(used));
+  memclear(expoUsed, sizeof(expoUsed));
+
+  for (uint8_t i=0; i<MAX_EXPOS; i++) {
+    ExpoData * ed = expoAddress(i);
+    if (!EXPO_VALID(ed)) break;
+    useCurveRef(ed->curve, used);
+    int8_t k = getStaticExpo(ed->curve);
+    for (uint8_t j=0; j<MAX_EXPOS_LUT; j++) {
+      if (k != 0 && exposLut[j].k == k) expoUsed[j] = true;
+    }
+  }
+  for (uint8_t i=0; i<MAX_MIXERS; i++) {
+    MixData * md = mixAddress(i);
+    if (md->srcRaw == 0) break;
+    useCurveRef(md->curve, used);
+    int8_t k = getStaticExpo(md->curve);
+    for (uint8_t j=0; j<MAX_EXPOS_LUT; j++) {
+      if (k != 0 && exposLut[j].k == k) expoUsed[j] = true;
+    }
+  }
+
+  // expo tables only depend on k, they are kept as long as k is used
+  for (uint8_t i=0; i<MAX_EXPOS_LUT; i++) {
+    if (!expoUsed[i]) exposLut[i].k = 0;
+  }
+  for (uint8_t i=0; i<MAX_EXPOS; i++) {
+    ExpoData * ed = expoAddress(i);
+    if (!EXPO_VALID(ed)) break;
+    useExpoLut(getStaticExpo(ed->curve));
+  }
+  for (uint8_t i=0; i<MAX_MIXERS; i++) {
+    MixData * md = mixAddress(i);
+    if (md->srcRaw == 0) break;
+    useExpoLut(getStaticExpo(md->curve));
+  }
+
+  // curve tables are kept when the curve didn't change
+  for (uint8_t i=0; i<MAX_CURVES_LUT; i++) {
+    CurveLut & lut = curvesLut[i];
+    if (lut.curve > 0 && !used[lut.curve - 1]) {
+      lut.curve = 0;
+    }
+  }
+  for (uint8_t idx=0; idx<MAX_CURVES; idx++) {
+    curveLutSlot[idx] = -1;
+    if (!used[idx]) continue;
+    uint32_t checksum = getCurveChecksum(idx);
+    int8_t slot = -1;
+    for (uint8_t i=0; i<MAX_CURVES_LUT; i++) {
+      if (curvesLut[i].curve == idx + 1) {
+        slot = i;
+        break;
+      }
+    }
+    if (slot < 0) {
+      for (uint8_t i=0; i<MAX_CURVES_LUT; i++) {
+        if (curvesLut[i].curve == 0) {
+          slot = i;
+          curvesLut[i].curve = idx + 1;
+          curvesLut[i].built = 0;
+          break;
+        }
+      }
+    }
+    if (slot < 0) continue; // no more room, this curve will be computed
+    if (curvesLut[slot].checksum != checksum) {
+      curvesLut[slot].checksum = checksum;
+      curvesLut[slot].built = 0;
+    }
+    curveLutSlot[idx] = slot;
+  }
+
+  curvesLutDirty = false;
+}
+
+bool updateCurvesLut()
+{
+  if (curvesLutDirty) {
+    allocateCurvesLut();
+  }
+
+  for (uint8_t i=0; i<MAX_CURVES_LUT; i++) {
+    CurveLut & lut = curvesLut[i];
+    if (lut.curve > 0 && lut.built < CURVE_LUT_SIZE) {
+      uint16_t end = min<uint16_t>(lut.built + LUT_BUILD_STEP, CURVE_LUT_SIZE);
+      for (uint16_t j=lut.built; j<end; j++) {
+        lut.values[j] = applyCustomCurve(j - RESX, lut.curve - 1);
+      }
+      lut.built = end;
+      return false;
+    }
+  }
+
+  for (uint8_t i=0; i<MAX_EXPOS_LUT; i++) {
+    ExpoLut & lut = exposLut[i];
+    if (lut.k != 0 && lut.built < EXPO_LUT_SIZE) {
+      uint16_t end = min<uint16_t>(lut.built + LUT_BUILD_STEP, EXPO_LUT_SIZE);
+      for (uint16_t j=lut.built; j<end; j++) {
+        lut.values[j] = expo(j, lut.k);
+      }
+      lut.built = end;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static inline const int16_t * getCurveLut(uint8_t idx)
+{
+  if (curvesLutDirty || idx >= MAX_CURVES)
+    return NULL;
+  int8_t slot = curveLutSlot[idx];
+  if (slot < 0 || curvesLut[slot].built < CURVE_LUT_SIZE)
+    return NULL;
+  return curvesLut[slot].values;
+}
+
+static inline const int16_t * getExpoLut(int k)
+{
+  if (curvesLutDirty)
+    return NULL;
+  for (uint8_t i=0; i<MAX_EXPOS_LUT; i++) {
+    ExpoLut & lut = exposLut[i];
+    if (lut.k == k)
+      return (lut.built == EXPO_LUT_SIZE ? lut.values : NULL);
+  }
+  return NULL;
+}
+#endif
+
 int applyCurve(int x, CurveRef & curve)
 {
   switch (curve.type) {
@@ -325,6 +543,12 @@ int applyCurve(int x, CurveRef & curve)
     case CURVE_REF_EXPO:
     {
       int curveParam = GET_GVAR_PREC1(curve.value, -100, 100, mixerCurrentFlightMode) / 10;
+#if defined(CURVES_LUT)
+      if (curveParam != 0 && x >= -RESX && x <= RESX) {
+        const int16_t * lut = getExpoLut(curveParam);
+        if (lut) return (x < 0 ? -lut[-x] : lut[x]);
+      }
+#endif
       return expo(x, curveParam);
     }
 
@@ -355,6 +579,10 @@ int applyCurve(int x, CurveRef & curve)
         curveParam = -curveParam;
       }
       if (curveParam > 0 && curveParam <= MAX_CURVES) {
+#if defined(CURVES_LUT)
+        const int16_t * lut = getCurveLut(curveParam - 1);
+        if (lut) return lut[limit<int>(-RESX, x, RESX) + RESX];
+#endif
         return applyCustomCurve(x, curveParam - 1);
       }
       break;
@@ -32,11 +32,17 @@
   #define TRACE_DISK_CACHE(...)
 #endif
 
+#define DISK_CACHE_HASH(sector)   (((sector) / DISK_CACHE_BLOCK_SECTORS) & (DISK_CACHE_HASH_SIZE - 1))
+
 DiskCache diskCache;
 
 DiskCacheBlock::DiskCacheBlock():
   startSector(0),
-  endSector(0) 
+  endSector(0),
+  lastUse(0),
+  readSectors(0),
+  protect(false),
+  hashNext(-1)
 {
 }
 
@@ -50,7 +56,7 @@ bool DiskCacheBlock::read(BYTE * buff, DWORD sector, UINT count)
   return false;
 }
 
-DRESULT DiskCacheBlock::fill(BYTE drv, BYTE * buff, DWORD sector, UINT count)
+DRESULT DiskCacheBlock::fill(BYTE drv, DWORD sector)
 {
   DRESULT res = __disk_read(drv, data, sector, DISK_CACHE_BLOCK_SECTORS);
   if (res != RES_OK) {
@@ -58,22 +64,26 @@ DRESULT DiskCacheBlock::fill(BYTE drv, BYTE * buff, DWORD sector, UINT count)
   }
   startSector = sector;
   endSector = sector + DISK_CACHE_BLOCK_SECTORS;
-  memcpy(buff, data, count * BLOCK_SIZE);
-  TRACE_DISK_CACHE("\tcache %p FILLED from read(%u, %u)", this, (uint32_t)sector, (uint32_t)count);
+  readSectors = 0;
+  TRACE_DISK_CACHE("\tcache %p FILLED from sector %u", this, (uint32_t)sector);
   return RES_OK;
 }
 
-void DiskCacheBlock::free(DWORD sector, UINT count) 
+void DiskCacheBlock::write(const BYTE * buff, DWORD sector, UINT count)
 {
-  if (sector < endSector && (sector+count) > startSector) {
-    TRACE_DISK_CACHE("\tINVALIDATING disk cache block %p (%u)", this, startSector);
-    endSector = 0;
+  DWORD start = max(sector, startSector);
+  DWORD end = min(sector + count, endSector);
+  if (start < end) {
+    TRACE_DISK_CACHE("\tUPDATING disk cache block %p (%u)", this, startSector);
+    memcpy(data + ((start - startSector) * BLOCK_SIZE), buff + ((start - sector) * BLOCK_SIZE), (end - start) * BLOCK_SIZE);
   }
 }
 
 void DiskCacheBlock::free()
 {
   endSector = 0;
+  protect = false;
+  hashNext = -1;
 }
 
 bool DiskCacheBlock::empty() const
@@ -81,84 +91,245 @@ bool DiskCacheBlock::empty() const
   return (endSector == 0);
 }
 
-DiskCache::DiskCache():
-  lastBlock(0)
+DiskCache::DiskCache()
 {
-  stats.noHits = 0;
-  stats.noMisses = 0;
-  stats.noWrites = 0;
   blocks = new DiskCacheBlock[DISK_CACHE_BLOCKS_NUM];
+#if DISK_CACHE_WRITE_SECTORS > 0
+  pendingData = new uint8_t[DISK_CACHE_WRITE_SECTORS * BLOCK_SIZE];
+#endif
+  clear();
 }
 
 void DiskCache::clear()
 {
-  lastBlock = 0;
-  stats.noHits = 0;
-  stats.noMisses = 0;
-  stats.noWrites = 0;
+  memclear(&stats, sizeof(stats));
+  uses = 0;
+  protectedCount = 0;
+  memset(hashTable, -1, sizeof(hashTable));
   for (int n=0; n<DISK_CACHE_BLOCKS_NUM; ++n) {
     blocks[n].free();
   }
+#if DISK_CACHE_WRITE_SECTORS > 0
+  // the pending writes are lost, the card has been removed
+  pendingCount = 0;
+#endif
 }
 
-DRESULT DiskCache::read(BYTE drv, BYTE * buff, DWORD sector, UINT count)
+DiskCacheBlock * DiskCache::find(DWORD sector)
 {
-  // TODO: check if not caching first sectors would improve anything
-  // if (sector < 1000) {
-  //   ++stats.noMisses;
-  //   return __disk_read(drv, buff, sector, count);  
-  // }
+  for (int8_t n = hashTable[DISK_CACHE_HASH(sector)]; n >= 0; n = blocks[n].hashNext) {
+    if (blocks[n].startSector == sector) {
+      return &blocks[n];
+    }
+  }
+  return NULL;
+}
 
-  // if read is bigger than cache block, then read it directly without using cache
-  if (count > DISK_CACHE_BLOCK_SECTORS) {
-    TRACE_DISK_CACHE("\t\t big read(%u, %u)",  (uint32_t)sector, (uint32_t)count);
-    return __disk_read(drv, buff, sector, count);
+void DiskCache::insert(DiskCacheBlock * block)
+{
+  int8_t & head = hashTable[DISK_CACHE_HASH(block->startSector)];
+  block->hashNext = head;
+  head = block - blocks;
+}
+
+void DiskCache::remove(DiskCacheBlock * block)
+{
+  int8_t * n = &hashTable[DISK_CACHE_HASH(block->startSector)];
+  while (*n >= 0) {
+    if (&blocks[*n] == block) {
+      *n = block->hashNext;
+      break;
+    }
+    n = &blocks[*n].hashNext;
   }
-  
-  // if block + cache block size is beyond the end of the disk, then read it directly without using cache
-  if (sector+DISK_CACHE_BLOCK_SECTORS >= sdGetNoSectors()) {
-    TRACE_DISK_CACHE("\t\t cache would be beyond end of disk %u (%u)", (uint32_t)sector, sdGetNoSectors());
-    return __disk_read(drv, buff, sector, count);
+  if (block->protect) {
+    --protectedCount;
   }
+  block->free();
+}
 
-  for (int n=0; n<DISK_CACHE_BLOCKS_NUM; ++n) {
-    if (blocks[n].read(buff, sector, count)) {
-      ++stats.noHits;
-      return RES_OK;
+void DiskCache::invalidate(DWORD sector, UINT count)
+{
+  for (DWORD start = sector - (sector % DISK_CACHE_BLOCK_SECTORS); start < sector + count; start += DISK_CACHE_BLOCK_SECTORS) {
+    DiskCacheBlock * block = find(start);
+    if (block) {
+      TRACE_DISK_CACHE("\tINVALIDATING disk cache block %p (%u)", block, start);
+      remove(block);
+    }
+  }
+}
+
+bool DiskCache::isFatSector(DWORD sector) const
+{
+#if defined(SIMU) && !defined(SIMU_DISKIO)
+  return false;
+#else
+  // the FAT, and the root directory on FAT12/16
+  return g_FATFS_Obj.fs_type && sector >= g_FATFS_Obj.fatbase && sector < g_FATFS_Obj.database;
+#endif
+}
+
+void DiskCache::protect(DiskCacheBlock * block)
+{
+  block->protect = true;
+  if (++protectedCount > DISK_CACHE_PROTECTED_MAX) {
+    // the least recently used protected block goes back with the others
+    DiskCacheBlock * oldest = NULL;
+    for (int n=0; n<DISK_CACHE_BLOCKS_NUM; ++n) {
+      if (blocks[n].protect && (!oldest || blocks[n].lastUse < oldest->lastUse)) {
+        oldest = &blocks[n];
+      }
     }
+    oldest->protect = false;
+    --protectedCount;
   }
+}
 
-  ++stats.noMisses;
+void DiskCache::touch(DiskCacheBlock * block, DWORD sector, UINT count)
+{
+  block->lastUse = ++uses;
+  uint16_t mask = ((1u << count) - 1) << (sector - block->startSector);
+  if (!block->protect && (block->readSectors & mask)) {
+    // these sectors are read again
+    protect(block);
+  }
+  block->readSectors |= mask;
+}
+
+DiskCacheBlock * DiskCache::evict()
+{
+  DiskCacheBlock * result = NULL;
 
-  // find free block
   for (int n=0; n<DISK_CACHE_BLOCKS_NUM; ++n) {
-    if (blocks[n].empty()) {
+    DiskCacheBlock * block = &blocks[n];
+    if (block->empty()) {
       TRACE_DISK_CACHE("\t\t using free block");
-      return blocks[n].fill(drv, buff, sector, count);
+      return block;
+    }
+    if (!block->protect && (!result || block->lastUse < result->lastUse)) {
+      result = block;
     }
   }
 
-  // use next block (round robin)
-  // TODO: use better strategy to select which used block gets used here
-  if (++lastBlock >= DISK_CACHE_BLOCKS_NUM) {
-    lastBlock = 0;
+  ++stats.noEvictions;
+  remove(result);
+  return result;
+}
+
+DRESULT DiskCache::read(BYTE drv, BYTE * buff, DWORD sector, UINT count)
+{
+  // if read is bigger than cache block, or the cache blocks would be beyond
+  // the end of the disk, then read it directly without using cache
+  DWORD end = sector + count + DISK_CACHE_BLOCK_SECTORS - 1;
+  if (count > DISK_CACHE_BLOCK_SECTORS || end - (end % DISK_CACHE_BLOCK_SECTORS) > sdGetNoSectors()) {
+    TRACE_DISK_CACHE("\t\t direct read(%u, %u)",  (uint32_t)sector, (uint32_t)count);
+    DRESULT res = flush(drv);
+    if (res != RES_OK) {
+      return res;
+    }
+    return __disk_read(drv, buff, sector, count);
   }
-  
-  return blocks[lastBlock].fill(drv, buff, sector, count);
+
+  // at most 2 blocks
+  while (count > 0) {
+    DWORD start = sector - (sector % DISK_CACHE_BLOCK_SECTORS);
+    UINT n = min<UINT>(count, start + DISK_CACHE_BLOCK_SECTORS - sector);
+    DiskCacheBlock * block = find(start);
+    if (block) {
+      ++stats.noHits;
+    }
+    else {
+      ++stats.noMisses;
+      DRESULT res = flush(drv);
+      if (res != RES_OK) {
+        return res;
+      }
+      block = evict();
+      res = block->fill(drv, start);
+      if (res != RES_OK) {
+        return res;
+      }
+      insert(block);
+    }
+    touch(block, sector, n);
+    if (!block->protect && isFatSector(start)) {
+      protect(block);
+    }
+    block->read(buff, sector, n);
+    buff += n * BLOCK_SIZE;
+    sector += n;
+    count -= n;
+  }
+
+  return RES_OK;
 }
 
 DRESULT DiskCache::write(BYTE drv, const BYTE* buff, DWORD sector, UINT count)
 {
   ++stats.noWrites;
-  for(int n=0; n < DISK_CACHE_BLOCKS_NUM; ++n) {
-    blocks[n].free(sector, count);
+
+  // write-through, the cached sectors are updated
+  for (DWORD start = sector - (sector % DISK_CACHE_BLOCK_SECTORS); start < sector + count; start += DISK_CACHE_BLOCK_SECTORS) {
+    DiskCacheBlock * block = find(start);
+    if (block) {
+      block->write(buff, sector, count);
+    }
   }
-  return __disk_write(drv, buff, sector, count);  
+
+  DRESULT res;
+
+#if DISK_CACHE_WRITE_SECTORS > 0
+  // the sequential writes are coalesced, until the next sync, read miss or
+  // other write
+  if (count <= DISK_CACHE_WRITE_SECTORS) {
+    if (pendingCount > 0 && (sector < pendingSector || sector > pendingSector + pendingCount || sector + count > pendingSector + DISK_CACHE_WRITE_SECTORS)) {
+      res = flush(drv);
+      if (res != RES_OK) {
+        return res;
+      }
+    }
+    if (pendingCount == 0) {
+      pendingSector = sector;
+    }
+    memcpy(pendingData + (sector - pendingSector) * BLOCK_SIZE, buff, count * BLOCK_SIZE);
+    pendingCount = max<UINT>(pendingCount, sector + count - pendingSector);
+    return RES_OK;
+  }
+
+  res = flush(drv);
+  if (res != RES_OK) {
+    return res;
+  }
+#endif
+
+  ++stats.noDiskWrites;
+  res = __disk_write(drv, buff, sector, count);
+  if (res != RES_OK) {
+    invalidate(sector, count);
+  }
+  return res;
 }
 
-const DiskCacheStats & DiskCache::getStats() const 
-{ 
-  return stats; 
+DRESULT DiskCache::flush(BYTE drv)
+{
+#if DISK_CACHE_WRITE_SECTORS > 0
+  if (pendingCount > 0) {
+    TRACE_DISK_CACHE("\t\t flush(%u, %u)",  (uint32_t)pendingSector, (uint32_t)pendingCount);
+    ++stats.noDiskWrites;
+    DRESULT res = __disk_write(drv, pendingData, pendingSector, pendingCount);
+    if (res != RES_OK) {
+      invalidate(pendingSector, pendingCount);
+    }
+    pendingCount = 0;
+    return res;
+  }
+#endif
+  return RES_OK;
+}
+
+const DiskCacheStats & DiskCache::getStats() const
+{
+  return stats;
 }
 
 int DiskCache::getHitRate() const
@@ -27,16 +27,26 @@
 // tunable parameters
 #define DISK_CACHE_BLOCKS_NUM      32   // no cache blocks
 #define DISK_CACHE_BLOCK_SECTORS   16   // no sectors
+#define DISK_CACHE_HASH_SIZE       64   // no hash buckets, power of 2
+#define DISK_CACHE_PROTECTED_MAX   24   // no blocks kept away from the one-off reads
+#define DISK_CACHE_WRITE_SECTORS   16   // no sectors of the coalesced sequential writes, 0 to disable
 
 #define DISK_CACHE_BLOCK_SIZE   (DISK_CACHE_BLOCK_SECTORS * BLOCK_SIZE)
 
+// The blocks are aligned on DISK_CACHE_BLOCK_SECTORS, and indexed by a hash
+// of their number. The eviction is a segmented LRU: a block goes to the
+// protected segment once some of its sectors are read again (or when it
+// holds the FAT), so the sequential reads of the audio files and the logs
+// only evict each other.
 class DiskCacheBlock
 {
+  friend class DiskCache;
+
 public:
   DiskCacheBlock();
   bool read(BYTE* buff, DWORD sector, UINT count);
-  DRESULT fill(BYTE drv, BYTE* buff, DWORD sector, UINT count);
-  void free(DWORD sector, UINT count);
+  DRESULT fill(BYTE drv, DWORD sector);
+  void write(const BYTE* buff, DWORD sector, UINT count);
   void free();
   bool empty() const;
 
@@ -44,6 +54,10 @@ private:
   uint8_t data[DISK_CACHE_BLOCK_SIZE];
   DWORD startSector;
   DWORD endSector;
+  uint32_t lastUse;
+  uint16_t readSectors;     // mask of the sectors already read
+  bool protect;
+  int8_t hashNext;
 };
 
 struct DiskCacheStats
@@ -51,6 +65,8 @@ struct DiskCacheStats
   uint32_t noHits;
   uint32_t noMisses;
   uint32_t noWrites;
+  uint32_t noEvictions;
+  uint32_t noDiskWrites;    // after the sequential writes coalescing
 };
 
 class DiskCache
@@ -59,14 +75,31 @@ class DiskCache
     DiskCache();
     DRESULT read(BYTE drv, BYTE* buff, DWORD sector, UINT count);
     DRESULT write(BYTE drv, const BYTE* buff, DWORD sector, UINT count);
+    DRESULT flush(BYTE drv);
     const DiskCacheStats & getStats() const;
     int getHitRate() const;
     void clear();
 
   private:
     DiskCacheStats stats;
-    uint32_t lastBlock;
+    uint32_t uses;
+    uint8_t protectedCount;
+    int8_t hashTable[DISK_CACHE_HASH_SIZE];
     DiskCacheBlock * blocks;
+#if DISK_CACHE_WRITE_SECTORS > 0
+    uint8_t * pendingData;
+    DWORD pendingSector;
+    UINT pendingCount;
+#endif
+
+    DiskCacheBlock * find(DWORD block);
+    DiskCacheBlock * evict();
+    void touch(DiskCacheBlock * block, DWORD sector, UINT count);
+    void protect(DiskCacheBlock * block);
+    void insert(DiskCacheBlock * block);
+    void remove(DiskCacheBlock * block);
+    void invalidate(DWORD sector, UINT count);
+    bool isFatSector(DWORD sector) const;
 };
 
 extern DiskCache diskCache;
@@ -68,6 +68,23 @@ class DMAFifo
       }
     }
 
+    // the bytes which can be read in place, up to the end of the ring,
+    // they are removed with skip() once used
+    uint32_t probeSpan(const uint8_t * & span)
+    {
+      span = &fifo[ridx];
+#if defined(SIMU)
+      return 0;
+#endif
+      uint32_t w = N - stream->NDTR;
+      return (w >= ridx ? w : N) - ridx;
+    }
+
+    void skip(uint32_t count)
+    {
+      ridx = (ridx+count) & (N-1);
+    }
+
     uint8_t * buffer()
     {
       return fifo;
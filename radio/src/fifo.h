@@ -21,6 +21,18 @@
 #ifndef _FIFO_H_
 #define _FIFO_H_
 
+// Single producer / single consumer ring: each index is only written by one
+// side (widx by the producer, ridx by the consumer), and published after the
+// elements with a release store, read by the other side with an acquire load
+#if defined(__GNUC__)
+  #define FIFO_LOAD_ACQUIRE(index)          __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+  #define FIFO_STORE_RELEASE(index, value)  __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+#else
+  // MSVC volatile accesses have acquire / release semantics
+  #define FIFO_LOAD_ACQUIRE(index)          (index)
+  #define FIFO_STORE_RELEASE(index, value)  (index) = (value)
+#endif
+
 template <class T, int N>
 class Fifo
 {
@@ -40,25 +52,57 @@ class Fifo
 
     void push(T element)
     {
-      uint32_t next = (widx+1) & (N-1);
-      if (next != ridx) {
-        fifo[widx] = element;
-        widx = next;
+      uint32_t w = widx;
+      uint32_t next = (w+1) & (N-1);
+      if (next != FIFO_LOAD_ACQUIRE(ridx)) {
+        fifo[w] = element;
+        FIFO_STORE_RELEASE(widx, next);
+      }
+    }
+
+    // pushes as many elements as possible, returns their count
+    uint32_t pushMany(const T * elements, uint32_t count)
+    {
+      uint32_t w = widx;
+      uint32_t space = (FIFO_LOAD_ACQUIRE(ridx) - w - 1) & (N-1);
+      if (count > space) {
+        count = space;
       }
+      for (uint32_t i=0; i<count; i++) {
+        fifo[(w+i) & (N-1)] = elements[i];
+      }
+      FIFO_STORE_RELEASE(widx, (w+count) & (N-1));
+      return count;
     }
 
     bool pop(T & element)
     {
-      if (isEmpty()) {
+      uint32_t r = ridx;
+      if (r == FIFO_LOAD_ACQUIRE(widx)) {
         return false;
       }
       else {
-        element = fifo[ridx];
-        ridx = (ridx+1) & (N-1);
+        element = fifo[r];
+        FIFO_STORE_RELEASE(ridx, (r+1) & (N-1));
         return true;
       }
     }
 
+    // the elements which can be read in place, up to the end of the ring,
+    // they are removed with skip() once used
+    uint32_t probeSpan(const T * & span) const
+    {
+      uint32_t r = ridx;
+      uint32_t w = FIFO_LOAD_ACQUIRE(widx);
+      span = &fifo[r];
+      return (w >= r ? w : N) - r;
+    }
+
+    void skip(uint32_t count)
+    {
+      FIFO_STORE_RELEASE(ridx, (ridx+count) & (N-1));
+    }
+
     bool isEmpty() const
     {
       return (ridx == widx);
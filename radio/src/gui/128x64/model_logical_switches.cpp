@@ -175,6 +175,7 @@ void menuModelLogicalSwitchOne(event_t event)
             if (cs->v2 < v2_min || cs->v2 > v2_max) {
               cs->v2 = 0;
               storageDirty(EE_MODEL);
+              invalidateModelPlans();
             }
           }
           else
@@ -249,10 +250,12 @@ void onLogicalSwitchesMenu(const char *result)
   else if (result == STR_PASTE) {
     *cs = clipboard.data.csw;
     storageDirty(EE_MODEL);
+    invalidateModelPlans();
   }
   else if (result == STR_CLEAR) {
     memset(cs, 0, sizeof(LogicalSwitchData));
     storageDirty(EE_MODEL);
+    invalidateModelPlans();
   }
 }
 
@@ -477,6 +477,7 @@ void onSensorMenu(const char * result)
         TelemetryItem & newItem = telemetryItems[newIndex];
         newItem = sourceItem;
         storageDirty(EE_MODEL);
+        invalidateModelPlans();
       }
       else {
         POPUP_WARNING(STR_TELEMETRYFULL);
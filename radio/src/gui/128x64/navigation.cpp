@@ -207,6 +207,8 @@ int checkIncDec(event_t event, int val, int i_min, int i_max, unsigned int i_fla
 
   if (newval != val) {
     storageDirty(i_flags & (EE_GENERAL|EE_MODEL));
+    if (i_flags & EE_MODEL)
+      invalidateModelPlans();
     checkIncDec_Ret = (newval > val ? 1 : -1);
   }
   else {
@@ -402,6 +404,8 @@ int checkIncDec(event_t event, int val, int i_min, int i_max, unsigned int i_fla
     }
     AUDIO_KEY_PRESS();
     storageDirty(i_flags & (EE_GENERAL|EE_MODEL));
+    if (i_flags & EE_MODEL)
+      invalidateModelPlans();
     checkIncDec_Ret = (newval > val ? 1 : -1);
   }
   else {
@@ -65,10 +65,12 @@ void onLogicalSwitchesMenu(const char *result)
   else if (result == STR_PASTE) {
     *cs = clipboard.data.csw;
     storageDirty(EE_MODEL);
+    invalidateModelPlans();
   }
   else if (result == STR_CLEAR) {
     memset(cs, 0, sizeof(LogicalSwitchData));
     storageDirty(EE_MODEL);
+    invalidateModelPlans();
   }
 }
 
@@ -235,6 +237,7 @@ void menuModelLogicalSwitches(event_t event)
               cs->v2 = calcRESXto100(x);
             }
             storageDirty(EE_MODEL);
+            invalidateModelPlans();
           }
           break;
         case LS_FIELD_V3:
@@ -185,6 +185,7 @@ int16_t editGVarFieldValue(coord_t x, coord_t y, int16_t value, int16_t min, int
       value = (GV_IS_GV_VALUE(value, min, max) ? GET_GVAR(value, min, max, mixerCurrentFlightMode) : delta);
     }
     storageDirty(EE_MODEL);
+    invalidateModelPlans();
   }
 
   if (GV_IS_GV_VALUE(value, min, max)) {
@@ -342,6 +342,41 @@ void BitmapBuffer::drawMask(coord_t x, coord_t y, const BitmapBuffer * mask, Lcd
   }
 }
 
+void BitmapBuffer::drawAlphaMask(coord_t x, coord_t y, const uint8_t * mask, coord_t w, coord_t h, uint16_t color)
+{
+  APPLY_OFFSET();
+
+  if (!data || !mask || x >= xmax || y >= ymax)
+    return;
+
+  coord_t srcx = 0, srcy = 0, srcw = w, srch = h;
+
+  if (x < xmin) {
+    w += x-xmin;
+    srcx -= x-xmin;
+    x = xmin;
+  }
+
+  if (y < ymin) {
+    h += y-ymin;
+    srcy -= y-ymin;
+    y = ymin;
+  }
+
+  if (x + w > xmax) {
+    w = xmax - x;
+  }
+
+  if (y + h > ymax) {
+    h = ymax - y;
+  }
+
+  if (w <= 0 || h <= 0)
+    return;
+
+  DMACopyAlphaMask(data, width, height, x, y, mask, srcw, srch, srcx, srcy, w, h, color);
+}
+
 void BitmapBuffer::drawBitmapPattern(coord_t x, coord_t y, const uint8_t * bmp, LcdFlags flags, coord_t offset, coord_t width)
 {
   APPLY_OFFSET();
@@ -414,6 +449,173 @@ uint8_t BitmapBuffer::drawCharWithCache(coord_t x, coord_t y, const BitmapBuffer
     drawBitmap(x, y, font, offset, 0, width);
   return width;
 }
+#if !defined(BOOT)
+TextRunCache textRunCache;
+
+void TextRunCache::clear()
+{
+  for (uint8_t i=0; i<TEXT_RUN_CACHE_ENTRIES; i++) {
+    free(entries[i].mask);
+  }
+  memset(entries, 0, sizeof(entries));
+  memset(missed, 0, sizeof(missed));
+  missedIndex = 0;
+  useCounter = 0;
+  hits = 0;
+  misses = 0;
+  evictions = 0;
+  size = 0;
+}
+
+void TextRunCache::evict(Entry & entry)
+{
+  size -= entry.width * entry.height;
+  free(entry.mask);
+  entry.mask = NULL;
+  evictions++;
+}
+
+// Evicts the least recently used runs until there is a free entry and enough room for the new one
+TextRunCache::Entry * TextRunCache::getFreeEntry(uint32_t bytes)
+{
+  while (true) {
+    Entry * free = NULL;
+    Entry * oldest = NULL;
+    for (uint8_t i=0; i<TEXT_RUN_CACHE_ENTRIES; i++) {
+      Entry & entry = entries[i];
+      if (!entry.mask)
+        free = &entry;
+      else if (!oldest || entry.lastUse < oldest->lastUse)
+        oldest = &entry;
+    }
+    if (free && size + bytes <= TEXT_RUN_CACHE_SIZE)
+      return free;
+    if (!oldest)
+      return NULL;
+    evict(*oldest);
+  }
+}
+
+// Returns true when the string was already missed recently, else remembers it
+bool TextRunCache::missedBefore(uint32_t hash)
+{
+  for (uint8_t i=0; i<TEXT_RUN_CACHE_ENTRIES; i++) {
+    if (missed[i] == hash) {
+      missed[i] = 0;
+      return true;
+    }
+  }
+  missed[missedIndex] = hash;
+  missedIndex = (missedIndex + 1) % TEXT_RUN_CACHE_ENTRIES;
+  return false;
+}
+
+uint8_t * TextRunCache::render(const char * text, uint8_t len, uint8_t fontindex, coord_t & width, coord_t & height)
+{
+  const uint8_t * font = fontsTable[fontindex];
+  const uint16_t * fontspecs = fontspecsTable[fontindex];
+  coord_t fontWidth = *((uint16_t *)font);
+  height = *(((uint16_t *)font)+1);
+
+  width = 0;
+  for (uint8_t i=0; i<len; i++) {
+    width += getCharWidth(text[i], fontspecs);
+  }
+  if (width == 0 || width * height > TEXT_RUN_CACHE_SIZE / 4) {
+    return NULL;
+  }
+
+  uint8_t * mask = (uint8_t *)malloc(width * height);
+  if (!mask) {
+    return NULL;
+  }
+
+  // the font patterns hold 4 bits opacities
+  coord_t x = 0;
+  for (uint8_t i=0; i<len; i++) {
+    uint8_t index = getMappedChar(text[i]);
+    coord_t offset = fontspecs[index];
+    coord_t w = fontspecs[index+1] - offset;
+    for (coord_t row=0; row<height; row++) {
+      const uint8_t * q = font + 4 + row*fontWidth + offset;
+      for (coord_t col=0; col<w; col++) {
+#if defined(PCBX10) && !defined(SIMU)
+        uint8_t * p = &mask[(height-row-1)*width + width-(x+col)-1];
+#else
+        uint8_t * p = &mask[row*width + x+col];
+#endif
+        *p = (q[col] & OPACITY_MAX) * 0x11;
+      }
+    }
+    x += w;
+  }
+
+  return mask;
+}
+
+const uint8_t * TextRunCache::get(const char * text, uint8_t len, uint8_t fontindex, coord_t & width, coord_t & height)
+{
+  uint32_t hash = MathUtil::hash(text, len) ^ (fontindex << 16);
+
+  for (uint8_t i=0; i<TEXT_RUN_CACHE_ENTRIES; i++) {
+    Entry & entry = entries[i];
+    if (entry.mask && entry.hash == hash && entry.len == len && entry.fontindex == fontindex && !memcmp(entry.text, text, len)) {
+      entry.lastUse = ++useCounter;
+      hits++;
+      width = entry.width;
+      height = entry.height;
+      return entry.mask;
+    }
+  }
+
+  misses++;
+  if (!missedBefore(hash)) {
+    return NULL;
+  }
+
+  uint8_t * mask = render(text, len, fontindex, width, height);
+  if (!mask) {
+    return NULL;
+  }
+
+  Entry * entry = getFreeEntry(width * height);
+  if (!entry) {
+    free(mask);
+    return NULL;
+  }
+
+  entry->hash = hash;
+  entry->lastUse = ++useCounter;
+  entry->fontindex = fontindex;
+  entry->len = len;
+  memcpy(entry->text, text, len);
+  entry->width = width;
+  entry->height = height;
+  entry->mask = mask;
+  size += width * height;
+  return mask;
+}
+
+// Returns the length of the string as it is drawn, or -1 when it can't be cached
+static int getTextRun(const char * s, uint8_t len, LcdFlags flags, char * run, int & width)
+{
+  const uint16_t * fontspecs = fontspecsTable[FONTINDEX(flags)];
+  int result = 0;
+  width = 0;
+  while (len--) {
+    unsigned char c = (flags & ZCHAR) ? idx2char(*s) : *s;
+    if (!c)
+      break;
+    if (c < 0x20 || result == TEXT_RUN_MAX_LEN)
+      return -1;
+    run[result++] = c;
+    width += getCharWidth(c, fontspecs);
+    s++;
+  }
+  return result > 0 ? result : -1;
+}
+#endif
+
 void BitmapBuffer::drawSizedText(coord_t x, coord_t y, const char * s, uint8_t len, LcdFlags flags)
 {
   MOVE_OFFSET();
@@ -426,10 +628,21 @@ void BitmapBuffer::drawSizedText(coord_t x, coord_t y, const char * s, uint8_t l
 #define INCREMENT_POS(delta) \
   do { if (flags & VERTICAL) y -= delta; else x += delta; } while(0)
 
-  int width = getTextWidth(s, len, flags);
+  DEBUG_TIMER_START(debugTimerDrawText);
+
+  int width;
+#if !defined(BOOT)
+  char run[TEXT_RUN_MAX_LEN];
+  int runLen = -1;
+  if (textRunCache.enabled && format == BMP_RGB565 && !(flags & VERTICAL))
+    runLen = getTextRun(s, len, flags, run, width);
+  if (runLen < 0)
+#endif
+    width = getTextWidth(s, len, flags);
   int height = getFontHeight(flags);
 
   if (y + height <= ymin || y >= ymax) {
+    DEBUG_TIMER_STOP(debugTimerDrawText);
     RESTORE_OFFSET();
     return;
   }
@@ -482,6 +695,20 @@ void BitmapBuffer::drawSizedText(coord_t x, coord_t y, const char * s, uint8_t l
 
   coord_t & pos = (flags & VERTICAL) ? y : x;
 
+#if !defined(BOOT)
+  if (runLen > 0 && !fontcache) {
+    coord_t w, h;
+    const uint8_t * mask = textRunCache.get(run, runLen, fontindex, w, h);
+    if (mask) {
+      drawAlphaMask(x-1, y, mask, w, h, lcdColorTable[COLOR_IDX(flags)]);
+      lcdNextPos = x + width - offsetX;
+      DEBUG_TIMER_STOP(debugTimerDrawText);
+      RESTORE_OFFSET();
+      return;
+    }
+  }
+#endif
+
   bool setpos = false;
   const coord_t orig_pos = pos;
   while (len--) {
@@ -529,6 +756,7 @@ void BitmapBuffer::drawSizedText(coord_t x, coord_t y, const char * s, uint8_t l
   }
   lcdNextPos = pos - offsetX;
 
+  DEBUG_TIMER_STOP(debugTimerDrawText);
   RESTORE_OFFSET();
 }
 
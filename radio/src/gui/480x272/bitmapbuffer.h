@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "lcd_types.h"
 #include "colors.h"
 #include "board.h"
@@ -306,6 +307,8 @@ class BitmapBuffer: public BitmapBufferBase<uint16_t>
 
     void drawBitmapPattern(coord_t x, coord_t y, const uint8_t * bmp, LcdFlags flags, coord_t offset=0, coord_t width=0);
 
+    void drawAlphaMask(coord_t x, coord_t y, const uint8_t * mask, coord_t w, coord_t h, uint16_t color);
+
     uint8_t drawCharWithoutCache(coord_t x, coord_t y, const uint8_t * font, const uint16_t * spec, int index, LcdFlags flags);
 
     uint8_t drawCharWithCache(coord_t x, coord_t y, const BitmapBuffer * font, const uint16_t * spec, int index, LcdFlags flags);
@@ -433,4 +436,59 @@ class BitmapBuffer: public BitmapBufferBase<uint16_t>
 
 extern BitmapBuffer * lcd;
 
+#if !defined(BOOT)
+#define TEXT_RUN_CACHE_SIZE            (32*1024) // bytes of masks
+#define TEXT_RUN_CACHE_ENTRIES         48
+#define TEXT_RUN_MAX_LEN               32
+
+// The strings already drawn, as 8 bits opacity masks which are then blended
+// in the text color by DMACopyAlphaMask(). A string is only cached the second
+// time it is missed, so that the values which change at each refresh don't
+// evict the labels.
+class TextRunCache
+{
+  public:
+    TextRunCache():
+      enabled(true)
+    {
+      memset(entries, 0, sizeof(entries));
+      clear();
+    }
+
+    const uint8_t * get(const char * text, uint8_t len, uint8_t fontindex, coord_t & width, coord_t & height);
+
+    void clear();
+
+    bool enabled;
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t size;
+
+  protected:
+    struct Entry {
+      uint32_t hash;
+      uint32_t lastUse;
+      uint8_t fontindex;
+      uint8_t len;
+      char text[TEXT_RUN_MAX_LEN];
+      coord_t width;
+      coord_t height;
+      uint8_t * mask;
+    };
+
+    Entry entries[TEXT_RUN_CACHE_ENTRIES];
+    uint32_t missed[TEXT_RUN_CACHE_ENTRIES]; // hashes of the last missed strings
+    uint8_t missedIndex;
+    uint32_t useCounter;
+
+    uint8_t * render(const char * text, uint8_t len, uint8_t fontindex, coord_t & width, coord_t & height);
+    bool missedBefore(uint32_t hash);
+    void evict(Entry & entry);
+    Entry * getFreeEntry(uint32_t bytes);
+};
+
+extern TextRunCache textRunCache;
+#endif
+
 #endif // _BITMAP_BUFFER_H_
@@ -468,6 +468,31 @@ void DMACopyAlphaBitmap(uint16_t * dest, uint16_t destw, uint16_t desth, uint16_
   }
 }
 
+void DMACopyAlphaMask(uint16_t * dest, uint16_t destw, uint16_t desth, uint16_t x, uint16_t y, const uint8_t * src, uint16_t srcw, uint16_t srch, uint16_t srcx, uint16_t srcy, uint16_t w, uint16_t h, uint16_t color)
+{
+#if defined(PCBX10) && !defined(SIMU)
+  x = destw - (x + w);
+  y = desth - (y + h);
+  srcx = srcw - (srcx + w);
+  srcy = srch - (srcy + h);
+#endif
+
+  RGB_SPLIT(color, red, green, blue);
+
+  for (coord_t line=0; line<h; line++) {
+    uint16_t * p = dest + (y+line)*destw + x;
+    const uint8_t * q = src + (srcy+line)*srcw + srcx;
+    for (coord_t col=0; col<w; col++) {
+      uint8_t alpha = *q;
+      uint8_t r = (red * alpha + (*p >> 11) * (0xff-alpha)) / 0xff;
+      uint8_t g = (green * alpha + ((*p >> 5) & 0x3f) * (0xff-alpha)) / 0xff;
+      uint8_t b = (blue * alpha + ((*p >> 0) & 0x1f) * (0xff-alpha)) / 0xff;
+      *p = (r << 11) + (g << 5) + (b << 0);
+      p++; q++;
+    }
+  }
+}
+
 void DMABitmapConvert(uint16_t * dest, const uint8_t * src, uint16_t w, uint16_t h, uint32_t format)
 {
   if (format == DMA2D_ARGB4444) {
@@ -22,7 +22,7 @@
 #include "opentx.h"
 #include "libwindows.h"
 
-#define SET_DIRTY() storageDirty(EE_MODEL)
+#define SET_DIRTY() (storageDirty(EE_MODEL), invalidateModelPlans())
 
 bool isCurveFilled(uint8_t index)
 {
@@ -223,6 +223,7 @@ void ModelCurvesPage::build(Window * window, int8_t focusIndex)
               resetCustomCurveX(points, 5 + curve.points);
             }
             storageDirty(EE_MODEL);
+            invalidateModelPlans();
             rebuild(window, index);
           });
         }
@@ -232,6 +233,7 @@ void ModelCurvesPage::build(Window * window, int8_t focusIndex)
           for (int i = 0; i < 5 + curve.points; i++)
             points[i] = -points[i];
           storageDirty(EE_MODEL);
+          invalidateModelPlans();
           button->invalidate();
         });
         menu->addLine(STR_CLEAR, [=]() {
@@ -240,6 +242,7 @@ void ModelCurvesPage::build(Window * window, int8_t focusIndex)
           if (curve.type == CURVE_TYPE_CUSTOM)
             resetCustomCurveX(points, 5 + curve.points);
           storageDirty(EE_MODEL);
+          invalidateModelPlans();
           rebuild(window, index);
         });
       }
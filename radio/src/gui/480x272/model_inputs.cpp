@@ -22,7 +22,7 @@
 #include "opentx.h"
 #include "libwindows.h"
 
-#define SET_DIRTY() storageDirty(EE_MODEL)
+#define SET_DIRTY() (storageDirty(EE_MODEL), invalidateModelPlans())
 
 #define PASTE_BEFORE    -2
 #define PASTE_AFTER     -1
@@ -74,6 +74,7 @@ void copyExpo(uint8_t source, uint8_t dest, int8_t input)
   }
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 void deleteExpo(uint8_t idx)
@@ -88,6 +89,7 @@ void deleteExpo(uint8_t idx)
   }
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 class InputEditWindow: public Page {
@@ -510,4 +512,5 @@ void insertExpo(uint8_t idx, uint8_t input)
   expo->weight = 100;
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
\ No newline at end of file
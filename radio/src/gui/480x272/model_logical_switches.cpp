@@ -22,7 +22,7 @@
 #include "opentx.h"
 #include "libwindows.h"
 
-#define SET_DIRTY()     storageDirty(EE_MODEL)
+#define SET_DIRTY()     (storageDirty(EE_MODEL), invalidateModelPlans())
 
 void putsEdgeDelayParam(coord_t x, coord_t y, LogicalSwitchData * ls)
 {
@@ -363,12 +363,14 @@ void ModelLogicalSwitchesPage::build(Window * window, int8_t focusIndex)
                                                   menu->addLine(STR_PASTE, [=]() {
                                                     *ls = clipboard.data.csw;
                                                     storageDirty(EE_MODEL);
+                                                    invalidateModelPlans();
                                                     rebuild(window, i);
                                                   });
                                                 if (ls->func || ls->v1 || ls->v2 || ls->delay || ls->duration || ls->andsw)
                                                   menu->addLine(STR_CLEAR, [=]() {
                                                     memset(ls, 0, sizeof(LogicalSwitchData));
                                                     storageDirty(EE_MODEL);
+                                                    invalidateModelPlans();
                                                     rebuild(window, i);
                                                   });
                                                 return 0;
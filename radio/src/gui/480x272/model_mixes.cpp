@@ -22,7 +22,7 @@
 #include "opentx.h"
 #include "libwindows.h"
 
-#define SET_DIRTY()     storageDirty(EE_MODEL)
+#define SET_DIRTY()     (storageDirty(EE_MODEL), invalidateModelPlans())
 
 #define PASTE_BEFORE    -2
 #define PASTE_AFTER     -1
@@ -335,6 +335,7 @@ void insertMix(uint8_t idx, uint8_t channel)
   mix->weight = 100;
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 ModelMixesPage::ModelMixesPage() :
@@ -492,6 +493,7 @@ void deleteMix(uint8_t idx)
   memclear(&g_model.mixData[MAX_MIXERS - 1], sizeof(MixData));
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 void insertMix(uint8_t idx)
@@ -524,6 +526,7 @@ void copyMix(uint8_t source, uint8_t dest, int8_t ch)
   //memmove(mix + 1, mix, (MAX_MIXERS - (dest + 1)) * sizeof(MixData));
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 bool swapMixes(uint8_t &idx, uint8_t up)
@@ -22,7 +22,7 @@
 #include "opentx.h"
 #include "libwindows.h"
 
-#define SET_DIRTY() storageDirty(EE_MODEL)
+#define SET_DIRTY() (storageDirty(EE_MODEL), invalidateModelPlans())
 static constexpr coord_t SENSOR_COL1 = 30;
 static constexpr coord_t SENSOR_COL2 = SENSOR_COL1 + 70;
 static constexpr coord_t SENSOR_COL3 = LCD_W - 50;
@@ -19,6 +19,7 @@
  */
 
 #include "opentx.h"
+#include "mainwindow.h"
 
 unsigned int Topbar::getZonesCount() const
 {
@@ -38,6 +39,9 @@ Zone Topbar::getZone(unsigned int index) const
 
 const char * const STR_MONTHS[] = TR_MONTHS;
 
+//const uint8_t rssiBarsValue[] = {30, 40, 50, 60, 80};
+const uint8_t rssiBarsValue[] = {47, 52, 57, 62, 66};
+
 void drawTopbarDatetime()
 {
   lcd->drawSolidVerticalLine(DATETIME_SEPARATOR_X, 7, 31, TEXT_INVERTED_COLOR);
@@ -62,8 +66,6 @@ void drawTopBar()
   }
 
   // RSSI 50 70
-  //const uint8_t rssiBarsValue[] = {30, 40, 50, 60, 80};
-  const uint8_t rssiBarsValue[] = {47, 52, 57, 62, 66};
   const uint8_t rssiBarsHeight[] = {5, 10, 15, 21, 31};
   for (unsigned int i = 0; i < DIM(rssiBarsHeight); i++) {
     uint8_t height = rssiBarsHeight[i];
@@ -179,3 +181,33 @@ void drawTopBar()
 #endif
 
 }
+
+// Invalidates the parts of the top bar whose content changed since the last cycle
+void checkTopBar()
+{
+  static uint32_t lastDatetime = 0;
+  static uint32_t lastStatus = 0;
+
+  struct gtm t;
+  gettime(&t);
+  uint32_t datetime = getValue(MIXSRC_TX_TIME) + (t.tm_mday << 16) + (t.tm_mon << 24);
+  if (datetime != lastDatetime) {
+    lastDatetime = datetime;
+    mainWindow.invalidate({DATETIME_SEPARATOR_X, 0, LCD_W - DATETIME_SEPARATOR_X, MENU_HEADER_HEIGHT});
+  }
+
+  uint8_t rssiBars = 0;
+  while (rssiBars < DIM(rssiBarsValue) && TELEMETRY_RSSI() >= rssiBarsValue[rssiBars]) {
+    rssiBars++;
+  }
+  uint32_t status = usbPlugged() + (rssiBars << 1) + (g_eeGeneral.beepMode << 4) + (requiredSpeakerVolume << 8) + (g_vbat100mV << 16);
+#if defined(PCBNV14)
+  status += get_battery_charge_state() << 28;
+#endif
+  if (status != lastStatus) {
+    lastStatus = status;
+    mainWindow.invalidate({LCD_W-130, 0, DATETIME_SEPARATOR_X - (LCD_W-130), MENU_HEADER_HEIGHT});
+  }
+
+  topbar->checkEvents();
+}
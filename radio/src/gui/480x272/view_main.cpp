@@ -45,6 +45,23 @@
 Layout * customScreens[MAX_CUSTOM_SCREENS] = { 0, 0, 0, 0, 0 };
 Topbar * topbar;
 
+static const coord_t trimsX[4] = { TRIM_LH_X, TRIM_LV_X, TRIM_RV_X, TRIM_RH_X };
+static const uint8_t trimsVertical[4] = {0, 1, 1, 0};
+
+static bool isTrimValueDisplayed(uint8_t i, int32_t trim)
+{
+  if (g_model.displayTrims != DISPLAY_TRIMS_NEVER && trim != 0) {
+    return g_model.displayTrims == DISPLAY_TRIMS_ALWAYS || (trimsDisplayTimer > 0 && (trimsDisplayMask & (1<<i)));
+  }
+  return false;
+}
+
+// The slider position in pixels, the same way drawHorizontalSlider() / drawVerticalSlider() compute it
+static int getSliderPosition(int len, int val, int min, int max)
+{
+  return divRoundClosest(len * (limit(min, val, max) - min), max - min);
+}
+
 ViewMain::ViewMain():
   Window(&mainWindow, { 0, 0, LCD_W, LCD_H }),
   buttonHeight(NAV_BUTTONS_HEIGHT),
@@ -53,6 +70,9 @@ ViewMain::ViewMain():
   buttonLeftTheme(LCD_W - 50 - buttonHeight/2)
 {
   slideDirection = SlideDirection::None;
+  memset(lastTrims, 0, sizeof(lastTrims));
+  lastPots = 0;
+  lastFlightMode = 0;
 }
 
 ViewMain::~ViewMain()
@@ -81,24 +101,20 @@ void ViewMain::drawMainPots()
 void ViewMain::drawTrims(uint8_t flightMode)
 {
   for (uint8_t i=0; i<4; i++) {
-    static const coord_t x[4] = { TRIM_LH_X, TRIM_LV_X, TRIM_RV_X, TRIM_RH_X };
-    static uint8_t vert[4] = {0, 1, 1, 0};
     unsigned int stickIndex = CONVERT_MODE(i);
-    coord_t xm = x[stickIndex];
+    coord_t xm = trimsX[stickIndex];
     int32_t trim = getTrimValue(flightMode, i);
 
-    if (vert[i]) {
+    if (trimsVertical[i]) {
       if (g_model.extendedTrims == 1) {
         drawVerticalSlider(xm, TRIM_V_Y, 120, trim, TRIM_EXTENDED_MIN, TRIM_EXTENDED_MAX, 0, OPTION_SLIDER_EMPTY_BAR|OPTION_SLIDER_TRIM_BUTTON);
       }
       else {
         drawVerticalSlider(xm, TRIM_V_Y, 120, trim, TRIM_MIN, TRIM_MAX, 0, OPTION_SLIDER_EMPTY_BAR|OPTION_SLIDER_TRIM_BUTTON);
       }
-      if (g_model.displayTrims != DISPLAY_TRIMS_NEVER && trim != 0) {
-        if (g_model.displayTrims == DISPLAY_TRIMS_ALWAYS || (trimsDisplayTimer > 0 && (trimsDisplayMask & (1<<i)))) {
-          uint16_t y = TRIM_V_Y + TRIM_LEN + (trim<0 ? -TRIM_LEN/2 : TRIM_LEN/2);
-          lcdDrawNumber(xm+2, y, trim, TINSIZE | CENTERED | VERTICAL);
-        }
+      if (isTrimValueDisplayed(i, trim)) {
+        uint16_t y = TRIM_V_Y + TRIM_LEN + (trim<0 ? -TRIM_LEN/2 : TRIM_LEN/2);
+        lcdDrawNumber(xm+2, y, trim, TINSIZE | CENTERED | VERTICAL);
       }
     }
     else {
@@ -108,11 +124,9 @@ void ViewMain::drawTrims(uint8_t flightMode)
       else {
         drawHorizontalSlider(xm, TRIM_H_Y, 120, trim, TRIM_MIN, TRIM_MAX, 0, OPTION_SLIDER_EMPTY_BAR|OPTION_SLIDER_TRIM_BUTTON);
       }
-      if (g_model.displayTrims != DISPLAY_TRIMS_NEVER && trim != 0) {
-        if (g_model.displayTrims == DISPLAY_TRIMS_ALWAYS || (trimsDisplayTimer > 0 && (trimsDisplayMask & (1<<i)))) {
-          uint16_t x = xm + TRIM_LEN + (trim>0 ? -TRIM_LEN/2 : TRIM_LEN/2);
-          lcdDrawNumber(x, TRIM_H_Y+2, trim, TINSIZE | CENTERED);
-        }
+      if (isTrimValueDisplayed(i, trim)) {
+        uint16_t x = xm + TRIM_LEN + (trim>0 ? -TRIM_LEN/2 : TRIM_LEN/2);
+        lcdDrawNumber(x, TRIM_H_Y+2, trim, TINSIZE | CENTERED);
       }
     }
   }
@@ -206,10 +220,87 @@ bool ViewMain::onTouchEnd(coord_t x, coord_t y)
 }
 
 
+void ViewMain::checkTrims(uint8_t flightMode)
+{
+  for (uint8_t i=0; i<4; i++) {
+    int32_t trim = getTrimValue(flightMode, i);
+    int32_t state;
+    if (isTrimValueDisplayed(i, trim)) {
+      // the value is written next to the slider
+      state = (trim << 1) + 1;
+    }
+    else if (g_model.extendedTrims == 1) {
+      state = getSliderPosition(120, trim, TRIM_EXTENDED_MIN, TRIM_EXTENDED_MAX) << 1;
+    }
+    else {
+      state = getSliderPosition(120, trim, TRIM_MIN, TRIM_MAX) << 1;
+    }
+
+    if (state != lastTrims[i]) {
+      lastTrims[i] = state;
+      coord_t xm = trimsX[CONVERT_MODE(i)];
+      if (trimsVertical[i])
+        invalidate({xm - 4, TRIM_V_Y - 8, 24, 120 + 16});
+      else
+        invalidate({xm - 8, TRIM_H_Y - 4, 120 + 16, 24});
+    }
+  }
+}
+
+void ViewMain::checkMainPots()
+{
+  const int16_t positions[] = {
+    (int16_t)getSliderPosition(TRIM_WIDTH, calibratedAnalogs[CALIBRATED_POT1], -RESX, RESX),
+#if defined(PCBHORUS)
+    (int16_t)(potsPos[1] & 0x0f),
+    (int16_t)getSliderPosition(TRIM_WIDTH, calibratedAnalogs[CALIBRATED_POT3], -RESX, RESX),
+    (int16_t)getSliderPosition(160, calibratedAnalogs[CALIBRATED_SLIDER_REAR_LEFT], -RESX, RESX),
+    (int16_t)getSliderPosition(160, calibratedAnalogs[CALIBRATED_SLIDER_REAR_RIGHT], -RESX, RESX),
+#else
+    (int16_t)getSliderPosition(TRIM_WIDTH, calibratedAnalogs[CALIBRATED_POT2], -RESX, RESX),
+#endif
+  };
+
+  uint32_t state = MathUtil::hash(positions, sizeof(positions));
+  if (state != lastPots) {
+    lastPots = state;
+    invalidate({0, POTS_LINE_Y - 4, LCD_W, 24});
+#if defined(PCBHORUS)
+    invalidate({0, TRIM_V_Y - 8, 24, 160 + 16});
+    invalidate({LCD_W - 24, TRIM_V_Y - 8, 24, 160 + 16});
+#endif
+  }
+}
+
 void ViewMain::checkEvents()
 {
-  // temporary for refreshing the trims
-  invalidate();
+  Layout * layout = customScreens[currentView()];
+  if (!layout) {
+    return;
+  }
+
+  // each part of the view only invalidates its own area when its content changed
+  if (layout->topBarHeight()) {
+    checkTopBar();
+  }
+
+  if (layout->flightModeHeight()) {
+    uint32_t flightMode = MathUtil::hash(g_model.flightModeData[mixerCurrentFlightMode].name, LEN_FLIGHT_MODE_NAME) + mixerCurrentFlightMode;
+    if (flightMode != lastFlightMode) {
+      lastFlightMode = flightMode;
+      invalidate({0, layout->topBarHeight() + layout->navigationHeight(), LCD_W, layout->flightModeHeight()});
+    }
+  }
+
+  if (layout->trimHeight()) {
+    checkTrims(mixerCurrentFlightMode);
+  }
+
+  if (layout->sliderHeight()) {
+    checkMainPots();
+  }
+
+  layout->checkEvents();
 }
 uint8_t ViewMain::currentView() {
   if (!customScreens[g_model.view]) {
@@ -47,6 +47,8 @@ class ViewMain: public Window {
     void drawMainPots();
     void drawTrims(uint8_t flightMode);
     void drawFlightMode(coord_t y);
+    void checkTrims(uint8_t flightMode);
+    void checkMainPots();
     void showMenu();
 
     const int buttonHeight;
@@ -54,6 +56,9 @@ class ViewMain: public Window {
     const int buttonLeftRadio;
     const int buttonLeftTheme;
     SlideDirection slideDirection;
+    int32_t lastTrims[4];
+    uint32_t lastPots;
+    uint32_t lastFlightMode;
 };
 
 #endif // _VIEW_MAIN_H_
@@ -203,11 +203,13 @@ class DebugBody : public Window {
     DebugBody(Window * parent, const rect_t &rect) :
       Window(parent, rect)
     {
-      setInnerHeight(100); // TODO
+      setInnerHeight(MENU_CONTENT_TOP + getLinesCount() * FH);
     }
 
     void checkEvents() override
     {
+      // the number of Lua scripts lines may change
+      setInnerHeight(MENU_CONTENT_TOP + getLinesCount() * FH);
       // Perma refresh this page
       invalidate();
     }
@@ -253,15 +255,45 @@ class DebugBody : public Window {
       lcdDrawText(lcdNextPos+20, MENU_CONTENT_TOP+line*FH+1, "[B]", HEADER_COLOR|SMLSIZE);
       lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, luaExtraMemoryUsage, LEFT);
       ++line;
+
+      lcdDrawText(MENUS_MARGIN_LEFT, MENU_CONTENT_TOP+line*FH, "Lua GC slice");
+      lcdDrawText(MENU_STATS_COLUMN1, MENU_CONTENT_TOP+line*FH+1, "[S]", HEADER_COLOR|SMLSIZE);
+      lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, luaGcScripts.maxSliceTime, LEFT, 0, NULL, "us");
+      lcdDrawText(lcdNextPos+20, MENU_CONTENT_TOP+line*FH+1, "[W]", HEADER_COLOR|SMLSIZE);
+      lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, luaGcWidgets.maxSliceTime, LEFT, 0, NULL, "us");
+      lcdDrawText(lcdNextPos+20, MENU_CONTENT_TOP+line*FH+1, "[Full]", HEADER_COLOR|SMLSIZE);
+      lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, luaGcScripts.fullCollects + luaGcWidgets.fullCollects, LEFT);
+      ++line;
+
+      for (int i=0; i<luaScriptsCount; i++) {
+        const ScriptInternalData & sid = scriptInternalData[i];
+        lcdDrawText(MENUS_MARGIN_LEFT, MENU_CONTENT_TOP+line*FH, "Lua script");
+        lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, i+1, LEFT);
+        lcdDrawText(MENU_STATS_COLUMN1, MENU_CONTENT_TOP+line*FH+1, "[Alloc]", HEADER_COLOR|SMLSIZE);
+        lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, sid.allocated, LEFT, 0, NULL, "b");
+        lcdDrawText(lcdNextPos+20, MENU_CONTENT_TOP+line*FH+1, "[GC]", HEADER_COLOR|SMLSIZE);
+        lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, sid.gcTime, LEFT, 0, NULL, "us");
+        ++line;
+      }
 #endif
 
       lcdDrawText(MENUS_MARGIN_LEFT, MENU_CONTENT_TOP + line * FH, "Tlm RX Errs");
       lcdDrawNumber(MENU_STATS_COLUMN1, MENU_CONTENT_TOP + line * FH, telemetryErrors, LEFT);
-
-      lcdDrawText(LCD_W / 2, MENU_FOOTER_TOP, STR_MENUTORESET, MENU_TITLE_COLOR | CENTERED);
     }
 
   protected:
+    // the lines drawn by paint()
+    static int getLinesCount()
+    {
+      int count = 6;
+#if defined(DISK_CACHE)
+      count += 1;
+#endif
+#if defined(LUA)
+      count += 4 + luaScriptsCount;
+#endif
+      return count;
+    }
 };
 
 class DebugFooter : public Window {
@@ -273,7 +305,8 @@ class DebugFooter : public Window {
 
     void paint(BitmapBuffer * dc) override
     {
-
+      // not in the body, which scrolls when the Lua statistics don't fit
+      lcdDrawText(LCD_W / 2, (height() - FH) / 2, STR_MENUTORESET, MENU_TITLE_COLOR | CENTERED);
     }
 };
 
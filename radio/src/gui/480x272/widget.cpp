@@ -19,6 +19,7 @@
  */
 
 #include "opentx.h"
+#include "mainwindow.h"
 
 std::list<const WidgetFactory *> & getRegisteredWidgets()
 {
@@ -51,3 +52,8 @@ Widget * loadWidget(const char * name, const Zone & zone, Widget::PersistentData
   }
   return NULL;
 }
+
+void Widget::invalidate()
+{
+  mainWindow.invalidate({zone.x, zone.y, zone.w, zone.h});
+}
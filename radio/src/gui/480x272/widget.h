@@ -39,7 +39,8 @@ class Widget
     Widget(const WidgetFactory * factory, const Zone & zone, PersistentData * persistentData):
       factory(factory),
       zone(zone),
-      persistentData(persistentData)
+      persistentData(persistentData),
+      refreshHash(0)
     {
     }
 
@@ -74,10 +75,27 @@ class Widget
     {
     }
 
+    // Called on each cycle of the main view, invalidates the zone when what the widget displays changed
+    virtual void checkEvents()
+    {
+      invalidate();
+    }
+
+    void invalidate();
+
   protected:
     const WidgetFactory * factory;
     Zone zone;
     PersistentData * persistentData;
+    uint32_t refreshHash;
+
+    void invalidateIfChanged(uint32_t hash)
+    {
+      if (hash != refreshHash) {
+        refreshHash = hash;
+        invalidate();
+      }
+    }
 };
 
 void registerWidget(const WidgetFactory * factory);
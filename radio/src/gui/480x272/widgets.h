@@ -78,5 +78,6 @@ void drawSplash();
 
 // Main view standard widgets
 void drawTopBar();
+void checkTopBar();
 
 #endif // _WIDGETS_H_
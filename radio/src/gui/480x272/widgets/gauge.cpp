@@ -30,6 +30,8 @@ class GaugeWidget: public Widget
 
     virtual void refresh();
 
+    virtual void checkEvents();
+
     static const ZoneOption options[];
 };
 
@@ -41,6 +43,17 @@ const ZoneOption GaugeWidget::options[] = {
   { NULL, ZoneOption::Bool }
 };
 
+void GaugeWidget::checkEvents()
+{
+  mixsrc_t index = persistentData->options[0].unsignedValue;
+  int32_t min = persistentData->options[1].signedValue;
+  int32_t max = persistentData->options[2].signedValue;
+  int32_t value = limit<int32_t>(min, getValue(index), max);
+
+  // the gauge shows a percentage, smaller moves of the source don't change it
+  invalidateIfChanged(MathUtil::hash(persistentData, sizeof(*persistentData)) + divRoundClosest(1000 * (value - min), (max - min)));
+}
+
 void GaugeWidget::refresh()
 {
   mixsrc_t index = persistentData->options[0].unsignedValue;
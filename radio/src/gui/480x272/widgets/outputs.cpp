@@ -35,6 +35,11 @@ class OutputsWidget: public Widget
 
     virtual void refresh();
 
+    virtual void checkEvents()
+    {
+      invalidateIfChanged(MathUtil::hash(persistentData, sizeof(*persistentData)) + MathUtil::hash(channelOutputs, sizeof(channelOutputs)));
+    }
+
     uint8_t drawChannels(const uint16_t & x, const uint16_t & y, const uint16_t & w, const uint16_t & h, const uint8_t & firstChan, const bool & bg_shown, const uint16_t & bg_color)
     {
       const uint8_t numChan = h / ROW_HEIGHT;
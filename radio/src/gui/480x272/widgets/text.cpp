@@ -32,6 +32,11 @@ class TextWidget: public Widget
 
     virtual void refresh();
 
+    virtual void checkEvents()
+    {
+      invalidateIfChanged(MathUtil::hash(persistentData, sizeof(*persistentData)));
+    }
+
     static const ZoneOption options[];
 };
 
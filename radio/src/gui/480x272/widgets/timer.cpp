@@ -30,6 +30,8 @@ class TimerWidget: public Widget
 
     virtual void refresh();
 
+    virtual void checkEvents();
+
     static const ZoneOption options[];
 };
 
@@ -38,6 +40,12 @@ const ZoneOption TimerWidget::options[] = {
   { NULL, ZoneOption::Bool }
 };
 
+void TimerWidget::checkEvents()
+{
+  uint32_t index = persistentData->options[0].unsignedValue;
+  invalidateIfChanged(MathUtil::hash(&g_model.timers[index], sizeof(TimerData)) + timersStates[index].val);
+}
+
 void TimerWidget::refresh()
 {
   uint32_t index = persistentData->options[0].unsignedValue;
@@ -30,6 +30,8 @@ class ValueWidget: public Widget
 
     virtual void refresh();
 
+    virtual void checkEvents();
+
     static const ZoneOption options[];
 };
 
@@ -40,6 +42,20 @@ const ZoneOption ValueWidget::options[] = {
   { NULL, ZoneOption::Bool }
 };
 
+void ValueWidget::checkEvents()
+{
+  mixsrc_t field = persistentData->options[0].unsignedValue;
+  uint32_t hash = MathUtil::hash(persistentData, sizeof(*persistentData)) + getValue(field);
+
+  if (field >= MIXSRC_FIRST_TELEM) {
+    TelemetryItem & telemetryItem = telemetryItems[(field-MIXSRC_FIRST_TELEM)/3];
+    // the color changes when the value gets old
+    hash += (telemetryItem.isAvailable() << 30) + (telemetryItem.isOld() << 31);
+  }
+
+  invalidateIfChanged(hash);
+}
+
 void ValueWidget::refresh()
 {
   const int NUMBERS_PADDING = 4;
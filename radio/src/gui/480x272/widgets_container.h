@@ -138,6 +138,17 @@ class WidgetsContainer: public WidgetsContainerInterface
       }
     }
 
+    virtual void checkEvents()
+    {
+      if (widgets) {
+        for (int i=0; i<N; i++) {
+          if (widgets[i]) {
+            widgets[i]->checkEvents();
+          }
+        }
+      }
+    }
+
     virtual void background()
     {
       if (widgets) {
@@ -61,6 +61,7 @@ void insertExpo(uint8_t idx)
   expo->weight = 100;
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 void copyExpo(uint8_t idx)
@@ -70,6 +71,7 @@ void copyExpo(uint8_t idx)
   memmove(expo+1, expo, (MAX_EXPOS-(idx+1))*sizeof(ExpoData));
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 bool swapExpos(uint8_t & idx, uint8_t up)
@@ -126,6 +128,7 @@ void deleteExpo(uint8_t idx)
   }
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 void onExposMenu(const char * result)
@@ -261,6 +264,7 @@ void menuModelExposAll(event_t event)
               s_copyTgtOfs += (s_copyTgtOfs < 0 ? +1 : -1);
             } while (s_copyTgtOfs != 0);
             storageDirty(EE_MODEL);
+            invalidateModelPlans();
           }
           menuVerticalPosition = s_copySrcRow;
           s_copyTgtOfs = 0;
@@ -355,6 +359,7 @@ void menuModelExposAll(event_t event)
           if (!swapExpos(s_currIdx, IS_PREVIOUS_EVENT(event)))
             break;
           storageDirty(EE_MODEL);
+          invalidateModelPlans();
         }
         
         s_copyTgtOfs = next_ofs;
@@ -54,6 +54,7 @@ void deleteMix(uint8_t idx)
   memclear(&g_model.mixData[MAX_MIXERS-1], sizeof(MixData));
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 void insertMix(uint8_t idx)
@@ -73,6 +74,7 @@ void insertMix(uint8_t idx)
   mix->weight = 100;
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 void copyMix(uint8_t idx)
@@ -82,6 +84,7 @@ void copyMix(uint8_t idx)
   memmove(mix+1, mix, (MAX_MIXERS-(idx+1))*sizeof(MixData));
   resumeMixerCalculations();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 bool swapMixes(uint8_t & idx, uint8_t up)
@@ -284,6 +287,7 @@ void menuModelMixAll(event_t event)
               s_copyTgtOfs += (s_copyTgtOfs < 0 ? +1 : -1);
             } while (s_copyTgtOfs != 0);
             storageDirty(EE_MODEL);
+            invalidateModelPlans();
           }
           menuVerticalPosition = s_copySrcRow + HEADER_LINE;
           s_copyTgtOfs = 0;
@@ -378,6 +382,7 @@ void menuModelMixAll(event_t event)
           // only swap the mix with its neighbor
           if (!swapMixes(s_currIdx, IS_PREVIOUS_EVENT(event))) break;
           storageDirty(EE_MODEL);
+          invalidateModelPlans();
         }
 
         s_copyTgtOfs = next_ofs;
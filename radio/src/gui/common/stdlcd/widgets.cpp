@@ -55,6 +55,7 @@ FlightModesType editFlightModes(coord_t x, coord_t y, event_t event, FlightModes
       s_editMode = 0;
       value ^= (1<<posHorz);
       storageDirty(EE_MODEL);
+      invalidateModelPlans();
     }
   }
   
@@ -79,6 +79,7 @@ bool CurveEdit::onTouchEnd(coord_t x, coord_t y)
     int8_t & point = curveAddress(index)[current];
     point = min<int8_t>(100, ++point);
     storageDirty(EE_MODEL);
+    invalidateModelPlans();
     coord_t c = rect.h/2;
     if(y>c){ //negative part
       y -= c;
@@ -118,6 +119,7 @@ void CurveEdit::up()
   int8_t & point = curveAddress(index)[current];
   point = min<int8_t>(100, ++point);
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
   invalidate();
 }
 
@@ -126,6 +128,7 @@ void CurveEdit::down()
   int8_t & point = curveAddress(index)[current];
   point = max<int8_t>(-100, --point);
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
   invalidate();
 }
 
@@ -138,6 +141,7 @@ void CurveEdit::right()
     int8_t xmax = (current == (curve.points - 2) ? +100 : *(point + 1));
     *point = min<int8_t>(*point + 1, xmax-1);
     storageDirty(EE_MODEL);
+    invalidateModelPlans();
     invalidate();
   }
 }
@@ -151,6 +155,7 @@ void CurveEdit::left()
     int8_t xmin = (current == 1 ? -100 : *(point - 1));
     *point = max<int8_t>(xmin+1, *point - 1);
     storageDirty(EE_MODEL);
+    invalidateModelPlans();
     invalidate();
   }
 }
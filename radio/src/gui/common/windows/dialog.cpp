@@ -136,6 +136,12 @@ void Dialog::runForever()
 
     RTOS_WAIT_MS(20);
     mainWindow.run();
+
+#if defined(SIMU)
+    // the headless runner has nobody to close the dialog, it is only drawn once
+    if (simuVirtualClock)
+      break;
+#endif
   }
 
   Window::deleteLater();
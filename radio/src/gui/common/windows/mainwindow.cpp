@@ -103,42 +103,110 @@ void MainWindow::checkEvents()
   emptyTrash();
 }
 
-void MainWindow::invalidate(const rect_t & rect)
+static inline uint32_t rectArea(const rect_t & rect)
 {
-  if (invalidatedRect.w) {
-    coord_t left = min(invalidatedRect.left(), rect.left());
-    coord_t right = max(invalidatedRect.right(), rect.right());
-    coord_t top = min(invalidatedRect.top(), rect.top());
-    coord_t bottom = max(invalidatedRect.bottom(), rect.bottom());
-    invalidatedRect = {left, top, right - left, bottom - top};
-  }
-  else {
-    invalidatedRect = rect;
-  }
+  return rect.w * rect.h;
 }
 
-bool MainWindow::refresh()
+static inline rect_t rectUnion(const rect_t & a, const rect_t & b)
+{
+  coord_t left = min(a.left(), b.left());
+  coord_t right = max(a.right(), b.right());
+  coord_t top = min(a.top(), b.top());
+  coord_t bottom = max(a.bottom(), b.bottom());
+  return {left, top, right - left, bottom - top};
+}
+
+static inline bool rectIntersects(const rect_t & a, const rect_t & b)
+{
+  return a.left() < b.right() && b.left() < a.right() && a.top() < b.bottom() && b.top() < a.bottom();
+}
+
+// Two rects are merged when they overlap, or when the union doesn't repaint
+// much more than the two of them (each rect costs a full windows tree walk)
+static inline bool rectsShouldMerge(const rect_t & a, const rect_t & b)
+{
+  if (rectIntersects(a, b))
+    return true;
+  uint32_t areas = rectArea(a) + rectArea(b);
+  return rectArea(rectUnion(a, b)) <= areas + areas / 2;
+}
+
+void MainWindow::addInvalidatedRect(rect_t rect)
 {
-  if (invalidatedRect.w) {
-    if (invalidatedRect.x > 0 || invalidatedRect.y > 0 || invalidatedRect.w < LCD_W || invalidatedRect.h < LCD_H) {
-      //TRACE("Refresh rect: left=%d top=%d width=%d height=%d", invalidatedRect.left(), invalidatedRect.top(), invalidatedRect.w, invalidatedRect.h);
-      BitmapBuffer * previous = lcd;
-      lcdNextLayer();
-      DMACopy(previous->getData(), lcd->getData(), DISPLAY_BUFFER_SIZE);
+  // merging may make the rect overlap other ones, so we restart each time
+  uint8_t i = 0;
+  while (i < invalidatedRectsCount) {
+    if (rectsShouldMerge(invalidatedRects[i], rect)) {
+      rect = rectUnion(invalidatedRects[i], rect);
+      invalidatedRects[i] = invalidatedRects[--invalidatedRectsCount];
+      i = 0;
     }
     else {
-      //TRACE("Refresh full screen");
-      lcdNextLayer();
+      i++;
     }
-    lcd->setOffset(0, 0);
-    lcd->setClippingRect(invalidatedRect.left(), invalidatedRect.right(), invalidatedRect.top(), invalidatedRect.bottom());
-    fullPaint(lcd);
-    invalidatedRect.w = 0;
-    return true;
   }
-  else {
+
+  if (invalidatedRectsCount == MAX_INVALIDATED_RECTS) {
+    // no room left, the rect goes in the one which grows the least
+    uint8_t best = 0;
+    uint32_t bestGrowth = UINT32_MAX;
+    for (i = 0; i < invalidatedRectsCount; i++) {
+      uint32_t growth = rectArea(rectUnion(invalidatedRects[i], rect)) - rectArea(invalidatedRects[i]);
+      if (growth < bestGrowth) {
+        best = i;
+        bestGrowth = growth;
+      }
+    }
+    rect = rectUnion(invalidatedRects[best], rect);
+    invalidatedRects[best] = invalidatedRects[--invalidatedRectsCount];
+    addInvalidatedRect(rect);
+    return;
+  }
+
+  invalidatedRects[invalidatedRectsCount++] = rect;
+}
+
+void MainWindow::invalidate(const rect_t & rect)
+{
+  coord_t left = max<coord_t>(0, rect.left());
+  coord_t right = min<coord_t>(LCD_W, rect.right());
+  coord_t top = max<coord_t>(0, rect.top());
+  coord_t bottom = min<coord_t>(LCD_H, rect.bottom());
+  if (left < right && top < bottom) {
+    addInvalidatedRect({left, top, right - left, bottom - top});
+  }
+}
+
+void MainWindow::paintRect(const rect_t & rect)
+{
+  //TRACE("Refresh rect: left=%d top=%d width=%d height=%d", rect.left(), rect.top(), rect.w, rect.h);
+  lcd->setOffset(0, 0);
+  lcd->setClippingRect(rect.left(), rect.right(), rect.top(), rect.bottom());
+  fullPaint(lcd);
+}
+
+bool MainWindow::refresh()
+{
+  if (invalidatedRectsCount == 0) {
     return false;
   }
+
+  if (invalidatedRectsCount > 1 || invalidatedRects[0].x > 0 || invalidatedRects[0].y > 0 || invalidatedRects[0].w < LCD_W || invalidatedRects[0].h < LCD_H) {
+    BitmapBuffer * previous = lcd;
+    lcdNextLayer();
+    DMACopy(previous->getData(), lcd->getData(), DISPLAY_BUFFER_SIZE);
+  }
+  else {
+    //TRACE("Refresh full screen");
+    lcdNextLayer();
+  }
+
+  for (uint8_t i = 0; i < invalidatedRectsCount; i++) {
+    paintRect(invalidatedRects[i]);
+  }
+  invalidatedRectsCount = 0;
+  return true;
 }
 
 void MainWindow::run()
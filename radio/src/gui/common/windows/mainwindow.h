@@ -25,12 +25,16 @@
 
 #include "window.h"
 
+// The damaged areas are kept as a few disjoint rects, each one repainted on its own
+#define MAX_INVALIDATED_RECTS          8
+
 class MainWindow: public Window {
   public:
     MainWindow():
       Window(nullptr, {0, 0, LCD_W, LCD_H}),
-      invalidatedRect(rect)
+      invalidatedRectsCount(1)
     {
+      invalidatedRects[0] = rect;
     }
 
 #if defined(DEBUG_WINDOWS)
@@ -55,7 +59,10 @@ class MainWindow: public Window {
 
   protected:
     void emptyTrash();
-    rect_t invalidatedRect;
+    void addInvalidatedRect(rect_t rect);
+    void paintRect(const rect_t & rect);
+    rect_t invalidatedRects[MAX_INVALIDATED_RECTS];
+    uint8_t invalidatedRectsCount;
 };
 
 extern MainWindow mainWindow;
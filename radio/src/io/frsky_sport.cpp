@@ -155,7 +155,7 @@ void sportWritePacket(uint8_t * packet)
   uint8_t * ptr = outputTelemetryBuffer;
   *ptr++ = 0x7E;
   *ptr++ = 0xFF;
-  packet[7] = crc16(packet, 7);
+  packet[7] = crc16(CRC_1021, packet, 7);
   for (int i=0; i<8; i++) {
     if (packet[i] == 0x7E || packet[i] == 0x7D) {
       *ptr++ = 0x7D;
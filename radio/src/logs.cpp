@@ -26,6 +26,137 @@ const pm_char * g_logError = NULL;
 uint8_t logDelay;
 
 void writeHeader();
+void writeBinaryHeader();
+
+#if defined(LOGS_BINARY)
+// Binary logs: fixed size records are encoded by logsWrite() into a RAM ring
+// buffer, which is written to the SD card in LOGS_BLOCK_SIZE blocks by the
+// low priority logs task. Each logging session starts with a schema header:
+//   LogsBinaryHeader, fieldsCount field types, the CSV header line ('\n'
+//   terminated), then zero padding up to the next block.
+// Records are LOGS_RECORD_MARKER followed by the fields, little endian.
+// util/logs2csv.py converts these files to the CSV layout.
+#define LOGS_BLOCK_SIZE        512
+#define LOGS_BUFFER_SIZE       (8*LOGS_BLOCK_SIZE)
+#define LOGS_BINARY_VERSION    1
+#define LOGS_RECORD_MARKER     'R'
+#define LOGS_MAX_FIELDS        (2+MAX_TELEMETRY_SENSORS+NUM_STICKS+NUM_POTS+NUM_SLIDERS+NUM_SWITCHES+2)
+#define LOGS_MAX_RECORD_SIZE   (1+8+8*MAX_TELEMETRY_SENSORS+2*(NUM_STICKS+NUM_POTS+NUM_SLIDERS)+NUM_SWITCHES+8+4)
+
+enum LogsFieldType {
+  LOGS_FIELD_NONE,
+  LOGS_FIELD_TIME,              // uint32_t 10ms ticks
+  LOGS_FIELD_DATETIME,          // uint16_t year, uint8_t month, day, hour, min, sec, 100ms (2 columns)
+  LOGS_FIELD_VALUE,             // int32_t
+  LOGS_FIELD_VALUE_PREC1,       // int32_t
+  LOGS_FIELD_VALUE_PREC2,       // int32_t
+  LOGS_FIELD_GPS,               // int32_t latitude, int32_t longitude
+  LOGS_FIELD_SENSOR_DATETIME,   // uint16_t year, uint8_t month, day, hour, min, sec
+  LOGS_FIELD_ANALOG,            // int16_t
+  LOGS_FIELD_SWITCH,            // int8_t
+  LOGS_FIELD_LOGICAL_SWITCHES,  // uint32_t LS33-LS64, uint32_t LS1-LS32
+  LOGS_FIELD_COUNT
+};
+
+static const uint8_t logsFieldSize[LOGS_FIELD_COUNT] = { 0, 4, 8, 4, 4, 4, 8, 7, 2, 1, 8 };
+
+PACK(struct LogsBinaryHeader {
+  char magic[4];                // "OTXL"
+  uint8_t version;
+  uint8_t fieldsCount;
+  uint16_t recordSize;
+});
+
+static uint8_t logsBuffer[LOGS_BUFFER_SIZE] __DMA;
+static volatile uint32_t logsBufferWrite = 0;  // free running, written by logsWrite()
+static volatile uint32_t logsBufferRead = 0;   // free running, written by the logs task
+static uint8_t logsFields[LOGS_MAX_FIELDS];
+static uint8_t logsFieldsCount;
+static uint16_t logsRecordSize;
+static uint8_t logsRecord[LOGS_MAX_RECORD_SIZE];
+static bool logsWriteError = false;
+uint32_t logsDroppedRecords = 0;
+RTOS_MUTEX_HANDLE logsMutex;
+
+static uint32_t logsBufferFree()
+{
+  return LOGS_BUFFER_SIZE - (logsBufferWrite - logsBufferRead);
+}
+
+static void logsBufferPush(const void * data, uint32_t size)
+{
+  uint32_t pos = logsBufferWrite % LOGS_BUFFER_SIZE;
+  uint32_t len = min<uint32_t>(size, LOGS_BUFFER_SIZE - pos);
+  memcpy(&logsBuffer[pos], data, len);
+  memcpy(logsBuffer, (const uint8_t *)data + len, size - len);
+  logsBufferWrite += size;
+}
+
+static void logsBufferPad()
+{
+  // the records never start with a 0, the converter skips the padding
+  uint32_t size = (LOGS_BLOCK_SIZE - (logsBufferWrite % LOGS_BLOCK_SIZE)) % LOGS_BLOCK_SIZE;
+  memclear(&logsBuffer[logsBufferWrite % LOGS_BUFFER_SIZE], size);
+  logsBufferWrite += size;
+}
+
+static void logsBufferReset()
+{
+  logsBufferRead = logsBufferWrite = 0;
+  logsWriteError = false;
+}
+
+// called with logsMutex locked
+static void logsFlushBlocks(bool all)
+{
+  if (all) {
+    logsBufferPad();
+  }
+  while (!logsWriteError && logsBufferWrite - logsBufferRead >= LOGS_BLOCK_SIZE) {
+    UINT written;
+    FRESULT result = f_write(&g_oLogFile, &logsBuffer[logsBufferRead % LOGS_BUFFER_SIZE], LOGS_BLOCK_SIZE, &written);
+    if (result != FR_OK || written != LOGS_BLOCK_SIZE) {
+      TRACE("logs write error %d", result);
+      logsWriteError = true;
+    }
+    logsBufferRead += LOGS_BLOCK_SIZE;
+  }
+}
+
+void logsFlush()
+{
+  RTOS_LOCK_MUTEX(logsMutex);
+  if (g_oLogFile.obj.fs) {
+    logsFlushBlocks(false);
+  }
+  RTOS_UNLOCK_MUTEX(logsMutex);
+}
+
+TASK_FUNCTION(logsTask)
+{
+  while (1) {
+#if defined(SIMU)
+    if (main_thread_running == 0)
+      TASK_RETURN();
+#endif
+    logsFlush();
+    CoTickDelay(LOGS_TASK_PERIOD_TICKS);
+  }
+}
+
+static void logsPuts(const char * s)
+{
+  logsBufferPush(s, strlen(s));
+}
+
+static void logsPutc(char c)
+{
+  logsBufferPush(&c, 1);
+}
+#else
+#define logsPuts(s)   f_puts(s, &g_oLogFile)
+#define logsPutc(c)   f_putc(c, &g_oLogFile)
+#endif
 
 #if defined(PCBTARANIS) || defined(PCBHORUS)  || defined(PCBI8) || defined(PCBNV14)
   #define GET_2POS_STATE(sw) (switchState(SW_ ## sw ## 0) ? -1 : 1)
@@ -39,6 +170,9 @@ void writeHeader();
 void logsInit()
 {
   memset(&g_oLogFile, 0, sizeof(g_oLogFile));
+#if defined(LOGS_BINARY)
+  logsBufferReset();
+#endif
 }
 
 const pm_char * logsOpen()
@@ -97,16 +231,32 @@ const pm_char * logsOpen()
   tmp = strAppendDate(&filename[len]);
 #endif
 
+#if defined(LOGS_BINARY)
+  strcpy(tmp, LOGS_BINARY_EXT);
+#else
   strcpy_P(tmp, STR_LOGS_EXT);
+#endif
 
   result = f_open(&g_oLogFile, filename, FA_OPEN_ALWAYS | FA_WRITE | FA_OPEN_APPEND);
   if (result != FR_OK) {
     return SDCARD_ERROR(result);
   }
 
+#if defined(LOGS_BINARY)
+  // each session starts with its own header, on a block boundary
+  logsBufferReset();
+  uint32_t size = (LOGS_BLOCK_SIZE - (f_size(&g_oLogFile) % LOGS_BLOCK_SIZE)) % LOGS_BLOCK_SIZE;
+  if (size > 0) {
+    UINT written;
+    memclear(logsBuffer, size);
+    f_write(&g_oLogFile, logsBuffer, size, &written);
+  }
+  writeBinaryHeader();
+#else
   if (f_size(&g_oLogFile) == 0) {
     writeHeader();
   }
+#endif
 
   return NULL;
 }
@@ -116,10 +266,20 @@ tmr10ms_t lastLogTime = 0;
 void logsClose()
 {
   if (sdMounted()) {
+#if defined(LOGS_BINARY)
+    RTOS_LOCK_MUTEX(logsMutex);
+    if (g_oLogFile.obj.fs) {
+      logsFlushBlocks(true);
+    }
+#endif
     if (f_close(&g_oLogFile) != FR_OK) {
       // close failed, forget file
       g_oLogFile.obj.fs = 0;
     }
+#if defined(LOGS_BINARY)
+    logsBufferReset();
+    RTOS_UNLOCK_MUTEX(logsMutex);
+#endif
     lastLogTime = 0;
   }
 }
@@ -135,24 +295,24 @@ getvalue_t getConvertedTelemetryValue(getvalue_t val, uint8_t unit)
 void writeHeader()
 {
 #if defined(RTCLOCK)
-  f_puts("Date,Time,", &g_oLogFile);
+  logsPuts("Date,Time,");
 #else
-  f_puts("Time,", &g_oLogFile);
+  logsPuts("Time,");
 #endif
 
 #if defined(TELEMETRY_FRSKY)
 #if !defined(CPUARM)
-  f_puts("Buffer,RX,TX,A1,A2,", &g_oLogFile);
+  logsPuts("Buffer,RX,TX,A1,A2,");
 #if defined(FRSKY_HUB)
   if (IS_USR_PROTO_FRSKY_HUB()) {
-    f_puts("GPS Date,GPS Time,Long,Lat,Course,GPS Speed(kts),GPS Alt,Baro Alt(", &g_oLogFile);
-    f_puts(TELEMETRY_BARO_ALT_UNIT, &g_oLogFile);
-    f_puts("),Vertical Speed,Air Speed(kts),Temp1,Temp2,RPM,Fuel," TELEMETRY_CELLS_LABEL "Current,Consumption,Vfas,AccelX,AccelY,AccelZ,", &g_oLogFile);
+    logsPuts("GPS Date,GPS Time,Long,Lat,Course,GPS Speed(kts),GPS Alt,Baro Alt(");
+    logsPuts(TELEMETRY_BARO_ALT_UNIT);
+    logsPuts("),Vertical Speed,Air Speed(kts),Temp1,Temp2,RPM,Fuel," TELEMETRY_CELLS_LABEL "Current,Consumption,Vfas,AccelX,AccelY,AccelZ,");
   }
 #endif
 #if defined(WS_HOW_HIGH)
   if (IS_USR_PROTO_WS_HOW_HIGH()) {
-    f_puts("WSHH Alt,", &g_oLogFile);
+    logsPuts("WSHH Alt,");
   }
 #endif
 #endif
@@ -173,7 +333,7 @@ void writeHeader()
           strcat(label, ")");
         }
         strcat(label, ",");
-        f_puts(label, &g_oLogFile);
+        logsPuts(label);
       }
     }
   }
@@ -185,10 +345,10 @@ void writeHeader()
     const char * p = STR_VSRCRAW + i * STR_VSRCRAW[0] + 2;
     for (uint8_t j=0; j<STR_VSRCRAW[0]-1; ++j) {
       if (!*p) break;
-      f_putc(*p, &g_oLogFile);
+      logsPutc(*p);
       ++p;
     }
-    f_putc(',', &g_oLogFile);
+    logsPutc(',');
   }
 #if defined(PCBX7) || defined(PCBI8) || defined(PCBNV14)
   #define STR_SWITCHES_LOG_HEADER  "SA,SB,SC,SD,SF,SH"
@@ -197,12 +357,12 @@ void writeHeader()
 #else
   #define STR_SWITCHES_LOG_HEADER  "SA,SB,SC,SD,SE,SF,SG,SH"
 #endif
-  f_puts(STR_SWITCHES_LOG_HEADER ",LSW,", &g_oLogFile);
+  logsPuts(STR_SWITCHES_LOG_HEADER ",LSW,");
 #else
-  f_puts("Rud,Ele,Thr,Ail,P1,P2,P3,THR,RUD,ELE,3POS,AIL,GEA,TRN,", &g_oLogFile);
+  logsPuts("Rud,Ele,Thr,Ail,P1,P2,P3,THR,RUD,ELE,3POS,AIL,GEA,TRN,");
 #endif
 
-  f_puts("TxBat(V)\n", &g_oLogFile);
+  logsPuts("TxBat(V)\n");
 }
 
 uint32_t getLogicalSwitchesStates(uint8_t first)
@@ -214,6 +374,219 @@ uint32_t getLogicalSwitchesStates(uint8_t first)
   return result;
 }
 
+#if defined(LOGS_BINARY)
+// states is NULL to get the number of switches logged
+uint8_t getLogsSwitchesStates(int8_t * states)
+{
+  int8_t result[NUM_SWITCHES];
+  uint8_t count = 0;
+
+  // TODO: use hardware config to populate
+#if defined(PCBXLITE)
+  result[count++] = GET_3POS_STATE(SA);
+  result[count++] = GET_3POS_STATE(SB);
+  result[count++] = GET_3POS_STATE(SC);
+  result[count++] = GET_3POS_STATE(SD);
+#elif defined(PCBX7)
+  result[count++] = GET_3POS_STATE(SA);
+  result[count++] = GET_3POS_STATE(SB);
+  result[count++] = GET_3POS_STATE(SC);
+  result[count++] = GET_3POS_STATE(SD);
+  result[count++] = GET_2POS_STATE(SF);
+  result[count++] = GET_2POS_STATE(SH);
+#elif defined(PCBTARANIS) || defined(PCBHORUS)
+  result[count++] = GET_3POS_STATE(SA);
+  result[count++] = GET_3POS_STATE(SB);
+  result[count++] = GET_3POS_STATE(SC);
+  result[count++] = GET_3POS_STATE(SD);
+  result[count++] = GET_3POS_STATE(SE);
+  result[count++] = GET_2POS_STATE(SF);
+  result[count++] = GET_3POS_STATE(SG);
+  result[count++] = GET_2POS_STATE(SH);
+#elif defined(PCBI8) || defined(PCBNV14)
+  result[count++] = GET_3POS_STATE(SA);
+  result[count++] = GET_3POS_STATE(SB);
+  result[count++] = GET_3POS_STATE(SC);
+  result[count++] = GET_3POS_STATE(SD);
+  result[count++] = GET_2POS_STATE(SE);
+  result[count++] = GET_2POS_STATE(SF);
+#else
+  result[count++] = GET_2POS_STATE(THR);
+  result[count++] = GET_2POS_STATE(RUD);
+  result[count++] = GET_2POS_STATE(ELE);
+  result[count++] = GET_3POS_STATE(ID);
+  result[count++] = GET_2POS_STATE(AIL);
+  result[count++] = GET_2POS_STATE(GEA);
+  result[count++] = GET_2POS_STATE(TRN);
+#endif
+
+  if (states) {
+    memcpy(states, result, count);
+  }
+  return count;
+}
+
+static uint8_t getLogsSensorFieldType(int index)
+{
+  if (!isTelemetryFieldAvailable(index) || !g_model.telemetrySensors[index].logs)
+    return LOGS_FIELD_NONE;
+  TelemetrySensor & sensor = g_model.telemetrySensors[index];
+  if (sensor.unit == UNIT_GPS)
+    return LOGS_FIELD_GPS;
+  else if (sensor.unit == UNIT_DATETIME)
+    return LOGS_FIELD_SENSOR_DATETIME;
+  else if (sensor.prec == 2)
+    return LOGS_FIELD_VALUE_PREC2;
+  else if (sensor.prec == 1)
+    return LOGS_FIELD_VALUE_PREC1;
+  else
+    return LOGS_FIELD_VALUE;
+}
+
+static void addLogsField(uint8_t type)
+{
+  logsFields[logsFieldsCount++] = type;
+  logsRecordSize += logsFieldSize[type];
+}
+
+// The fields list follows the columns order of writeHeader()
+void writeBinaryHeader()
+{
+  logsFieldsCount = 0;
+  logsRecordSize = 1;
+
+#if defined(RTCLOCK)
+  addLogsField(LOGS_FIELD_DATETIME);
+#else
+  addLogsField(LOGS_FIELD_TIME);
+#endif
+#if defined(TELEMETRY_FRSKY)
+  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+    uint8_t type = getLogsSensorFieldType(i);
+    if (type != LOGS_FIELD_NONE) {
+      addLogsField(type);
+    }
+  }
+#endif
+  for (uint8_t i=0; i<NUM_STICKS+NUM_POTS+NUM_SLIDERS; i++) {
+    addLogsField(LOGS_FIELD_ANALOG);
+  }
+  for (uint8_t i=getLogsSwitchesStates(NULL); i>0; i--) {
+    addLogsField(LOGS_FIELD_SWITCH);
+  }
+#if defined(PCBTARANIS) || defined(PCBHORUS) || defined(PCBI8) || defined(PCBNV14)
+  addLogsField(LOGS_FIELD_LOGICAL_SWITCHES);
+#endif
+  addLogsField(LOGS_FIELD_VALUE_PREC1); // TxBat
+
+  LogsBinaryHeader header = { {'O', 'T', 'X', 'L'}, LOGS_BINARY_VERSION, logsFieldsCount, logsRecordSize };
+  logsBufferPush(&header, sizeof(header));
+  logsBufferPush(logsFields, logsFieldsCount);
+  writeHeader();
+  logsBufferPad();
+}
+
+static bool isLogsLayoutChanged()
+{
+#if defined(TELEMETRY_FRSKY)
+  uint8_t field = 1;
+  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+    uint8_t type = getLogsSensorFieldType(i);
+    if (type != LOGS_FIELD_NONE && logsFields[field++] != type) {
+      return true;
+    }
+  }
+  return logsFields[field] != LOGS_FIELD_ANALOG;
+#else
+  return false;
+#endif
+}
+
+static uint8_t * appendLogsField(uint8_t * dest, const void * value, uint8_t size)
+{
+  memcpy(dest, value, size);
+  return dest + size;
+}
+
+void writeBinaryRecord()
+{
+  if (isLogsLayoutChanged()) {
+    // sensors have been discovered / removed, start a new section
+    if (logsBufferFree() < LOGS_BUFFER_SIZE / 2) {
+      logsDroppedRecords++;
+      return;
+    }
+    logsBufferPad();
+    writeBinaryHeader();
+  }
+
+  if (logsBufferFree() < logsRecordSize) {
+    if (logsDroppedRecords++ == 0) {
+      TRACE("logs buffer full, record dropped");
+    }
+    return;
+  }
+
+  uint8_t * record = logsRecord;
+  *record++ = LOGS_RECORD_MARKER;
+
+#if defined(RTCLOCK)
+  {
+    static struct gtm utm;
+    static gtime_t lastRtcTime = 0;
+    if (g_rtcTime != lastRtcTime) {
+      lastRtcTime = g_rtcTime;
+      gettime(&utm);
+    }
+    uint16_t year = utm.tm_year + TM_YEAR_BASE;
+    uint8_t datetime[6] = { (uint8_t)(utm.tm_mon + 1), (uint8_t)utm.tm_mday, (uint8_t)utm.tm_hour, (uint8_t)utm.tm_min, (uint8_t)utm.tm_sec, (uint8_t)g_ms100 };
+    record = appendLogsField(record, &year, sizeof(year));
+    record = appendLogsField(record, datetime, sizeof(datetime));
+  }
+#else
+  uint32_t time = get_tmr10ms();
+  record = appendLogsField(record, &time, sizeof(time));
+#endif
+
+#if defined(TELEMETRY_FRSKY)
+  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+    uint8_t type = getLogsSensorFieldType(i);
+    TelemetryItem & telemetryItem = telemetryItems[i];
+    if (type == LOGS_FIELD_GPS) {
+      record = appendLogsField(record, &telemetryItem.gps.latitude, sizeof(int32_t));
+      record = appendLogsField(record, &telemetryItem.gps.longitude, sizeof(int32_t));
+    }
+    else if (type == LOGS_FIELD_SENSOR_DATETIME) {
+      uint16_t year = telemetryItem.datetime.year;
+      uint8_t datetime[5] = { telemetryItem.datetime.month, telemetryItem.datetime.day, telemetryItem.datetime.hour, telemetryItem.datetime.min, telemetryItem.datetime.sec };
+      record = appendLogsField(record, &year, sizeof(year));
+      record = appendLogsField(record, datetime, sizeof(datetime));
+    }
+    else if (type != LOGS_FIELD_NONE) {
+      int32_t value = telemetryItem.value;
+      record = appendLogsField(record, &value, sizeof(value));
+    }
+  }
+#endif
+
+  for (uint8_t i=0; i<NUM_STICKS+NUM_POTS+NUM_SLIDERS; i++) {
+    record = appendLogsField(record, &calibratedAnalogs[i], sizeof(int16_t));
+  }
+
+  record += getLogsSwitchesStates((int8_t *)record);
+
+#if defined(PCBTARANIS) || defined(PCBHORUS) || defined(PCBI8) || defined(PCBNV14)
+  uint32_t logicalSwitches[2] = { getLogicalSwitchesStates(32), getLogicalSwitchesStates(0) };
+  record = appendLogsField(record, logicalSwitches, sizeof(logicalSwitches));
+#endif
+
+  int32_t vbat = g_vbat100mV;
+  record = appendLogsField(record, &vbat, sizeof(vbat));
+
+  logsBufferPush(logsRecord, logsRecordSize);
+}
+#endif
+
 void logsWrite()
 {
   static const pm_char * error_displayed = NULL;
@@ -224,7 +597,13 @@ void logsWrite()
       lastLogTime = tmr10ms;
 
       if (!g_oLogFile.obj.fs) {
+#if defined(LOGS_BINARY)
+        RTOS_LOCK_MUTEX(logsMutex);
+        const pm_char * result = logsOpen();
+        RTOS_UNLOCK_MUTEX(logsMutex);
+#else
         const pm_char * result = logsOpen();
+#endif
         if (result != NULL) {
           if (result != error_displayed) {
             error_displayed = result;
@@ -234,6 +613,15 @@ void logsWrite()
         }
       }
 
+#if defined(LOGS_BINARY)
+      writeBinaryRecord();
+
+      if (logsWriteError && !error_displayed) {
+        error_displayed = STR_SDCARD_ERROR;
+        POPUP_WARNING(STR_SDCARD_ERROR);
+        logsClose();
+      }
+#else
 #if defined(RTCLOCK)
       {
         static struct gtm utm;
@@ -406,6 +794,7 @@ void logsWrite()
         POPUP_WARNING(STR_SDCARD_ERROR);
         logsClose();
       }
+#endif
     }
   }
   else {
@@ -267,24 +267,105 @@ void luaGetValueAndPush(lua_State* L, int src)
   }
 }
 
+// luaSingleFields[] is sorted by name (see luaexport.py)
+static const LuaSingleField * luaFindSingleField(const char * name)
+{
+  int first = 0;
+  int last = DIM(luaSingleFields) - 1;
+  while (first <= last) {
+    int n = (first + last) / 2;
+    int cmp = strcmp(name, luaSingleFields[n].name);
+    if (cmp == 0)
+      return &luaSingleFields[n];
+    else if (cmp < 0)
+      last = n - 1;
+    else
+      first = n + 1;
+  }
+  return NULL;
+}
+
+// The telemetry sensors labels, sorted. Sensors with the same label stay
+// in the sensors order, the first one is returned as before.
+struct LuaSensorLabel {
+  char label[TELEM_LABEL_LEN+1];
+  uint8_t index;
+};
+
+static LuaSensorLabel luaSensorsLabels[MAX_TELEMETRY_SENSORS];
+static uint8_t luaSensorsLabelsCount;
+static bool luaSensorsLabelsDirty = true;
+
+void luaInvalidateSensorsLabels()
+{
+  luaSensorsLabelsDirty = true;
+}
+
+static void luaBuildSensorsLabels()
+{
+  luaSensorsLabelsDirty = false;
+  luaSensorsLabelsCount = 0;
+
+  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
+    if (isTelemetryFieldAvailable(i)) {
+      LuaSensorLabel entry;
+      zchar2str(entry.label, g_model.telemetrySensors[i].label, TELEM_LABEL_LEN);
+      entry.index = i;
+      int pos = luaSensorsLabelsCount++;
+      while (pos > 0 && strcmp(entry.label, luaSensorsLabels[pos-1].label) < 0) {
+        luaSensorsLabels[pos] = luaSensorsLabels[pos-1];
+        pos--;
+      }
+      luaSensorsLabels[pos] = entry;
+    }
+  }
+}
+
+// returns the first sensor index with this label, -1 if none
+static int luaFindSensorLabel(const char * name, unsigned int len)
+{
+  char label[TELEM_LABEL_LEN+1];
+
+  if (len > TELEM_LABEL_LEN) {
+    return -1;
+  }
+
+  memcpy(label, name, len);
+  label[len] = '\0';
+
+  int first = 0;
+  int last = luaSensorsLabelsCount;
+  while (first < last) {
+    int n = (first + last) / 2;
+    if (strcmp(luaSensorsLabels[n].label, label) < 0)
+      first = n + 1;
+    else
+      last = n;
+  }
+
+  if (first < luaSensorsLabelsCount && !strcmp(luaSensorsLabels[first].label, label)) {
+    return luaSensorsLabels[first].index;
+  }
+
+  return -1;
+}
+
 /**
   Return field data for a given field name
 */
 bool luaFindFieldByName(const char * name, LuaField & field, unsigned int flags)
 {
-  // TODO better search method (binary lookup)
-  for (unsigned int n=0; n<DIM(luaSingleFields); ++n) {
-    if (!strcmp(name, luaSingleFields[n].name)) {
-      field.id = luaSingleFields[n].id;
-      if (flags & FIND_FIELD_DESC) {
-        strncpy(field.desc, luaSingleFields[n].desc, sizeof(field.desc)-1);
-        field.desc[sizeof(field.desc)-1] = '\0';
-      }
-      else {
-        field.desc[0] = '\0';
-      }
-      return true;
+  const LuaSingleField * singleField = luaFindSingleField(name);
+  if (singleField) {
+    field.id = singleField->id;
+    if (flags & FIND_FIELD_DESC) {
+      strncpy(field.desc, singleField->desc, sizeof(field.desc)-1);
+      field.desc[sizeof(field.desc)-1] = '\0';
+    }
+    else {
+      field.desc[0] = '\0';
     }
+    return true;
   }
 
   // search in multiples
@@ -319,30 +400,26 @@ bool luaFindFieldByName(const char * name, LuaField & field, unsigned int flags)
 
   // search in telemetry
   field.desc[0] = '\0';
-  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
-    if (isTelemetryFieldAvailable(i)) {
-      char sensorName[TELEM_LABEL_LEN+1];
-      int len = zchar2str(sensorName, g_model.telemetrySensors[i].label, TELEM_LABEL_LEN);
-      if (!strncmp(sensorName, name, len)) {
-        if (name[len] == '\0') {
-          field.id = MIXSRC_FIRST_TELEM + 3*i;
-          field.desc[0] = '\0';
-          return true;
-        }
-        else if (name[len] == '-' && name[len+1] == '\0') {
-          field.id = MIXSRC_FIRST_TELEM + 3*i + 1;
-          field.desc[0] = '\0';
-          return true;
-        }
-        else if (name[len] == '+' && name[len+1] == '\0') {
-          field.id = MIXSRC_FIRST_TELEM + 3*i + 2;
-          field.desc[0] = '\0';
-          return true;
-        }
-      }
+
+  if (luaSensorsLabelsDirty) {
+    luaBuildSensorsLabels();
+  }
+
+  int index = luaFindSensorLabel(name, len);
+  int offset = 0;
+  if (len > 0 && (name[len-1] == '-' || name[len-1] == '+')) {
+    int other = luaFindSensorLabel(name, len-1);
+    if (other >= 0 && (index < 0 || other < index)) {
+      index = other;
+      offset = (name[len-1] == '-' ? 1 : 2);
     }
   }
 
+  if (index >= 0) {
+    field.id = MIXSRC_FIRST_TELEM + 3*index + offset;
+    return true;
+  }
+
   return false;  // not found
 }
 
@@ -931,6 +1008,54 @@ static int luaGetGeneralSettings(lua_State * L)
   return 1;
 }
 
+/*luadoc
+@function getMixerStats([reset])
+
+Returns the timings of the mixer task runs
+
+@param reset (boolean) reset the statistics once read
+
+@retval table with one element per run trigger: the modules from 1 to the
+number of modules, then the runs done without module. Each element is a table with:
+ * `duration` (table) durations histogram
+ * `latency` (table) histogram of the delays between the module request and the run
+ * `period` (table) histogram of the periods between two runs with the same trigger
+
+The histograms have 16 buckets in microseconds, `[1]` counts the 0us values,
+`[n]` the values from 2^(n-2) to 2^(n-1)-1, and `[16]` all the longer ones.
+Their `max` element is the longest value.
+
+@status current Introduced in 2.2.2
+*/
+static void luaPushTimingHistogram(lua_State * L, const char * name, const TimingHistogram & histogram)
+{
+  lua_pushstring(L, name);
+  lua_createtable(L, TIMING_HISTOGRAM_BUCKETS, 1);
+  for (int i=0; i<TIMING_HISTOGRAM_BUCKETS; i++) {
+    lua_pushunsigned(L, histogram.getCount(i));
+    lua_rawseti(L, -2, i+1);
+  }
+  lua_pushtableinteger(L, "max", histogram.getMax());
+  lua_settable(L, -3);
+}
+
+static int luaGetMixerStats(lua_State * L)
+{
+  bool reset = lua_toboolean(L, 1);
+  lua_createtable(L, MIXER_STATS_TIMEOUT+1, 0);
+  for (int i=0; i<=MIXER_STATS_TIMEOUT; i++) {
+    lua_createtable(L, 0, 3);
+    luaPushTimingHistogram(L, "duration", mixerStats[i].duration);
+    luaPushTimingHistogram(L, "latency", mixerStats[i].latency);
+    luaPushTimingHistogram(L, "period", mixerStats[i].period);
+    lua_rawseti(L, -2, i+1);
+  }
+  if (reset) {
+    resetMixerStats();
+  }
+  return 1;
+}
+
 /*luadoc
 @function popupInput(title, event, input, min, max)
 
@@ -1117,6 +1242,7 @@ static int luaSetTelemetryValue(lua_State * L)
       telemetrySensor.subId = subId;
       telemetrySensor.instance = instance;
       telemetrySensor.init(zname, unit, prec);
+      invalidateTelemetrySensors();
       lua_pushboolean(L, true);
     } else {
       lua_pushboolean(L, false);
@@ -1291,6 +1417,7 @@ const luaL_Reg opentxLib[] = {
 #endif
   { "getVersion", luaGetVersion },
   { "getGeneralSettings", luaGetGeneralSettings },
+  { "getMixerStats", luaGetMixerStats },
   { "getValue", luaGetValue },
   { "getRAS", luaGetRAS },
   { "getTxGPS", luaGetTxGPS },
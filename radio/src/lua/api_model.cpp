@@ -407,6 +407,7 @@ static int luaModelInsertInput(lua_State *L)
         expo->swtch = luaL_checkinteger(L, -1);
       }
     }
+    invalidateModelPlans();
   }
 
   return 0;
@@ -448,6 +449,7 @@ Delete all Inputs
 static int luaModelDeleteInputs(lua_State *L)
 {
   clearInputs();
+  invalidateModelPlans();
   return 0;
 }
 
@@ -647,6 +649,7 @@ static int luaModelInsertMix(lua_State *L)
         mix->speedDown = luaL_checkinteger(L, -1);
       }
     }
+    invalidateModelPlans();
   }
 
   return 0;
@@ -688,6 +691,7 @@ Remove all mixers
 static int luaModelDeleteMixes(lua_State *L)
 {
   memset(g_model.mixData, 0, sizeof(g_model.mixData));
+  invalidateModelPlans();
   return 0;
 }
 
@@ -781,6 +785,7 @@ static int luaModelSetLogicalSwitch(lua_State *L)
       }
     }
     storageDirty(EE_MODEL);
+    invalidateModelPlans();
   }
 
   return 0;
@@ -1037,6 +1042,7 @@ static int luaModelSetCurve(lua_State *L)
     }
   }
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 
   lua_pushinteger(L, 0);
   return 1;
@@ -311,6 +311,100 @@ void luaDoGc(lua_State * L, bool full)
   }
 }
 
+LuaGcState luaGcScripts;
+#if defined(COLORLCD)
+LuaGcState luaGcWidgets;
+#endif
+uint16_t luaGcBudget = LUA_GC_FRAME_BUDGET;
+
+LuaGcState & luaGcGetState(lua_State * L)
+{
+#if defined(COLORLCD)
+  if (L == lsWidgets) return luaGcWidgets;
+#endif
+  return luaGcScripts;
+}
+
+bool luaGcMemoryPressure(const LuaGcState & gc, uint32_t memUsed)
+{
+#if (LUA_MEM_MAX > 0)
+  uint32_t totalMemUsed = luaGcScripts.memUsed;
+#if defined(COLORLCD)
+  totalMemUsed += luaGcWidgets.memUsed + luaExtraMemoryUsage;
+#endif
+  return totalMemUsed > LUA_MEM_MAX / 4 * 3;
+#else
+  // no limit to get close to, the scripts may run at each cycle and never
+  // leave the GC idle: the heap may grow up to LUA_GC_FULL_RATIO times its
+  // size after the last full collect
+  return memUsed > gc.memCollected * LUA_GC_FULL_RATIO;
+#endif
+}
+
+void luaGcStartFrame()
+{
+  luaGcBudget = LUA_GC_FRAME_BUDGET;
+}
+
+// Runs GC steps sized to the heap growth since the previous slice, until
+// this growth is paid back or the slice budget is spent. A full collect is
+// only done when idle or under memory pressure, once the heap has grown enough.
+// Returns the time spent in us
+uint16_t luaGcSlice(lua_State * L, bool idle)
+{
+  if (!L) return 0;
+
+  LuaGcState & gc = luaGcGetState(L);
+  uint16_t start = getTmr2MHz();
+
+  uint32_t memUsed = luaGetMemUsed(L);
+  uint32_t growth = (memUsed > gc.memUsed ? memUsed - gc.memUsed : 0);
+  gc.allocRate = (gc.allocRate * 3 + growth) / 4;
+  gc.debt += growth;
+  if (memUsed < gc.memCollected) {
+    gc.memCollected = memUsed;
+  }
+
+  PROTECT_LUA() {
+    if ((idle || luaGcMemoryPressure(gc, memUsed)) && memUsed > gc.memCollected + LUA_GC_FULL_GROWTH) {
+      lua_gc(L, LUA_GCCOLLECT, 0);
+      gc.memCollected = luaGetMemUsed(L);
+      gc.debt = 0;
+      gc.fullCollects++;
+    }
+    else {
+      uint16_t sliceBudget = min<uint16_t>(luaGcBudget, LUA_GC_SLICE_MAX);
+      uint32_t step = limit<uint32_t>(LUA_GC_STEP_MIN, gc.allocRate >> 10, LUA_GC_STEP_MAX);
+      while (gc.debt > 0 && (uint16_t)(getTmr2MHz() - start) < sliceBudget) {
+        if (lua_gc(L, LUA_GCSTEP, step)) {
+          // end of the GC cycle
+          gc.debt = 0;
+        }
+        else {
+          gc.debt = (gc.debt > (step << 10) ? gc.debt - (step << 10) : 0);
+        }
+      }
+    }
+    gc.memUsed = luaGetMemUsed(L);
+  }
+  else {
+    // we disable Lua for the rest of the session
+    if (L == lsScripts) luaDisable();
+#if defined(COLORLCD)
+    if (L == lsWidgets) lsWidgets = 0;
+#endif
+  }
+  UNPROTECT_LUA();
+
+  uint16_t elapsed = getTmr2MHz() - start;
+  luaGcBudget = (elapsed < luaGcBudget ? luaGcBudget - elapsed : 0);
+  elapsed /= 2;
+  if (elapsed > gc.maxSliceTime) {
+    gc.maxSliceTime = elapsed;
+  }
+  return elapsed;
+}
+
 void luaFree(lua_State * L, ScriptInternalData & sid)
 {
   PROTECT_LUA() {
@@ -352,21 +446,256 @@ static int luaDumpWriter(lua_State * L, const void* p, size_t size, void* u)
   @param stripDebug This is passed directly to luaU_dump()
     1 = remove debug info from bytecode (smaller but errors are less informative)
     0 = keep debug info
+
+  @retval true if the file was written, an incomplete file is removed
 */
-static void luaDumpState(lua_State * L, const char * filename, const FILINFO * finfo, int stripDebug)
+static bool luaDumpState(lua_State * L, const char * filename, const FILINFO * finfo, int stripDebug)
 {
   FIL D;
   if (f_open(&D, filename, FA_WRITE | FA_CREATE_ALWAYS) == FR_OK) {
     lua_lock(L);
-    luaU_dump(L, getproto(L->top - 1), luaDumpWriter, &D, stripDebug);
+    int status = luaU_dump(L, getproto(L->top - 1), luaDumpWriter, &D, stripDebug);
     lua_unlock(L);
-    if (f_close(&D) == FR_OK) {
+    if (f_close(&D) == FR_OK && status == 0) {
       if (finfo != NULL)
         f_utime(filename, finfo);  // set the file mod time
       TRACE("luaDumpState(%s): Saved bytecode to file.", filename);
+      return true;
     }
+    TRACE_ERROR("luaDumpState(%s): Error: Could not write output file.", filename);
+    f_unlink(filename);
   } else
     TRACE_ERROR("luaDumpState(%s): Error: Could not open output file.", filename);
+  return false;
+}
+
+/*
+  The manifest lists the scripts whose .luac was compiled from the current .lua file.
+  It is checked at boot (and when the SD card comes back from USB) by luaPrecompileScripts(),
+  which compiles the scripts that changed, so that their bytecode is then loaded without any f_stat().
+  It is only trusted when it was written for the same bytecode format (see luaU_header()).
+*/
+#define LUA_MANIFEST_VERSION      1
+#define LUA_MANIFEST_ENTRIES      48
+#define LUA_MANIFEST_PATH_LEN     48
+
+PACK(struct LuaManifestEntry {
+  char path[LUA_MANIFEST_PATH_LEN];   // without the extension
+  uint32_t fsize;                     // .lua file size and date
+  uint16_t fdate;
+  uint16_t ftime;
+});
+
+LuaManifestEntry luaManifest[LUA_MANIFEST_ENTRIES];
+uint8_t luaManifestCount = 0;
+
+static LuaManifestEntry * luaManifestFind(const char * path, unsigned int len)
+{
+  if (len >= LUA_MANIFEST_PATH_LEN)
+    return NULL;
+  for (uint8_t i=0; i<luaManifestCount; i++) {
+    if (!strncmp(luaManifest[i].path, path, len) && luaManifest[i].path[len] == '\0')
+      return &luaManifest[i];
+  }
+  return NULL;
+}
+
+static void luaLoadManifest()
+{
+  FIL file;
+  uint8_t buf[8];
+  lu_byte header[LUAC_HEADERSIZE], bytecodeHeader[LUAC_HEADERSIZE];
+  UINT read;
+
+  luaManifestCount = 0;
+  if (f_open(&file, SCRIPTS_MANIFEST_PATH, FA_OPEN_EXISTING | FA_READ) != FR_OK) {
+    return;
+  }
+
+  luaU_header(bytecodeHeader);
+  if (f_read(&file, buf, 8, &read) == FR_OK && read == 8 && !memcmp(buf, "LUAM", 4) && buf[4] == LUA_MANIFEST_VERSION &&
+      *(uint16_t*)&buf[6] <= LUA_MANIFEST_ENTRIES && f_size(&file) == 8 + LUAC_HEADERSIZE + *(uint16_t*)&buf[6] * sizeof(LuaManifestEntry) &&
+      f_read(&file, header, LUAC_HEADERSIZE, &read) == FR_OK && read == LUAC_HEADERSIZE && !memcmp(header, bytecodeHeader, LUAC_HEADERSIZE)) {
+    UINT size = *(uint16_t*)&buf[6] * sizeof(LuaManifestEntry);
+    if (f_read(&file, luaManifest, size, &read) == FR_OK && read == size) {
+      luaManifestCount = *(uint16_t*)&buf[6];
+    }
+  }
+
+  f_close(&file);
+}
+
+static void luaSaveManifest()
+{
+  FIL file;
+  uint8_t buf[8];
+  lu_byte header[LUAC_HEADERSIZE];
+  UINT written;
+
+  if (f_open(&file, SCRIPTS_MANIFEST_PATH, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+    TRACE_ERROR("luaSaveManifest(): Error: Could not open %s.", SCRIPTS_MANIFEST_PATH);
+    return;
+  }
+
+  memcpy(buf, "LUAM", 4);
+  buf[4] = LUA_MANIFEST_VERSION;
+  buf[5] = 0;
+  *(uint16_t*)&buf[6] = luaManifestCount;
+  luaU_header(header);
+  f_write(&file, buf, 8, &written);
+  f_write(&file, header, LUAC_HEADERSIZE, &written);
+  f_write(&file, luaManifest, luaManifestCount * sizeof(LuaManifestEntry), &written);
+  f_close(&file);
+}
+
+// Compiles <path>.lua if its manifest entry is missing or outdated, returns true if the manifest changed
+static bool luaPrecompileScript(char * path, unsigned int len, const FILINFO & fno, uint8_t * seen)
+{
+  LuaManifestEntry * entry = luaManifestFind(path, len);
+  if (entry) {
+    seen[entry - luaManifest] = 1;
+    if (entry->fsize == fno.fsize && entry->fdate == fno.fdate && entry->ftime == fno.ftime) {
+      // the .luac may have been deleted since
+      FILINFO fnoLuaC;
+      strcpy(path + len, SCRIPT_BIN_EXT);
+      FRESULT res = f_stat(path, &fnoLuaC);
+      path[len] = '\0';
+      if (res == FR_OK) {
+        return false;
+      }
+    }
+  }
+  else if (len >= LUA_MANIFEST_PATH_LEN || luaManifestCount >= LUA_MANIFEST_ENTRIES) {
+    // this script will be compiled when loaded, as before
+    return false;
+  }
+
+  lua_State * L = lua_newstate(l_alloc, NULL);
+  if (!L) {
+    return false;
+  }
+  lua_atpanic(L, &custom_lua_atpanic);
+
+  bool result = false;
+  PROTECT_LUA() {
+    strcpy(path + len, SCRIPT_EXT);
+    if (luaL_loadfilex(L, path, "t") == LUA_OK) {
+      strcpy(path + len, SCRIPT_BIN_EXT);
+      if (!luaDumpState(L, path, &fno, 1)) {
+        // the script will be compiled when loaded, as before
+        if (entry) {
+          seen[entry - luaManifest] = 0;
+          result = true;
+        }
+      }
+      else {
+        if (!entry) {
+          entry = &luaManifest[luaManifestCount];
+          seen[luaManifestCount++] = 1;
+          strncpy(entry->path, path, len);
+          entry->path[len] = '\0';
+        }
+        entry->fsize = fno.fsize;
+        entry->fdate = fno.fdate;
+        entry->ftime = fno.ftime;
+        result = true;
+      }
+    }
+    else {
+      // the error will be reported when the script is loaded
+      TRACE_ERROR("luaPrecompileScript(%s): %s", path, lua_tostring(L, -1));
+      if (entry) {
+        seen[entry - luaManifest] = 0;
+        result = true;
+      }
+    }
+  }
+  UNPROTECT_LUA();
+
+  lua_close(L);
+  path[len] = '\0';
+  return result;
+}
+
+// Precompiles the .lua files of a directory, or the main.lua of each of its sub-directories
+static bool luaPrecompileDirectory(const char * directory, bool subdirs, uint8_t * seen)
+{
+  char path[LUA_MANIFEST_PATH_LEN + _MAX_LFN + sizeof(SCRIPT_BIN_EXT)];
+  FILINFO fno;
+  DIR dir;
+  bool result = false;
+
+  if (f_opendir(&dir, directory) != FR_OK) {
+    return false;
+  }
+
+  unsigned int pathlen = strlen(directory);
+  memcpy(path, directory, pathlen);
+  path[pathlen++] = '/';
+
+  for (;;) {
+    FRESULT res = f_readdir(&dir, &fno);
+    if (res != FR_OK || fno.fname[0] == 0) break;
+    if (fno.fname[0] == '.') continue;
+
+    unsigned int len = strlen(fno.fname);
+    if (pathlen + len + sizeof("/main") > LUA_MANIFEST_PATH_LEN) continue;
+    strcpy(path + pathlen, fno.fname);
+
+    if (subdirs && (fno.fattrib & AM_DIR)) {
+      strcpy(path + pathlen + len, "/main" SCRIPT_EXT);
+      FILINFO mainInfo;
+      if (f_stat(path, &mainInfo) == FR_OK) {
+        result |= luaPrecompileScript(path, pathlen + len + sizeof("/main") - 1, mainInfo, seen);
+      }
+    }
+    else if (!subdirs && !(fno.fattrib & AM_DIR)) {
+      uint8_t extlen;
+      const char * ext = getFileExtension(fno.fname, len, 0, NULL, &extlen);
+      if (ext && !strcasecmp(ext, SCRIPT_EXT)) {
+        result |= luaPrecompileScript(path, pathlen + len - extlen, fno, seen);
+      }
+    }
+  }
+
+  f_closedir(&dir);
+  return result;
+}
+
+void luaPrecompileScripts()
+{
+  uint8_t seen[LUA_MANIFEST_ENTRIES];
+  memset(seen, 0, sizeof(seen));
+
+  luaLoadManifest();
+  uint8_t count = luaManifestCount;
+
+  bool changed = luaPrecompileDirectory(SCRIPTS_MIXES_PATH, false, seen);
+  changed |= luaPrecompileDirectory(SCRIPTS_FUNCS_PATH, false, seen);
+  changed |= luaPrecompileDirectory(SCRIPTS_TELEM_PATH, false, seen);
+#if defined(COLORLCD)
+  changed |= luaPrecompileDirectory(WIDGETS_PATH, true, seen);
+  changed |= luaPrecompileDirectory(THEMES_PATH, true, seen);
+#endif
+
+  // remove the scripts which are gone
+  uint8_t i = 0;
+  while (i < luaManifestCount) {
+    if (seen[i]) {
+      i++;
+    }
+    else {
+      memmove(&luaManifest[i], &luaManifest[i+1], (luaManifestCount - i - 1) * sizeof(LuaManifestEntry));
+      memmove(&seen[i], &seen[i+1], luaManifestCount - i - 1);
+      luaManifestCount--;
+      changed = true;
+    }
+  }
+
+  TRACE("luaPrecompileScripts(): %d scripts, %d in the manifest before", luaManifestCount, count);
+  if (changed) {
+    luaSaveManifest();
+  }
 }
 #endif  // LUA_COMPILER
 
@@ -439,16 +768,34 @@ int luaLoadScriptFileToState(lua_State * L, const char * filename, const char *
   }
   strncat(filenameFull, filename, fnamelen);
 
-  // check if binary version exists
-  strcpy(filenameFull + fnamelen, SCRIPT_BIN_EXT);
-  frLuaC = f_stat(filenameFull, &fnoLuaC);
+  LuaManifestEntry * manifestEntry = NULL;
+  if (strchr(lmode, 'b') && !strpbrk(lmode, "cd")) {
+    manifestEntry = luaManifestFind(filenameFull, fnamelen);
+  }
 
-  // check if text version exists
-  strcpy(filenameFull + fnamelen, SCRIPT_EXT);
-  frLuaS = f_stat(filenameFull, &fnoLuaS);
+  if (manifestEntry) {
+    // precompiled by luaPrecompileScripts(), both versions exist and the binary one is up to date
+    frLuaS = frLuaC = FR_OK;
+    fnoLuaS.fsize = manifestEntry->fsize;
+    fnoLuaS.fdate = manifestEntry->fdate;
+    fnoLuaS.ftime = manifestEntry->ftime;
+    loadFileType = 2;
+  }
+  else {
+    // check if binary version exists
+    strcpy(filenameFull + fnamelen, SCRIPT_BIN_EXT);
+    frLuaC = f_stat(filenameFull, &fnoLuaC);
+
+    // check if text version exists
+    strcpy(filenameFull + fnamelen, SCRIPT_EXT);
+    frLuaS = f_stat(filenameFull, &fnoLuaS);
+  }
 
   // decide which version to load, text or binary
-  if (frLuaC != FR_OK && frLuaS == FR_OK) {
+  if (loadFileType) {
+    // already decided
+  }
+  else if (frLuaC != FR_OK && frLuaS == FR_OK) {
     // only text version exists
     loadFileType = 1;
     scriptNeedsCompile = true;
@@ -509,7 +856,13 @@ int luaLoadScriptFileToState(lua_State * L, const char * filename, const char *
   lstatus = luaL_loadfilex(L, filenameFull, NULL);
 #if defined(LUA_COMPILER)
   // Check for bytecode encoding problem, eg. compiled for x64. Unfortunately Lua doesn't provide a unique error code for this. See Lua/src/lundump.c.
-  if (lstatus == LUA_ERRSYNTAX && loadFileType == 2 && frLuaS == FR_OK && strstr(lua_tostring(L, -1), "precompiled")) {
+  // The .luac of a manifest entry is not checked before, it may have been deleted since the boot.
+  if (loadFileType == 2 && frLuaS == FR_OK &&
+      ((lstatus == LUA_ERRSYNTAX && strstr(lua_tostring(L, -1), "precompiled")) || (lstatus == LUA_ERRFILE && manifestEntry))) {
+    if (manifestEntry) {
+      // not trusted anymore, the next loads check both files
+      manifestEntry->path[0] = '\0';
+    }
     loadFileType = 1;
     scriptNeedsCompile = true;
     strcpy(filenameFull + fnamelen, SCRIPT_EXT);
@@ -1063,7 +1416,12 @@ bool luaDoOneRunPermanentScript(event_t evt, int i, uint32_t scriptType)
 #endif
   }
 
-  if (lua_pcall(lsScripts, inputsCount, sio ? sio->outputsCount : 0, 0) == 0) {
+  uint32_t memUsed = luaGetMemUsed(lsScripts);
+  int result = lua_pcall(lsScripts, inputsCount, sio ? sio->outputsCount : 0, 0);
+  uint32_t memUsedAfter = luaGetMemUsed(lsScripts);
+  sid.allocated = (memUsedAfter > memUsed ? memUsedAfter - memUsed : 0);
+
+  if (result == 0) {
     if (sio) {
       for (int j=sio->outputsCount-1; j>=0; j--) {
         if (!lua_isnumber(lsScripts, -1)) {
@@ -1144,12 +1502,16 @@ bool luaTask(event_t evt, uint8_t scriptType, bool allowLcdUsage)
         break;
       }
       UNPROTECT_LUA();
-      //todo gc step between scripts
+
+      uint16_t gcTime = luaGcSlice(lsScripts);
+      if (gcTime > scriptInternalData[i].gcTime) {
+        scriptInternalData[i].gcTime = gcTime;
+      }
     }
   }
-  luaDoGc(lsScripts, false);
+  luaGcSlice(lsScripts, !scriptWasRun);
 #if defined(COLORLCD)
-  luaDoGc(lsWidgets, false);
+  luaGcSlice(lsWidgets, !scriptWasRun);
 #endif
   return scriptWasRun;
 }
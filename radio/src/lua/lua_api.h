@@ -51,6 +51,12 @@ extern uint32_t luaExtraMemoryUsage;
 void luaInit();
 void luaInitThemesAndWidgets();
 #define LUA_INIT_THEMES_AND_WIDGETS()  luaInitThemesAndWidgets()
+#if defined(LUA_COMPILER)
+void luaPrecompileScripts();
+#define LUA_PRECOMPILE_SCRIPTS()       luaPrecompileScripts()
+#else
+#define LUA_PRECOMPILE_SCRIPTS()
+#endif
 
 #define lua_registernumber(L, n, i)    (lua_pushnumber(L, (i)), lua_setglobal(L, (n)))
 #define lua_registerint(L, n, i)       (lua_pushinteger(L, (i)), lua_setglobal(L, (n)))
@@ -110,6 +116,8 @@ struct ScriptInternalData {
   int run;
   int background;
   uint8_t instructions;
+  uint32_t allocated;  // heap growth during the last run, in bytes
+  uint16_t gcTime;     // longest GC slice run after the script, in us
 };
 struct ScriptInputsOutputs {
   uint8_t inputsCount;
@@ -134,6 +142,29 @@ bool luaTask(event_t evt, uint8_t scriptType, bool allowLcdUsage);
 void checkLuaMemoryUsage();
 void luaExec(const char * filename);
 void luaDoGc(lua_State * L, bool full);
+
+// GC scheduler: the Lua GC steps are run in small slices between the scripts and the
+// widgets, within a time budget given to each GUI frame
+#define LUA_GC_FRAME_BUDGET   2000        // 2MHz ticks (1ms) per frame
+#define LUA_GC_SLICE_MAX      500         // 2MHz ticks (250us) per slice
+#define LUA_GC_STEP_MIN       1           // kB
+#define LUA_GC_STEP_MAX       16          // kB
+#define LUA_GC_FULL_GROWTH    (16*1024)   // heap growth allowing a full collect when idle
+#define LUA_GC_FULL_RATIO     2           // heap growth forcing a full collect, without LUA_MEM_MAX
+struct LuaGcState {
+  uint32_t memUsed;          // heap size at the end of the last slice
+  uint32_t memCollected;     // heap size after the last full collect
+  uint32_t allocRate;        // smoothed heap growth between two slices
+  uint32_t debt;             // heap growth not yet paid back by GC steps
+  uint16_t maxSliceTime;     // in us
+  uint16_t fullCollects;
+};
+extern LuaGcState luaGcScripts;
+#if defined(COLORLCD)
+extern LuaGcState luaGcWidgets;
+#endif
+void luaGcStartFrame();
+uint16_t luaGcSlice(lua_State * L, bool idle=false);
 void luaError(lua_State * L, uint8_t error, bool acknowledge=true);
 uint32_t luaGetMemUsed(lua_State * L);
 void luaGetValueAndPush(lua_State * L, int src);
@@ -173,6 +204,7 @@ struct LuaField {
   char desc[50];
 };
 bool luaFindFieldByName(const char * name, LuaField & field, unsigned int flags=0);
+void luaInvalidateSensorsLabels();
 void luaLoadThemes();
 void luaRegisterLibraries(lua_State * L);
 void registerBitmapClass(lua_State * L);
@@ -194,6 +226,7 @@ void luaHook(lua_State * L, lua_Debug *ar);
 
 #define luaInit()
 #define LUA_INIT_THEMES_AND_WIDGETS()
+#define LUA_PRECOMPILE_SCRIPTS()
 #define LUA_LOAD_MODEL_SCRIPTS()
 
 #endif // defined(LUA)
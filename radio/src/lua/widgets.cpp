@@ -390,6 +390,7 @@ void LuaWidget::refresh()
   if (lua_pcall(lsWidgets, 1, 0, 0) != 0) {
     setErrorMessage("refresh()");
   }
+  luaGcSlice(lsWidgets);
 }
 
 void LuaWidget::background()
@@ -404,6 +405,7 @@ void LuaWidget::background()
     if (lua_pcall(lsWidgets, 1, 0, 0) != 0) {
       setErrorMessage("background()");
     }
+    luaGcSlice(lsWidgets);
   }
 }
 
@@ -209,6 +209,7 @@ void guiMain(event_t evt)
   }
 
   // run Lua scripts that don't use LCD (to use CPU time while LCD DMA is running)
+  luaGcStartFrame();
   DEBUG_TIMER_START(debugTimerLuaBg);
   luaTask(evt, RUN_MIX_SCRIPT | RUN_FUNC_SCRIPT | RUN_TELEM_BG_SCRIPT, false);
   DEBUG_TIMER_STOP(debugTimerLuaBg);
@@ -308,6 +309,7 @@ void guiMain(event_t evt)
   }
 
   // run Lua scripts that don't use LCD (to use CPU time while LCD DMA is running)
+  luaGcStartFrame();
   luaTask(0, RUN_MIX_SCRIPT | RUN_FUNC_SCRIPT | RUN_TELEM_BG_SCRIPT, false);
 
   t0 = get_tmr10ms() - t0;
@@ -165,6 +165,10 @@ void applyExpos(int16_t * anas, uint8_t mode APPLY_EXPOS_EXTRA_PARAMS)
     if (!EXPO_VALID(ed)) break; // end of list
     if (ed->chn == cur_chn)
       continue;
+#if defined(CPUARM)
+    if (!(inputsMask & ((uint32_t)1 << ed->chn)))
+      continue;
+#endif
     if (ed->flightModes & (1<<mixerCurrentFlightMode))
       continue;
     if (getSwitch(ed->swtch)) {
@@ -498,10 +502,6 @@ getvalue_t getValue(mixsrc_t i)
 #endif
   else return 0;
 }
-#define N_OFFSET           ((float)(-30.0))
-#define P_OFFSET           ((float)(30.0))
-#define P_PROPORTION       ((float)(3.0/10.0))    //must be<1
-#define N_PROPORTION       ((float)(3.0/10.0))    //must be<1
 void evalInputs(uint8_t mode)
 {
   BeepANACenter anaCenter = 0;
@@ -521,6 +521,10 @@ void evalInputs(uint8_t mode)
   for (uint8_t i=0; i<NUM_STICKS+NUM_POTS+NUM_SLIDERS; i++) {
     // normalization [0..2048] -> [-1024..1024]
     uint8_t ch = (i < NUM_STICKS ? CONVERT_MODE(i) : i);
+#if defined(CPUARM) && !defined(SIMU)
+    // filtered, calibrated and centered by getADC()
+    int16_t v = analogs.calibrated[i];
+#else
     int16_t v = anaIn(i);
 
     if (IS_POT_MULTIPOS(i)) {
@@ -536,38 +540,9 @@ void evalInputs(uint8_t mode)
 
     if (v < -RESX) v = -RESX;
     if (v >  RESX) v =  RESX;
- #if 1
-    if(v>P_OFFSET)
-    {
-        // v = k * v + b;
-        // k = (P_OFFSET * P_PROPORTION -1024)/(P_OFFSET-1024)
-        // b = 1024*(1-((P_OFFSET * P_PROPORTION -1024)/(P_OFFSET-1024))
-        const static float multi_p = P_OFFSET * P_PROPORTION;//9
-        const static float sub_p = 1024.0-P_OFFSET;//994
-        v = v*(1024.0-multi_p)/(sub_p)-1024.0*(((1024.0-multi_p)/(sub_p))-1);
-    }
-    else if((v<=P_OFFSET) && (v > 0))
-    {
-        // v = k1 * v;
-        // k1 = P_PROPORTION
-        v = P_PROPORTION *v;
-    }
-    else if((v>=N_OFFSET) && (v < 0))
-    {
-        // v = k2 * v;
-        // k2 = N_PROPORTION
-        v = N_PROPORTION *v;
-    }
-    else if(v<N_OFFSET)
-    {
-        // v = k3 * v + b1;
-        //k3  = (1024.0-N_OFFSET * N_PROPORTION)/(1024-N_OFFSET)
-        //b1 = 1024*(1-((1024-N_OFFSET * N_PROPORTION)/(1024-N_OFFSET )))
-        const static float multi_n = N_OFFSET * N_PROPORTION;// -9
-        const static float sub_n = 1024.0+N_OFFSET;// 994
-        v = v*(1024.0+multi_n)/(sub_n)+1024.0*(((1024.0+multi_n)/(sub_n))-1);
-    }
+    v = analogCenterCurve(v);
 #endif
+
     if (g_model.throttleReversed && ch==THR_STICK) {
       v = -v;
     }
@@ -701,18 +676,549 @@ int getSourceTrimValue(int source, int stickValue=0)
 }
 #endif
 
-uint8_t mixerCurrentFlightMode;
-void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
+static delayval_t getMixLineEnabled(MixData * md, bool & mixCondition)
 {
-  evalInputs(mode);
+  //========== FLIGHT MODE && SWITCH =====
+  mixCondition = (md->flightModes != 0 || md->swtch);
+  delayval_t mixEnabled = (!(md->flightModes & (1 << mixerCurrentFlightMode)) && getSwitch(md->swtch)) ? DELAY_POS_MARGIN+1 : 0;
 
-  if (tick10ms) evalLogicalSwitches(mode==e_perout_mode_normal);
+#define MIXER_LINE_DISABLE()   (mixCondition = true, mixEnabled = 0)
 
-#if defined(MODULE_ALWAYS_SEND_PULSES)
-  checkStartupWarnings();
+  if (mixEnabled && md->srcRaw >= MIXSRC_FIRST_TRAINER && md->srcRaw <= MIXSRC_LAST_TRAINER && !IS_TRAINER_INPUT_VALID()) {
+    MIXER_LINE_DISABLE();
+  }
+
+#if defined(LUA_MODEL_SCRIPTS)
+  // disable mixer if Lua script is used as source and script was killed
+  if (mixEnabled && md->srcRaw >= MIXSRC_FIRST_LUA && md->srcRaw <= MIXSRC_LAST_LUA) {
+    div_t qr = div(md->srcRaw-MIXSRC_FIRST_LUA, MAX_SCRIPT_OUTPUTS);
+    if (scriptInternalData[qr.quot].state != SCRIPT_OK) {
+      MIXER_LINE_DISABLE();
+    }
+  }
+#endif
+
+  return mixEnabled;
+}
+
+inline int32_t getMixLineWeight(MixData * md)
+{
+#if defined(CPUARM)
+  int32_t weight = GET_GVAR_PREC1(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
+  return calc100to256_16Bits(weight);
+#else
+  // saves 12 bytes code if done here and not together with weight; unknown reason
+  int16_t weight = GET_GVAR(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
+  return calc100to256_16Bits(weight);
+#endif
+}
+
+// returns the offset already scaled to the chans[] 1024*256 range
+inline int32_t getMixLineOffset(MixData * md)
+{
+#if defined(CPUARM)
+  int32_t offset = GET_GVAR_PREC1(MD_OFFSET(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
+  return offset ? div_and_round(calc100toRESX_16Bits(offset), 10) << 8 : 0;
+#else
+  int16_t offset = GET_GVAR(MD_OFFSET(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
+  return offset ? int32_t(calc100toRESX_16Bits(offset)) << 8 : 0;
+#endif
+}
+
+// everything which happens to a mix line once its source value is known: delays, trims, speed, curve, weight, offset and multiplex
+static void applyMixLine(uint8_t i, MixData * md, uint8_t mode, uint8_t tick10ms, getvalue_t v, bool mixCondition, delayval_t mixEnabled, int32_t weight, int32_t offset, uint8_t & lv_mixWarning)
+{
+#if !defined(VIRTUAL_INPUTS)
+  mixsrc_t stickIndex = md->srcRaw - MIXSRC_Rud;
+#endif
+
+  bool apply_offset_and_curve = true;
+
+  //========== DELAYS ===============
+  delayval_t _swOn = swOn[i].now;
+  delayval_t _swPrev = swOn[i].prev;
+  bool swTog = (mixEnabled > _swOn+DELAY_POS_MARGIN || mixEnabled < _swOn-DELAY_POS_MARGIN);
+  if (mode==e_perout_mode_normal && swTog) {
+    if (!swOn[i].delay) _swPrev = _swOn;
+    swOn[i].delay = (mixEnabled > _swOn ? md->delayUp : md->delayDown) * (100/DELAY_STEP);
+    swOn[i].now = mixEnabled;
+    swOn[i].prev = _swPrev;
+  }
+  if (mode==e_perout_mode_normal && swOn[i].delay > 0) {
+    swOn[i].delay = max<int16_t>(0, (int16_t)swOn[i].delay - tick10ms);
+    if (!mixCondition)
+      v = _swPrev << DELAY_POS_SHIFT;
+    else if (mixEnabled)
+      return;
+  }
+  else {
+    if (mode==e_perout_mode_normal) {
+      swOn[i].now = swOn[i].prev = mixEnabled;
+    }
+    if (!mixEnabled) {
+      if ((md->speedDown || md->speedUp) && md->mltpx!=MLTPX_REP) {
+        if (mixCondition) {
+          v = (md->mltpx == MLTPX_ADD ? 0 : RESX);
+          apply_offset_and_curve = false;
+        }
+      }
+      else if (mixCondition) {
+        return;
+      }
+    }
+  }
+
+  if (mode==e_perout_mode_normal && (!mixCondition || mixEnabled || swOn[i].delay)) {
+    if (md->mixWarn) lv_mixWarning |= 1 << (md->mixWarn - 1);
+#if defined(BOLD_FONT)
+    swOn[i].activeMix = true;
+#endif
+  }
+
+  if (apply_offset_and_curve) {
+
+    //========== TRIMS ================
+    if (!(mode & e_perout_mode_notrims)) {
+#if defined(VIRTUAL_INPUTS)
+      if (md->carryTrim == 0) {
+        v += getSourceTrimValue(md->srcRaw, v);
+      }
+#else
+      int8_t mix_trim = md->carryTrim;
+      if (mix_trim < TRIM_ON)
+        mix_trim = -mix_trim - 1;
+      else if (mix_trim == TRIM_ON && stickIndex < NUM_STICKS)
+        mix_trim = stickIndex;
+      else
+        mix_trim = -1;
+      if (mix_trim >= 0) {
+        int16_t trim = trims[mix_trim];
+        if (mix_trim == THR_STICK && g_model.throttleReversed)
+          v -= trim;
+        else
+          v += trim;
+      }
+#endif
+    }
+  }
+
+  //========== SPEED ===============
+  // now its on input side, but without weight compensation. More like other remote controls
+  // lower weight causes slower movement
+
+  if (mode <= e_perout_mode_inactive_flight_mode && (md->speedUp || md->speedDown)) { // there are delay values
+#define DEL_MULT_SHIFT 8
+    // we recale to a mult 256 higher value for calculation
+    int32_t tact = act[i];
+    int16_t diff = v - (tact>>DEL_MULT_SHIFT);
+    if (diff) {
+      // open.20.fsguruh: speed is defined in % movement per second; In menu we specify the full movement (-100% to 100%) = 200% in total
+      // the unit of the stored value is the value from md->speedUp or md->speedDown divide SLOW_STEP seconds; e.g. value 4 means 4/SLOW_STEP = 2 seconds for CPU64
+      // because we get a tick each 10msec, we need 100 ticks for one second
+      // the value in md->speedXXX gives the time it should take to do a full movement from -100 to 100 therefore 200%. This equals 2048 in recalculated internal range
+      if (tick10ms || !s_mixer_first_run_done) {
+        // only if already time is passed add or substract a value according the speed configured
+        int32_t rate = (int32_t) tick10ms << (DEL_MULT_SHIFT+11);  // = DEL_MULT*2048*tick10ms
+        // rate equals a full range for one second; if less time is passed rate is accordingly smaller
+        // if one second passed, rate would be 2048 (full motion)*256(recalculated weight)*100(100 ticks needed for one second)
+        int32_t currentValue = ((int32_t) v<<DEL_MULT_SHIFT);
+        if (diff > 0) {
+          if (s_mixer_first_run_done && md->speedUp > 0) {
+            // if a speed upwards is defined recalculate the new value according configured speed; the higher the speed the smaller the add value is
+            int32_t newValue = tact+rate/((int16_t)(100/SLOW_STEP)*md->speedUp);
+            if (newValue<currentValue) currentValue = newValue; // Endposition; prevent toggling around the destination
+          }
+        }
+        else {  // if is <0 because ==0 is not possible
+          if (s_mixer_first_run_done && md->speedDown > 0) {
+            // see explanation in speedUp
+            int32_t newValue = tact-rate/((int16_t)(100/SLOW_STEP)*md->speedDown);
+            if (newValue>currentValue) currentValue = newValue; // Endposition; prevent toggling around the destination
+          }
+        }
+        act[i] = tact = currentValue;
+        // open.20.fsguruh: this implementation would save about 50 bytes code
+      } // endif tick10ms ; in case no time passed assign the old value, not the current value from source
+      v = (tact >> DEL_MULT_SHIFT);
+    }
+  }
+
+  //========== CURVES ===============
+#if defined(CPUARM)
+  if (apply_offset_and_curve && md->curve.type != CURVE_REF_DIFF && md->curve.value) {
+    v = applyCurve(v, md->curve);
+  }
+#else
+  if (apply_offset_and_curve && md->curveParam && md->curveMode == MODE_CURVE) {
+    v = applyCurve(v, md->curveParam);
+  }
+#endif
+
+  //========== WEIGHT ===============
+  int32_t dv = (int32_t)v * weight;
+#if defined(CPUARM)
+  dv = div_and_round(dv, 10);
+#endif
+
+  //========== OFFSET / AFTER ===============
+  if (apply_offset_and_curve) {
+    dv += offset;
+  }
+
+  //========== DIFFERENTIAL =========
+#if defined(CPUARM)
+  if (md->curve.type == CURVE_REF_DIFF && md->curve.value) {
+    dv = applyCurve(dv, md->curve);
+  }
+#else
+  if (md->curveMode == MODE_DIFFERENTIAL) {
+    // @@@2 also recalculate curveParam to a 256 basis which ease the calculation later a lot
+    int16_t curveParam = calc100to256(GET_GVAR(md->curveParam, -100, 100, mixerCurrentFlightMode));
+    if (curveParam > 0 && dv < 0)
+      dv = (dv * (256 - curveParam)) >> 8;
+    else if (curveParam < 0 && dv > 0)
+      dv = (dv * (256 + curveParam)) >> 8;
+  }
+#endif
+
+  int32_t * ptr = &chans[md->destCh]; // Save calculating address several times
+
+  switch (md->mltpx) {
+    case MLTPX_REP:
+      *ptr = dv;
+#if defined(BOLD_FONT)
+      if (mode==e_perout_mode_normal) {
+        for (uint8_t m=i-1; m<MAX_MIXERS && mixAddress(m)->destCh==md->destCh; m--)
+          swOn[m].activeMix = false;
+      }
+#endif
+      break;
+    case MLTPX_MUL:
+      // @@@2 we have to remove the weight factor of 256 in case of 100%; now we use the new base of 256
+      dv >>= 8;
+      dv *= *ptr;
+      dv >>= RESX_SHIFT;   // same as dv /= RESXl;
+      *ptr = dv;
+      break;
+    default: // MLTPX_ADD
+      *ptr += dv; //Mixer output add up to the line (dv + (dv>0 ? 100/2 : -100/2))/(100);
+      break;
+  } // endswitch md->mltpx
+#ifdef PREVENT_ARITHMETIC_OVERFLOW
+/*
+  // a lot of assumptions must be true, for this kind of check; not really worth for only 4 bytes flash savings
+  // this solution would save again 4 bytes flash
+  int8_t testVar=(*ptr<<1)>>24;
+  if ( (testVar!=-1) && (testVar!=0 ) ) {
+    // this devices by 64 which should give a good balance between still over 100% but lower then 32x100%; should be OK
+    *ptr >>= 6;  // this is quite tricky, reduces the value a lot but should be still over 100% and reduces flash need
+  } */
+
+
+  PACK( union u_int16int32_t {
+    struct {
+      int16_t lo;
+      int16_t hi;
+    } words_t;
+    int32_t dword;
+  });
+
+  u_int16int32_t tmp;
+  tmp.dword=*ptr;
+
+  if (tmp.dword<0) {
+    if ((tmp.words_t.hi&0xFF80)!=0xFF80) tmp.words_t.hi=0xFF86; // set to min nearly
+  }
+  else {
+    if ((tmp.words_t.hi|0x007F)!=0x007F) tmp.words_t.hi=0x0079; // set to max nearly
+  }
+  *ptr = tmp.dword;
+  // this implementation saves 18bytes flash
+
+/*      dv=*ptr>>8;
+  if (dv>(32767-RESXl)) {
+    *ptr=(32767-RESXl)<<8;
+  } else if (dv<(-32767+RESXl)) {
+    *ptr=(-32767+RESXl)<<8;
+  }*/
+  // *ptr=limit( int32_t(int32_t(-1)<<23), *ptr, int32_t(int32_t(1)<<23));  // limit code cost 72 bytes
+  // *ptr=limit( int32_t((-32767+RESXl)<<8), *ptr, int32_t((32767-RESXl)<<8));  // limit code cost 80 bytes
+#endif
+}
+
+// the original mixer loop: walks g_model.mixData and repeats passes while channels used as sources are dirty
+static void evalMixesMultiPass(uint8_t mode, uint8_t tick10ms, uint8_t & lv_mixWarning)
+{
+  uint8_t pass = 0;
+
+  bitfield_channels_t dirtyChannels = (bitfield_channels_t)-1; // all dirty when mixer starts
+
+  do {
+
+    bitfield_channels_t passDirtyChannels = 0;
+
+    for (uint8_t i=0; i<MAX_MIXERS; i++) {
+
+#if defined(BOLD_FONT)
+      if (mode==e_perout_mode_normal && pass==0) swOn[i].activeMix = 0;
+#endif
+
+      MixData *md = mixAddress(i);
+
+      if (md->srcRaw == 0) break;
+
+      mixsrc_t stickIndex = md->srcRaw - MIXSRC_Rud;
+
+      if (!(dirtyChannels & ((bitfield_channels_t)1 << md->destCh))) continue;
+
+      // if this is the first calculation for the destination channel, initialize it with 0 (otherwise would be random)
+      if (i == 0 || md->destCh != (md-1)->destCh) {
+        chans[md->destCh] = 0;
+      }
+
+      bool mixCondition;
+      delayval_t mixEnabled = getMixLineEnabled(md, mixCondition);
+
+      //========== VALUE ===============
+      getvalue_t v = 0;
+      if (mode > e_perout_mode_inactive_flight_mode) {
+#if defined(VIRTUAL_INPUTS)
+        if (!mixEnabled) {
+          continue;
+        }
+        else {
+          v = getValue(md->srcRaw);
+        }
+#else
+        if (!mixEnabled || stickIndex >= NUM_STICKS || (stickIndex == THR_STICK && g_model.thrTrim)) {
+          continue;
+        }
+        else {
+          if (!(mode & e_perout_mode_nosticks)) v = anas[stickIndex];
+        }
+#endif
+      }
+      else {
+#if !defined(VIRTUAL_INPUTS)
+        if (stickIndex < NUM_STICKS) {
+          v = md->noExpo ? rawAnas[stickIndex] : anas[stickIndex];
+        }
+        else
+#endif
+        {
+          mixsrc_t srcRaw = MIXSRC_Rud + stickIndex;
+          v = getValue(srcRaw);
+          srcRaw -= MIXSRC_CH1;
+          if (srcRaw<=MIXSRC_LAST_CH-MIXSRC_CH1 && md->destCh != srcRaw) {
+            if (dirtyChannels & ((bitfield_channels_t)1 << srcRaw) & (passDirtyChannels|~(((bitfield_channels_t) 1 << md->destCh)-1)))
+              passDirtyChannels |= (bitfield_channels_t) 1 << md->destCh;
+            if (srcRaw < md->destCh || pass > 0)
+              v = chans[srcRaw] >> 8;
+          }
+        }
+        if (!mixCondition) {
+          mixEnabled = v >> DELAY_POS_SHIFT;
+        }
+      }
+
+      applyMixLine(i, md, mode, tick10ms, v, mixCondition, mixEnabled, getMixLineWeight(md), getMixLineOffset(md), lv_mixWarning);
+
+    } //endfor mixers
+
+    tick10ms = 0;
+    dirtyChannels &= passDirtyChannels;
+
+  } while (++pass < 5 && dirtyChannels);
+}
+
+#if defined(CPUARM)
+/*
+ * Mixer execution plan
+ *
+ * Compiled from g_model.mixData when the model is loaded or edited: empty and never
+ * active lines are dropped, the remaining lines are grouped by channel and the channels
+ * are sorted so that a channel used as a mix source is always computed before the
+ * channels using it. Sources, weights and offsets which don't depend on a GVar are
+ * resolved once. The mixer then walks the plan exactly once per cycle.
+ *
+ * Models where channels reference each other in a loop keep the multi-pass loop.
+ */
+
+enum MixPlanSourceType {
+  MIX_PLAN_SOURCE_OTHER,
+  MIX_PLAN_SOURCE_INPUT,
+  MIX_PLAN_SOURCE_CHANNEL,
+};
+
+#define MIX_PLAN_WEIGHT_GVAR   0x01
+#define MIX_PLAN_OFFSET_GVAR   0x02
+
+struct MixPlanLine {
+  MixData * md;
+  int32_t weight;         // already scaled, when not a GVar
+  int32_t offset;         // already scaled, when not a GVar
+  uint8_t index;          // index in g_model.mixData, for swOn[] and act[]
+  uint8_t sourceType;
+  uint8_t sourceIndex;    // input or channel index, depending on sourceType
+  uint8_t flags;
+};
+
+static MixPlanLine mixerPlan[MAX_MIXERS];
+static uint8_t mixerPlanCount = 0;
+static bool mixerPlanValid = false;
+static bool mixerPlanDirty = true;
+
+void invalidateMixerPlan()
+{
+  mixerPlanDirty = true;
+}
+
+static bool isMixLineNeverActive(MixData * md)
+{
+  const uint32_t allFlightModes = (1 << MAX_FLIGHT_MODES) - 1;
+  return (md->flightModes & allFlightModes) == allFlightModes && !md->delayUp && !md->delayDown && !md->speedUp && !md->speedDown;
+}
+
+static void compileMixerLine(uint8_t index)
+{
+  MixData * md = mixAddress(index);
+
+  if (isMixLineNeverActive(md)) {
+#if defined(BOLD_FONT)
+    swOn[index].activeMix = false;
+#endif
+    return;
+  }
+
+  MixPlanLine & line = mixerPlan[mixerPlanCount++];
+  line.md = md;
+  line.index = index;
+  line.flags = 0;
+
+  if (md->srcRaw >= MIXSRC_FIRST_INPUT && md->srcRaw <= MIXSRC_LAST_INPUT) {
+    line.sourceType = MIX_PLAN_SOURCE_INPUT;
+    line.sourceIndex = md->srcRaw - MIXSRC_FIRST_INPUT;
+  }
+  else if (md->srcRaw >= MIXSRC_CH1 && md->srcRaw <= MIXSRC_LAST_CH && md->srcRaw - MIXSRC_CH1 != md->destCh) {
+    line.sourceType = MIX_PLAN_SOURCE_CHANNEL;
+    line.sourceIndex = md->srcRaw - MIXSRC_CH1;
+  }
+  else {
+    line.sourceType = MIX_PLAN_SOURCE_OTHER;
+    line.sourceIndex = 0;
+  }
+
+  if (GV_IS_GV_VALUE(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE))
+    line.flags |= MIX_PLAN_WEIGHT_GVAR;
+  else
+    line.weight = getMixLineWeight(md);
+
+  if (GV_IS_GV_VALUE(MD_OFFSET(md), GV_RANGELARGE_NEG, GV_RANGELARGE))
+    line.flags |= MIX_PLAN_OFFSET_GVAR;
+  else
+    line.offset = getMixLineOffset(md);
+}
+
+static void compileMixerPlan()
+{
+  uint8_t firstLine[MAX_OUTPUT_CHANNELS];
+  uint8_t linesCount[MAX_OUTPUT_CHANNELS];
+  bitfield_channels_t dependencies[MAX_OUTPUT_CHANNELS];
+  bitfield_channels_t usedChannels = 0;
+
+  mixerPlanDirty = false;
+  mixerPlanValid = false;
+  mixerPlanCount = 0;
+
+  memclear(linesCount, sizeof(linesCount));
+  memclear(dependencies, sizeof(dependencies));
+
+  for (uint8_t i=0; i<MAX_MIXERS; i++) {
+    MixData * md = mixAddress(i);
+    if (md->srcRaw == 0) break;
+    uint8_t ch = md->destCh;
+    bitfield_channels_t mask = (bitfield_channels_t)1 << ch;
+    if (!(usedChannels & mask)) {
+      usedChannels |= mask;
+      firstLine[ch] = i;
+    }
+    else if (mixAddress(i-1)->destCh != ch) {
+      TRACE("Mixer plan: lines of CH%d are not contiguous", ch+1);
+      return;
+    }
+    linesCount[ch]++;
+    if (md->srcRaw >= MIXSRC_CH1 && md->srcRaw <= MIXSRC_LAST_CH && md->srcRaw - MIXSRC_CH1 != ch) {
+      dependencies[ch] |= (bitfield_channels_t)1 << (md->srcRaw - MIXSRC_CH1);
+    }
+  }
+
+  // channels without mix lines stay at 0, they are ready from the start
+  bitfield_channels_t computed = ~usedChannels;
+  while (computed != (bitfield_channels_t)-1) {
+    uint8_t ch = 0;
+    while (ch < MAX_OUTPUT_CHANNELS && ((computed & ((bitfield_channels_t)1 << ch)) || (dependencies[ch] & ~computed))) {
+      ch++;
+    }
+    if (ch == MAX_OUTPUT_CHANNELS) {
+      TRACE("Mixer plan: loop between channels, using the multi-pass mixer");
+      mixerPlanCount = 0;
+      return;
+    }
+    computed |= (bitfield_channels_t)1 << ch;
+    for (uint8_t i=firstLine[ch]; i<firstLine[ch]+linesCount[ch]; i++) {
+      compileMixerLine(i);
+    }
+  }
+
+  mixerPlanValid = true;
+}
+
+static void evalMixerPlanLine(const MixPlanLine * line, uint8_t mode, uint8_t tick10ms, uint8_t & lv_mixWarning)
+{
+  MixData * md = line->md;
+
+#if defined(BOLD_FONT)
+  if (mode == e_perout_mode_normal) swOn[line->index].activeMix = 0;
 #endif
 
+  bool mixCondition;
+  delayval_t mixEnabled = getMixLineEnabled(md, mixCondition);
+
+  //========== VALUE ===============
+  if (mode > e_perout_mode_inactive_flight_mode && !mixEnabled) {
+    return;
+  }
+
+  getvalue_t v;
+  if (line->sourceType == MIX_PLAN_SOURCE_INPUT)
+    v = anas[line->sourceIndex];
+  else if (line->sourceType == MIX_PLAN_SOURCE_CHANNEL && mode <= e_perout_mode_inactive_flight_mode)
+    v = chans[line->sourceIndex] >> 8; // the source channel is always computed before, the plan is sorted by dependencies
+  else
+    v = getValue(md->srcRaw);
+
+  if (mode <= e_perout_mode_inactive_flight_mode && !mixCondition) {
+    mixEnabled = v >> DELAY_POS_SHIFT;
+  }
+
+  int32_t weight = (line->flags & MIX_PLAN_WEIGHT_GVAR) ? getMixLineWeight(md) : line->weight;
+  int32_t offset = (line->flags & MIX_PLAN_OFFSET_GVAR) ? getMixLineOffset(md) : line->offset;
+
+  applyMixLine(line->index, md, mode, tick10ms, v, mixCondition, mixEnabled, weight, offset, lv_mixWarning);
+}
+
+static void evalMixerPlan(uint8_t mode, uint8_t tick10ms, uint8_t & lv_mixWarning)
+{
+  for (const MixPlanLine * line = mixerPlan; line < mixerPlan + mixerPlanCount; line++) {
+    evalMixerPlanLine(line, mode, tick10ms, lv_mixWarning);
+  }
+}
+#endif
+
+
 #if defined(HELI)
+static void evalSwash()
+{
 #if defined(VIRTUAL_INPUTS)
   int heliEleValue = getValue(g_model.swashR.elevatorSource);
   int heliAilValue = getValue(g_model.swashR.aileronSource);
@@ -790,6 +1296,26 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
         break;
     }
   }
+}
+#endif
+
+uint8_t mixerCurrentFlightMode;
+void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
+{
+#if defined(CURVES_LUT)
+  updateCurvesLut();
+#endif
+
+  evalInputs(mode);
+
+  if (tick10ms) evalLogicalSwitches(mode==e_perout_mode_normal);
+
+#if defined(MODULE_ALWAYS_SEND_PULSES)
+  checkStartupWarnings();
+#endif
+
+#if defined(HELI)
+  evalSwash();
 #endif
 
   memclear(chans, sizeof(chans));        // All outputs to 0
@@ -797,333 +1323,250 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
   //========== MIXER LOOP ===============
   uint8_t lv_mixWarning = 0;
 
-  uint8_t pass = 0;
+#if defined(CPUARM)
+  if (mixerPlanDirty) {
+    compileMixerPlan();
+  }
+  if (mixerPlanValid)
+    evalMixerPlan(mode, tick10ms, lv_mixWarning);
+  else
+#endif
+    evalMixesMultiPass(mode, tick10ms, lv_mixWarning);
 
-  bitfield_channels_t dirtyChannels = (bitfield_channels_t)-1; // all dirty when mixer starts
+  mixWarning = lv_mixWarning;
+}
 
-  do {
+int32_t sum_chans512[MAX_OUTPUT_CHANNELS] = {0};
 
-    bitfield_channels_t passDirtyChannels = 0;
+static void sumFlightModeChans(uint16_t act, int32_t & weight)
+{
+  for (uint8_t i=0; i<MAX_OUTPUT_CHANNELS; i++)
+    sum_chans512[i] += (chans[i] >> 4) * act;
+  weight += act;
+}
 
-    for (uint8_t i=0; i<MAX_MIXERS; i++) {
+#if defined(CPUARM) && defined(VIRTUAL_INPUTS)
+/*
+ * Flight modes fade
+ *
+ * The active flight mode is evaluated first, as when there is no fade. Most of the
+ * inputs and channels give the same result in the other fading flight modes, so for
+ * each of them only what uses something which differs from the active flight mode
+ * (flight modes mask, GVar value, trim, logical switch state, cyclic) is evaluated
+ * again, the rest is shared. Lines with a delay are always evaluated again, delays
+ * only run in the active flight mode.
+ */
 
-#if defined(BOLD_FONT)
-      if (mode==e_perout_mode_normal && pass==0) swOn[i].activeMix = 0;
+struct FlightModeFadeDiff {
+  uint64_t logicalSwitches;
+  uint32_t inputs;
+  bitfield_channels_t channels;
+  uint16_t gvars;
+  uint16_t trims;
+  bool heli;
+};
+
+static int32_t fadeChans[MAX_OUTPUT_CHANNELS];
+static int16_t fadeAnas[NUM_INPUTS];
+static int8_t fadeInputsTrims[NUM_INPUTS];
+static int16_t fadeTrims[NUM_TRIMS];
+#if defined(HELI)
+static int16_t fadeCycAnas[3];
 #endif
 
-      MixData *md = mixAddress(i);
+static bool isGVarFieldFadeDependent(int16_t x, int16_t min, int16_t max, const FlightModeFadeDiff & diff)
+{
+#if defined(GVARS)
+  if (GV_IS_GV_VALUE(x, min, max)) {
+    int8_t gv = GV_INDEX_CALCULATION(x, max);
+    if (gv < 0) gv = -1-gv;
+    return diff.gvars & (1 << gv);
+  }
+#endif
+  return false;
+}
 
-      if (md->srcRaw == 0) break;
+static bool isCurveFadeDependent(const CurveRef & curve, const FlightModeFadeDiff & diff)
+{
+  return (curve.type == CURVE_REF_DIFF || curve.type == CURVE_REF_EXPO) && isGVarFieldFadeDependent(curve.value, -100, 100, diff);
+}
 
-      mixsrc_t stickIndex = md->srcRaw - MIXSRC_Rud;
+static bool isSwitchFadeDependent(swsrc_t swtch, const FlightModeFadeDiff & diff)
+{
+  swtch = abs(swtch);
+  if (swtch >= SWSRC_FIRST_LOGICAL_SWITCH && swtch <= SWSRC_LAST_LOGICAL_SWITCH)
+    return diff.logicalSwitches & ((uint64_t)1 << (swtch - SWSRC_FIRST_LOGICAL_SWITCH));
+  else
+    return (swtch >= SWSRC_FIRST_FLIGHT_MODE && swtch <= SWSRC_LAST_FLIGHT_MODE);
+}
 
-      if (!(dirtyChannels & ((bitfield_channels_t)1 << md->destCh))) continue;
+static bool isSourceFadeDependent(mixsrc_t source, const FlightModeFadeDiff & diff)
+{
+  if (source >= MIXSRC_FIRST_INPUT && source <= MIXSRC_LAST_INPUT)
+    return diff.inputs & ((uint32_t)1 << (source - MIXSRC_FIRST_INPUT));
+#if defined(HELI)
+  else if (source >= MIXSRC_CYC1 && source <= MIXSRC_CYC3)
+    return diff.heli;
+#endif
+  else if (source >= MIXSRC_FIRST_TRIM && source <= MIXSRC_LAST_TRIM)
+    return diff.trims & (1 << (source - MIXSRC_FIRST_TRIM));
+  else if (source >= MIXSRC_FIRST_LOGICAL_SWITCH && source <= MIXSRC_LAST_LOGICAL_SWITCH)
+    return diff.logicalSwitches & ((uint64_t)1 << (source - MIXSRC_FIRST_LOGICAL_SWITCH));
+#if defined(GVARS)
+  else if (source >= MIXSRC_FIRST_GVAR && source <= MIXSRC_LAST_GVAR)
+    return diff.gvars & (1 << (source - MIXSRC_FIRST_GVAR));
+#endif
+  else
+    return false;
+}
 
-      // if this is the first calculation for the destination channel, initialize it with 0 (otherwise would be random)
-      if (i == 0 || md->destCh != (md-1)->destCh) {
-        chans[md->destCh] = 0;
-      }
+static bool isFlightModesMaskFadeDependent(uint32_t flightModes, uint8_t fm, uint8_t p)
+{
+  return ((flightModes >> fm) & 1) != ((flightModes >> p) & 1);
+}
 
-      //========== FLIGHT MODE && SWITCH =====
-      bool mixCondition = (md->flightModes != 0 || md->swtch);
-      delayval_t mixEnabled = (!(md->flightModes & (1 << mixerCurrentFlightMode)) && getSwitch(md->swtch)) ? DELAY_POS_MARGIN+1 : 0;
+static bool isExpoLineFadeDependent(ExpoData * ed, uint8_t fm, uint8_t p, const FlightModeFadeDiff & diff)
+{
+  return isFlightModesMaskFadeDependent(ed->flightModes, fm, p) ||
+         isSwitchFadeDependent(ed->swtch, diff) ||
+         (ed->srcRaw >= MIXSRC_FIRST_INPUT && ed->srcRaw <= MIXSRC_LAST_INPUT) || // inputs are being evaluated
+         isSourceFadeDependent(ed->srcRaw, diff) ||
+         isGVarFieldFadeDependent(ed->weight, MIN_EXPO_WEIGHT, 100, diff) ||
+         isGVarFieldFadeDependent(ed->offset, -100, 100, diff) ||
+         isCurveFadeDependent(ed->curve, diff);
+}
 
-#define MIXER_LINE_DISABLE()   (mixCondition = true, mixEnabled = 0)
+static bool isMixLineFadeDependent(const MixPlanLine * line, uint8_t fm, uint8_t p, const FlightModeFadeDiff & diff)
+{
+  MixData * md = line->md;
 
-      if (mixEnabled && md->srcRaw >= MIXSRC_FIRST_TRAINER && md->srcRaw <= MIXSRC_LAST_TRAINER && !IS_TRAINER_INPUT_VALID()) {
-        MIXER_LINE_DISABLE();
-      }
+  if (isFlightModesMaskFadeDependent(md->flightModes, fm, p) || md->delayUp || md->delayDown || isSwitchFadeDependent(md->swtch, diff))
+    return true;
 
-#if defined(LUA_MODEL_SCRIPTS)
-      // disable mixer if Lua script is used as source and script was killed
-      if (mixEnabled && md->srcRaw >= MIXSRC_FIRST_LUA && md->srcRaw <= MIXSRC_LAST_LUA) {
-        div_t qr = div(md->srcRaw-MIXSRC_FIRST_LUA, MAX_SCRIPT_OUTPUTS);
-        if (scriptInternalData[qr.quot].state != SCRIPT_OK) {
-          MIXER_LINE_DISABLE();
-        }
-      }
-#endif
+  if (line->sourceType == MIX_PLAN_SOURCE_CHANNEL) {
+    if (diff.channels & ((bitfield_channels_t)1 << line->sourceIndex))
+      return true;
+  }
+  else if (isSourceFadeDependent(md->srcRaw, diff)) {
+    return true;
+  }
 
-      //========== VALUE ===============
-      getvalue_t v = 0;
-      if (mode > e_perout_mode_inactive_flight_mode) {
-#if defined(VIRTUAL_INPUTS)
-        if (!mixEnabled) {
-          continue;
-        }
-        else {
-          v = getValue(md->srcRaw);
-        }
-#else
-        if (!mixEnabled || stickIndex >= NUM_STICKS || (stickIndex == THR_STICK && g_model.thrTrim)) {
-          continue;
-        }
-        else {
-          if (!(mode & e_perout_mode_nosticks)) v = anas[stickIndex];
-        }
-#endif
-      }
-      else {
-#if !defined(VIRTUAL_INPUTS)
-        if (stickIndex < NUM_STICKS) {
-          v = md->noExpo ? rawAnas[stickIndex] : anas[stickIndex];
-        }
-        else
-#endif
-        {
-          mixsrc_t srcRaw = MIXSRC_Rud + stickIndex;
-          v = getValue(srcRaw);
-          srcRaw -= MIXSRC_CH1;
-          if (srcRaw<=MIXSRC_LAST_CH-MIXSRC_CH1 && md->destCh != srcRaw) {
-            if (dirtyChannels & ((bitfield_channels_t)1 << srcRaw) & (passDirtyChannels|~(((bitfield_channels_t) 1 << md->destCh)-1)))
-              passDirtyChannels |= (bitfield_channels_t) 1 << md->destCh;
-            if (srcRaw < md->destCh || pass > 0)
-              v = chans[srcRaw] >> 8;
-          }
-        }
-        if (!mixCondition) {
-          mixEnabled = v >> DELAY_POS_SHIFT;
-        }
-      }
+  if (md->carryTrim == 0) {
+    int8_t trim = -1;
+    if (md->srcRaw >= MIXSRC_Rud && md->srcRaw <= MIXSRC_Ail)
+      trim = md->srcRaw - MIXSRC_Rud;
+    else if (line->sourceType == MIX_PLAN_SOURCE_INPUT)
+      trim = virtualInputsTrims[line->sourceIndex];
+    if (trim >= 0 && (diff.trims & (1 << trim)))
+      return true;
+  }
 
-      bool apply_offset_and_curve = true;
-
-      //========== DELAYS ===============
-      delayval_t _swOn = swOn[i].now;
-      delayval_t _swPrev = swOn[i].prev;
-      bool swTog = (mixEnabled > _swOn+DELAY_POS_MARGIN || mixEnabled < _swOn-DELAY_POS_MARGIN);
-      if (mode==e_perout_mode_normal && swTog) {
-        if (!swOn[i].delay) _swPrev = _swOn;
-        swOn[i].delay = (mixEnabled > _swOn ? md->delayUp : md->delayDown) * (100/DELAY_STEP);
-        swOn[i].now = mixEnabled;
-        swOn[i].prev = _swPrev;
-      }
-      if (mode==e_perout_mode_normal && swOn[i].delay > 0) {
-        swOn[i].delay = max<int16_t>(0, (int16_t)swOn[i].delay - tick10ms);
-        if (!mixCondition)
-          v = _swPrev << DELAY_POS_SHIFT;
-        else if (mixEnabled)
-          continue;
-      }
-      else {
-        if (mode==e_perout_mode_normal) {
-          swOn[i].now = swOn[i].prev = mixEnabled;
-        }
-        if (!mixEnabled) {
-          if ((md->speedDown || md->speedUp) && md->mltpx!=MLTPX_REP) {
-            if (mixCondition) {
-              v = (md->mltpx == MLTPX_ADD ? 0 : RESX);
-              apply_offset_and_curve = false;
-            }
-          }
-          else if (mixCondition) {
-            continue;
-          }
-        }
-      }
+  return ((line->flags & MIX_PLAN_WEIGHT_GVAR) && isGVarFieldFadeDependent(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE, diff)) ||
+         ((line->flags & MIX_PLAN_OFFSET_GVAR) && isGVarFieldFadeDependent(MD_OFFSET(md), GV_RANGELARGE_NEG, GV_RANGELARGE, diff)) ||
+         isCurveFadeDependent(md->curve, diff);
+}
 
-      if (mode==e_perout_mode_normal && (!mixCondition || mixEnabled || swOn[i].delay)) {
-        if (md->mixWarn) lv_mixWarning |= 1 << (md->mixWarn - 1);
-#if defined(BOLD_FONT)
-        swOn[i].activeMix = true;
-#endif
-      }
+static void evalFadingFlightModeMixes(uint8_t fm, uint8_t p)
+{
+  FlightModeFadeDiff diff;
+  memclear(&diff, sizeof(diff));
 
-      if (apply_offset_and_curve) {
+  diff.logicalSwitches = logicalSwitchesStateDiff(fm, p);
 
-        //========== TRIMS ================
-        if (!(mode & e_perout_mode_notrims)) {
-#if defined(VIRTUAL_INPUTS)
-          if (md->carryTrim == 0) {
-            v += getSourceTrimValue(md->srcRaw, v);
-          }
-#else
-          int8_t mix_trim = md->carryTrim;
-          if (mix_trim < TRIM_ON)
-            mix_trim = -mix_trim - 1;
-          else if (mix_trim == TRIM_ON && stickIndex < NUM_STICKS)
-            mix_trim = stickIndex;
-          else
-            mix_trim = -1;
-          if (mix_trim >= 0) {
-            int16_t trim = trims[mix_trim];
-            if (mix_trim == THR_STICK && g_model.throttleReversed)
-              v -= trim;
-            else
-              v += trim;
-          }
+#if defined(GVARS)
+  for (uint8_t gv=0; gv<MAX_GVARS; gv++) {
+    if (GVAR_VALUE(gv, getGVarFlightMode(p, gv)) != GVAR_VALUE(gv, getGVarFlightMode(fm, gv)))
+      diff.gvars |= 1 << gv;
+  }
 #endif
-        }
-      }
 
-#if defined(CPUARM)
-      int32_t weight = GET_GVAR_PREC1(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
-      weight = calc100to256_16Bits(weight);
-#else
-      // saves 12 bytes code if done here and not together with weight; unknown reason
-      int16_t weight = GET_GVAR(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
-      weight = calc100to256_16Bits(weight);
-#endif
-      //========== SPEED ===============
-      // now its on input side, but without weight compensation. More like other remote controls
-      // lower weight causes slower movement
+  for (uint8_t i=0; i<NUM_TRIMS; i++) {
+    if (getTrimValue(p, i) != getTrimValue(fm, i))
+      diff.trims |= 1 << i;
+  }
+  if (diff.trims) {
+    evalTrims();
+  }
 
-      if (mode <= e_perout_mode_inactive_flight_mode && (md->speedUp || md->speedDown)) { // there are delay values
-#define DEL_MULT_SHIFT 8
-        // we recale to a mult 256 higher value for calculation
-        int32_t tact = act[i];
-        int16_t diff = v - (tact>>DEL_MULT_SHIFT);
-        if (diff) {
-          // open.20.fsguruh: speed is defined in % movement per second; In menu we specify the full movement (-100% to 100%) = 200% in total
-          // the unit of the stored value is the value from md->speedUp or md->speedDown divide SLOW_STEP seconds; e.g. value 4 means 4/SLOW_STEP = 2 seconds for CPU64
-          // because we get a tick each 10msec, we need 100 ticks for one second
-          // the value in md->speedXXX gives the time it should take to do a full movement from -100 to 100 therefore 200%. This equals 2048 in recalculated internal range
-          if (tick10ms || !s_mixer_first_run_done) {
-            // only if already time is passed add or substract a value according the speed configured
-            int32_t rate = (int32_t) tick10ms << (DEL_MULT_SHIFT+11);  // = DEL_MULT*2048*tick10ms
-            // rate equals a full range for one second; if less time is passed rate is accordingly smaller
-            // if one second passed, rate would be 2048 (full motion)*256(recalculated weight)*100(100 ticks needed for one second)
-            int32_t currentValue = ((int32_t) v<<DEL_MULT_SHIFT);
-            if (diff > 0) {
-              if (s_mixer_first_run_done && md->speedUp > 0) {
-                // if a speed upwards is defined recalculate the new value according configured speed; the higher the speed the smaller the add value is
-                int32_t newValue = tact+rate/((int16_t)(100/SLOW_STEP)*md->speedUp);
-                if (newValue<currentValue) currentValue = newValue; // Endposition; prevent toggling around the destination
-              }
-            }
-            else {  // if is <0 because ==0 is not possible
-              if (s_mixer_first_run_done && md->speedDown > 0) {
-                // see explanation in speedUp
-                int32_t newValue = tact-rate/((int16_t)(100/SLOW_STEP)*md->speedDown);
-                if (newValue>currentValue) currentValue = newValue; // Endposition; prevent toggling around the destination
-              }
-            }
-            act[i] = tact = currentValue;
-            // open.20.fsguruh: this implementation would save about 50 bytes code
-          } // endif tick10ms ; in case no time passed assign the old value, not the current value from source
-          v = (tact >> DEL_MULT_SHIFT);
-        }
-      }
+  //========== INPUTS ===============
+  diff.heli = true; // the cyclic values are computed after the inputs
+  for (uint8_t i=0; i<MAX_EXPOS; i++) {
+    ExpoData * ed = expoAddress(i);
+    if (!EXPO_VALID(ed)) break; // end of list
+    if (isExpoLineFadeDependent(ed, fm, p, diff))
+      diff.inputs |= (uint32_t)1 << ed->chn;
+  }
+  if (diff.inputs) {
+    applyExpos(anas, e_perout_mode_inactive_flight_mode, 0, 0, diff.inputs);
+  }
 
-      //========== CURVES ===============
-#if defined(CPUARM)
-      if (apply_offset_and_curve && md->curve.type != CURVE_REF_DIFF && md->curve.value) {
-        v = applyCurve(v, md->curve);
-      }
+#if defined(HELI)
+  evalSwash();
+  diff.heli = memcmp(cyc_anas, fadeCycAnas, sizeof(cyc_anas));
 #else
-      if (apply_offset_and_curve && md->curveParam && md->curveMode == MODE_CURVE) {
-        v = applyCurve(v, md->curveParam);
-      }
-#endif
-
-      //========== WEIGHT ===============
-      int32_t dv = (int32_t)v * weight;
-#if defined(CPUARM)
-      dv = div_and_round(dv, 10);
+  diff.heli = false;
 #endif
 
-      //========== OFFSET / AFTER ===============
-      if (apply_offset_and_curve) {
-#if defined(CPUARM)
-        int32_t offset = GET_GVAR_PREC1(MD_OFFSET(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
-        if (offset) dv += div_and_round(calc100toRESX_16Bits(offset), 10) << 8;
-#else
-        int16_t offset = GET_GVAR(MD_OFFSET(md), GV_RANGELARGE_NEG, GV_RANGELARGE, mixerCurrentFlightMode);
-        if (offset) dv += int32_t(calc100toRESX_16Bits(offset)) << 8;
-#endif
-      }
+  //========== CHANNELS ===============
+  // the plan is sorted by dependencies, a source channel is always checked before the channels using it
+  for (const MixPlanLine * line = mixerPlan; line < mixerPlan + mixerPlanCount; line++) {
+    if (isMixLineFadeDependent(line, fm, p, diff))
+      diff.channels |= (bitfield_channels_t)1 << line->md->destCh;
+  }
 
-      //========== DIFFERENTIAL =========
-#if defined(CPUARM)
-      if (md->curve.type == CURVE_REF_DIFF && md->curve.value) {
-        dv = applyCurve(dv, md->curve);
-      }
-#else
-      if (md->curveMode == MODE_DIFFERENTIAL) {
-        // @@@2 also recalculate curveParam to a 256 basis which ease the calculation later a lot
-        int16_t curveParam = calc100to256(GET_GVAR(md->curveParam, -100, 100, mixerCurrentFlightMode));
-        if (curveParam > 0 && dv < 0)
-          dv = (dv * (256 - curveParam)) >> 8;
-        else if (curveParam < 0 && dv > 0)
-          dv = (dv * (256 + curveParam)) >> 8;
-      }
-#endif
+  uint8_t lv_mixWarning = 0;
+  for (uint8_t i=0; i<MAX_OUTPUT_CHANNELS; i++) {
+    if (diff.channels & ((bitfield_channels_t)1 << i))
+      chans[i] = 0;
+  }
+  for (const MixPlanLine * line = mixerPlan; line < mixerPlan + mixerPlanCount; line++) {
+    if (diff.channels & ((bitfield_channels_t)1 << line->md->destCh))
+      evalMixerPlanLine(line, e_perout_mode_inactive_flight_mode, 0, lv_mixWarning);
+  }
+}
 
-      int32_t * ptr = &chans[md->destCh]; // Save calculating address several times
+static void evalFlightModesFade(uint8_t fm, ACTIVE_PHASES_TYPE flightModesFade, const uint16_t * fp_act, uint8_t tick10ms, int32_t & weight)
+{
+  mixerCurrentFlightMode = fm;
+  evalFlightModeMixes(e_perout_mode_normal, tick10ms);
+  if (flightModesFade & ((ACTIVE_PHASES_TYPE)1 << fm)) {
+    sumFlightModeChans(fp_act[fm], weight);
+  }
 
-      switch (md->mltpx) {
-        case MLTPX_REP:
-          *ptr = dv;
-#if defined(BOLD_FONT)
-          if (mode==e_perout_mode_normal) {
-            for (uint8_t m=i-1; m<MAX_MIXERS && mixAddress(m)->destCh==md->destCh; m--)
-              swOn[m].activeMix = false;
-          }
+  memcpy(fadeChans, chans, sizeof(fadeChans));
+  memcpy(fadeAnas, anas, sizeof(fadeAnas));
+  memcpy(fadeInputsTrims, virtualInputsTrims, sizeof(fadeInputsTrims));
+  memcpy(fadeTrims, trims, sizeof(fadeTrims));
+#if defined(HELI)
+  memcpy(fadeCycAnas, cyc_anas, sizeof(fadeCycAnas));
 #endif
-          break;
-        case MLTPX_MUL:
-          // @@@2 we have to remove the weight factor of 256 in case of 100%; now we use the new base of 256
-          dv >>= 8;
-          dv *= *ptr;
-          dv >>= RESX_SHIFT;   // same as dv /= RESXl;
-          *ptr = dv;
-          break;
-        default: // MLTPX_ADD
-          *ptr += dv; //Mixer output add up to the line (dv + (dv>0 ? 100/2 : -100/2))/(100);
-          break;
-      } // endswitch md->mltpx
-#ifdef PREVENT_ARITHMETIC_OVERFLOW
-/*
-      // a lot of assumptions must be true, for this kind of check; not really worth for only 4 bytes flash savings
-      // this solution would save again 4 bytes flash
-      int8_t testVar=(*ptr<<1)>>24;
-      if ( (testVar!=-1) && (testVar!=0 ) ) {
-        // this devices by 64 which should give a good balance between still over 100% but lower then 32x100%; should be OK
-        *ptr >>= 6;  // this is quite tricky, reduces the value a lot but should be still over 100% and reduces flash need
-      } */
-
-
-      PACK( union u_int16int32_t {
-        struct {
-          int16_t lo;
-          int16_t hi;
-        } words_t;
-        int32_t dword;
-      });
-
-      u_int16int32_t tmp;
-      tmp.dword=*ptr;
-
-      if (tmp.dword<0) {
-        if ((tmp.words_t.hi&0xFF80)!=0xFF80) tmp.words_t.hi=0xFF86; // set to min nearly
+  uint8_t fmMixWarning = mixWarning;
+
+  for (uint8_t p=0; p<MAX_FLIGHT_MODES; p++) {
+    if (p != fm && (flightModesFade & ((ACTIVE_PHASES_TYPE)1 << p))) {
+      mixerCurrentFlightMode = p;
+      if (mixerPlanValid) {
+        evalFadingFlightModeMixes(fm, p);
       }
       else {
-        if ((tmp.words_t.hi|0x007F)!=0x007F) tmp.words_t.hi=0x0079; // set to max nearly
+        evalFlightModeMixes(e_perout_mode_inactive_flight_mode, 0);
       }
-      *ptr = tmp.dword;
-      // this implementation saves 18bytes flash
+      sumFlightModeChans(fp_act[p], weight);
 
-/*      dv=*ptr>>8;
-      if (dv>(32767-RESXl)) {
-        *ptr=(32767-RESXl)<<8;
-      } else if (dv<(-32767+RESXl)) {
-        *ptr=(-32767+RESXl)<<8;
-      }*/
-      // *ptr=limit( int32_t(int32_t(-1)<<23), *ptr, int32_t(int32_t(1)<<23));  // limit code cost 72 bytes
-      // *ptr=limit( int32_t((-32767+RESXl)<<8), *ptr, int32_t((32767-RESXl)<<8));  // limit code cost 80 bytes
+      memcpy(chans, fadeChans, sizeof(chans));
+      memcpy(anas, fadeAnas, sizeof(anas));
+      memcpy(virtualInputsTrims, fadeInputsTrims, sizeof(virtualInputsTrims));
+      memcpy(trims, fadeTrims, sizeof(trims));
+#if defined(HELI)
+      memcpy(cyc_anas, fadeCycAnas, sizeof(cyc_anas));
 #endif
+    }
+  }
 
-    } //endfor mixers
-
-    tick10ms = 0;
-    dirtyChannels &= passDirtyChannels;
-
-  } while (++pass < 5 && dirtyChannels);
-
-  mixWarning = lv_mixWarning;
+  mixWarning = fmMixWarning;
+  mixerCurrentFlightMode = fm;
 }
-
-int32_t sum_chans512[MAX_OUTPUT_CHANNELS] = {0};
+#endif
 
 
 #define MAX_ACT 0xffff
@@ -1191,17 +1634,19 @@ void evalMixes(uint8_t tick10ms)
   int32_t weight = 0;
   if (flightModesFade) {
     memclear(sum_chans512, sizeof(sum_chans512));
+#if defined(CPUARM) && defined(VIRTUAL_INPUTS)
+    evalFlightModesFade(fm, flightModesFade, fp_act, tick10ms, weight);
+#else
     for (uint8_t p=0; p<MAX_FLIGHT_MODES; p++) {
       LS_RECURSIVE_EVALUATION_RESET();
       if (flightModesFade & ((ACTIVE_PHASES_TYPE)1 << p)) {
         mixerCurrentFlightMode = p;
         evalFlightModeMixes(p==fm ? e_perout_mode_normal : e_perout_mode_inactive_flight_mode, p==fm ? tick10ms : 0);
-        for (uint8_t i=0; i<MAX_OUTPUT_CHANNELS; i++)
-          sum_chans512[i] += (chans[i] >> 4) * fp_act[p];
-        weight += fp_act[p];
+        sumFlightModeChans(fp_act[p], weight);
       }
       LS_RECURSIVE_EVALUATION_RESET();
     }
+#endif
     assert(weight);
     mixerCurrentFlightMode = fm;
   }
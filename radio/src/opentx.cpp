@@ -369,6 +369,7 @@ void defaultInputs()
 #endif
   }
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 #endif
 
@@ -396,6 +397,10 @@ void applyDefaultTemplate()
     mix->srcRaw = MIXSRC_Rud - 1 + channel_order(i+1);
 #endif
   }
+
+#if defined(CPUARM)
+  invalidateModelPlans();
+#endif
 }
 #endif
 
@@ -1432,24 +1437,6 @@ JitterMeter<uint16_t> avgJitter[NUM_ANALOGS];
 tmr10ms_t jitterResetTime = 0;
 #endif
 
-#if defined(VIRTUAL_INPUTS)
-  #define JITTER_FILTER_STRENGTH  4         // tune this value, bigger value - more filtering (range: 1-5) (see explanation below)
-  #define ANALOG_SCALE            1         // tune this value, bigger value - more filtering (range: 0-1) (see explanation below)
-
-  #define JITTER_ALPHA            (1<<JITTER_FILTER_STRENGTH)
-  #define ANALOG_MULTIPLIER       (1<<ANALOG_SCALE)
-  #define ANA_FILT(chan)          (s_anaFilt[chan] / (JITTER_ALPHA * ANALOG_MULTIPLIER))
-  #if (JITTER_ALPHA * ANALOG_MULTIPLIER > 32)
-    #error "JITTER_FILTER_STRENGTH and ANALOG_SCALE are too big, their summ should be <= 5 !!!"
-  #endif
-#else
-  #define ANALOG_SCALE            0
-  #define JITTER_ALPHA            1
-  #define ANALOG_MULTIPLIER       1
-  #define ANA_FILT(chan)          (s_anaFilt[chan])
-#endif
-
-
 #if !defined(SIMU)
 uint16_t anaIn(uint8_t chan)
 {
@@ -1492,91 +1479,25 @@ void getADC()
   adcRead();
   DEBUG_TIMER_STOP(debugTimerAdcRead);
 
-  for ( uint8_t x = 0; x < NUM_ANALOGS; x++ )
-  {
-    uint16_t v = 0;
-
-    if ( x < 4 )
-    {
-        #if defined(FLYSKY_HALL_STICKS)
-        v = get_hall_adc_value(x) >> (1 - ANALOG_SCALE);
-        #else
-        v = getAnalogValue(x) >> (1 - ANALOG_SCALE);
-        #endif
-    }
-    else
-    {
-        v = getAnalogValue(x) >> (1 - ANALOG_SCALE);
-    }
+  uint8_t x = 0;
+#if defined(FLYSKY_HALL_STICKS)
+  for (; x<NUM_STICKS; x++) {
+    analogs.raw[x] = get_hall_adc_value(x) >> (1 - ANALOG_SCALE);
+  }
+#endif
+  for (; x<NUM_ANALOGS; x++) {
+    analogs.raw[x] = getAnalogValue(x) >> (1 - ANALOG_SCALE);
+  }
 
-#if defined(VIRTUAL_INPUTS)
-    // Jitter filter:
-    //    * pass trough any big change directly
-    //    * for small change use Modified moving average (MMA) filter
-    //
-    // Explanation:
-    //
-    // Normal MMA filter has this formula:
-    //            <out> = ((ALPHA-1)*<out> + <in>)/ALPHA
-    //
-    // If calculation is done this way with integer arithmetics, then any small change in
-    // input signal is lost. One way to combat that, is to rearrange the formula somewhat,
-    // to store a more precise (larger) number between iterations. The basic idea is to
-    // store undivided value between iterations. Therefore an new variable <filtered> is
-    // used. The new formula becomes:
-    //           <filtered> = <filtered> - <filtered>/ALPHA + <in>
-    //           <out> = <filtered>/ALPHA  (use only when out is needed)
-    //
-    // The above formula with a maximum allowed ALPHA value (we are limited by
-    // the 16 bit s_anaFilt[]) was tested on the radio. The resulting signal still had
-    // some jitter (a value of 1 was observed). The jitter might be bigger on other
-    // radios.
-    //
-    // So another idea is to use larger input values for filtering. So instead of using
-    // input in a range from 0 to 2047, we use twice larger number (temp[x] is divided less)
-    //
-    // This also means that ALPHA must be lowered (remember 16 bit limit), but test results
-    // have proved that this kind of filtering gives better results. So the recommended values
-    // for filter are:
-    //     JITTER_FILTER_STRENGTH  4
-    //     ANALOG_SCALE            1
-    //
-    // Variables mapping:
-    //   * <in> = v
-    //   * <out> = s_anaFilt[x]
-    uint16_t previous = s_anaFilt[x] / JITTER_ALPHA;
-    uint16_t diff = (v > previous) ? (v - previous) : (previous - v);
-    if (!g_eeGeneral.jitterFilter && diff < (10*ANALOG_MULTIPLIER)) { // g_eeGeneral.jitterFilter is inverted, 0 - active
-      // apply jitter filter
-      s_anaFilt[x] = (s_anaFilt[x] - previous) + v;
-    }
-    else
-#endif  // #if defined(VIRTUAL_INPUTS)
-    {
-        //use unfiltered value
-      s_anaFilt[x] = v * JITTER_ALPHA;
-    }
+  processAnalogs(s_anaFilt);
 
 #if defined(JITTER_MEASURE)
-    if (JITTER_MEASURE_ACTIVE()) {
+  if (JITTER_MEASURE_ACTIVE()) {
+    for (x=0; x<NUM_ANALOGS; x++) {
       avgJitter[x].measure(ANA_FILT(x));
     }
+  }
 #endif
-
-    #define ANAFILT_MAX    (2 * RESX * JITTER_ALPHA * ANALOG_MULTIPLIER - 1)
-    StepsCalibData * calib = (StepsCalibData *) &g_eeGeneral.calib[x];
-    if (IS_POT_MULTIPOS(x) && IS_MULTIPOS_CALIBRATED(calib)) {
-      // TODO: consider adding another low pass filter to eliminate multipos switching glitches
-      uint8_t vShifted = ANA_FILT(x) >> 4;
-      s_anaFilt[x] = ANAFILT_MAX;
-      for (uint32_t i=0; i<calib->count; i++) {
-        if (vShifted < calib->steps[i]) {
-          s_anaFilt[x] = (i * ANAFILT_MAX) / calib->count;
-          break;
-        }
-      }
-    }
-  }//for ( uint8_t x = 0; x < NUM_ANALOGS; x++ )
 }
 #endif  // #if defined(CPUARM)
 
@@ -2018,6 +1939,8 @@ void opentxResume()
   // menuHandlers[0] = menuMainView;
 
   sdMount();
+  // the scripts may have been changed over USB
+  LUA_PRECOMPILE_SCRIPTS();
   storageReadAll();
 
 #if defined(COLORLCD)
@@ -2495,6 +2418,7 @@ void opentxInit(OPENTX_INIT_ARGS)
   if (!unexpectedShutdown) {
     sdInit();
     logsInit();
+    LUA_PRECOMPILE_SCRIPTS();
   }
 #endif
 
@@ -2593,7 +2517,12 @@ void opentxInit(OPENTX_INIT_ARGS)
   pwmCheck();
 #endif
 
+#if defined(SIMU)
+  // nobody is there to answer the splash and the startup warnings of the headless runner
+  if (!unexpectedShutdown && !simuVirtualClock) {
+#else
   if (!unexpectedShutdown) {
+#endif
     opentxStart();
   }
 
@@ -625,6 +625,9 @@ extern uint8_t flightModeTransitionLast;
 
 void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms);
 void evalMixes(uint8_t tick10ms);
+#if defined(CPUARM)
+void invalidateMixerPlan();
+#endif
 void doMixerCalculations();
 void scheduleNextMixerCalculation(uint8_t module, uint16_t delay);
 
@@ -649,6 +652,8 @@ void logicalSwitchesReset();
 #if defined(CPUARM)
   void evalLogicalSwitches(bool isCurrentPhase=true);
   void logicalSwitchesCopyState(uint8_t src, uint8_t dst);
+  void invalidateLogicalSwitchesPlan();
+  uint64_t logicalSwitchesStateDiff(uint8_t fm1, uint8_t fm2); // mask of the logical switches with a different state in both flight modes
   #define LS_RECURSIVE_EVALUATION_RESET()
 #else
   #define evalLogicalSwitches(xxx)
@@ -748,6 +753,58 @@ extern uint8_t unexpectedShutdown;
 
 extern uint16_t maxMixerDuration;
 
+#if defined(CPUARM)
+// Mixer task timings histograms, in log2 buckets: the bucket 0 counts the
+// 0us values, the bucket n the values from 2^(n-1) to 2^n-1 us, and the last
+// one all the longer values
+#define TIMING_HISTOGRAM_BUCKETS   16
+
+class TimingHistogram
+{
+  public:
+    void add(uint32_t value)
+    {
+      unsigned int bucket = 0;
+#if defined(__GNUC__)
+      if (value) {
+        bucket = 32 - __builtin_clz(value);
+      }
+#else
+      for (uint32_t v=value; v; v>>=1) {
+        bucket++;
+      }
+#endif
+      if (bucket >= TIMING_HISTOGRAM_BUCKETS) {
+        bucket = TIMING_HISTOGRAM_BUCKETS - 1;
+      }
+      buckets[bucket]++;
+      if (value > max) {
+        max = value;
+      }
+    }
+
+    uint32_t getCount(unsigned int bucket) const { return buckets[bucket]; }
+    uint32_t getMax() const { return max; }
+
+  protected:
+    uint32_t buckets[TIMING_HISTOGRAM_BUCKETS];
+    uint32_t max;
+};
+
+// the runs triggered by a module, and the ones done every 20ms when no
+// module needs them earlier
+#define MIXER_STATS_TIMEOUT        NUM_MODULES
+
+struct MixerStats {
+  TimingHistogram duration;  // of the mixer calculations and telemetry
+  TimingHistogram latency;   // from the nextMixerTime asked by scheduleNextMixerCalculation() to the run
+  TimingHistogram period;    // between two runs with the same trigger
+};
+
+extern MixerStats mixerStats[NUM_MODULES+1];
+void resetMixerStats();
+#endif
+
 #if !defined(CPUARM)
 extern uint8_t g_tmr1Latency_max;
 extern uint8_t g_tmr1Latency_min;
@@ -960,6 +1017,12 @@ int applyCurrentCurve(int x);
 int8_t getCurveX(int noPoints, int point);
 void resetCustomCurveX(int8_t * points, int noPoints);
 bool moveCurve(uint8_t index, int8_t shift); // TODO bool?
+#if defined(CURVES_LUT)
+#define MAX_CURVES_LUT 8
+#define MAX_EXPOS_LUT  8
+void invalidateCurvesLut();
+bool updateCurvesLut();
+#endif
 #else
 struct CurveInfo {
   int8_t * crv;
@@ -976,8 +1039,8 @@ bool moveCurve(uint8_t index, int8_t shift, int8_t custom=0);
 #endif
 
 #if defined(CPUARM)
-  #define APPLY_EXPOS_EXTRA_PARAMS_INC , uint8_t ovwrIdx=0, int16_t ovwrValue=0
-  #define APPLY_EXPOS_EXTRA_PARAMS     , uint8_t ovwrIdx, int16_t ovwrValue
+  #define APPLY_EXPOS_EXTRA_PARAMS_INC , uint8_t ovwrIdx=0, int16_t ovwrValue=0, uint32_t inputsMask=(uint32_t)-1
+  #define APPLY_EXPOS_EXTRA_PARAMS     , uint8_t ovwrIdx, int16_t ovwrValue, uint32_t inputsMask
 #else
   #define APPLY_EXPOS_EXTRA_PARAMS_INC
   #define APPLY_EXPOS_EXTRA_PARAMS
@@ -1132,10 +1195,11 @@ void evalFunctions();
 #include "telemetry/telemetry.h"
 
 #if defined(CPUARM)
-uint8_t crc8(const uint8_t * ptr, uint32_t len);
-uint16_t crc16(const uint8_t * ptr, uint32_t len);
+#include "crc.h"
 #endif
 
+#include "analogs.h"
+
 #define PLAY_REPEAT(x)            (x)                 /* Range 0 to 15 */
 #define PLAY_NOW                  0x10
 #define PLAY_BACKGROUND           0x20
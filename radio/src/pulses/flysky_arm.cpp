@@ -410,7 +410,7 @@ void usbSetFrameTransmit(uint8_t packetID, uint8_t *dataBuf, uint32_t nBytes)
         TRACE_NOCRLF("%02X ", rfProtocolRx.data[idx]);
     }
 #if !defined(SIMU)
-    uint16_t checkSum = calc_crc16(pt, rfProtocolRx.length+3);
+    uint16_t checkSum = crc16(CRC_1021, pt, rfProtocolRx.length+3, 0xFFFF);
     TRACE(" CRC:%04X;", checkSum);
 
     pt[rfProtocolRx.length + 3] = checkSum & 0xFF;
@@ -883,7 +883,7 @@ void checkFlySkyFeedback(uint8_t port)
             if((DEBUG_RF_FRAME_PRINT & RF_FRAME_ONLY)) {
 #if !defined(SIMU)
                 TRACE("RF: %02X %02X %02X ...%04X; CRC:%04X", pt[0], pt[1], pt[2],
-                      rfProtocolRx.checkSum, calc_crc16(pt, rfProtocolRx.length+3));
+                      rfProtocolRx.checkSum, crc16(CRC_1021, pt, rfProtocolRx.length+3, 0xFFFF));
 #endif
             }
 
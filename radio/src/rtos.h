@@ -29,14 +29,15 @@
   #include <pthread.h>
   #if __GNUC__
     #include <unistd.h>
-    inline void msleep(unsigned x)
-    {
-      usleep(1000 * x);
-    }
   #else
     #include <windows.h>
-    #define msleep(x) Sleep(x)
   #endif
+  // sleeps on the host clock, or only advances the simulator virtual clock
+  void simuSleep(unsigned ms);
+  inline void msleep(unsigned x)
+  {
+    simuSleep(x);
+  }
   #define RTOS_INIT()
   #define RTOS_WAIT_MS(x)               msleep(x)
   #define RTOS_WAIT_TICKS(x)            msleep((x)*2)
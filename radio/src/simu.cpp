@@ -572,6 +572,16 @@ void doFxEvents()
 
 int main(int argc,char **argv)
 {
+#if defined(LUA_COMPILER)
+  // offline tool: simu --precompile-lua <sdcard path>
+  // compiles the SD card scripts and writes their manifest, like the radio does at boot
+  if (argc >= 2 && !strcmp(argv[1], "--precompile-lua")) {
+    simuFatfsSetPaths(argc >= 3 ? argv[2] : NULL, NULL);
+    luaPrecompileScripts();
+    return 0;
+  }
+#endif
+
   // Each FOX GUI program needs one, and only one, application object.
   // The application objects coordinates some common stuff shared between
   // all the widgets; for example, it dispatches events, keeps track of
@@ -27,11 +27,22 @@
 #define MODELCELL_WIDTH                (LCD_W - 40)
 #define MODELCELL_HEIGHT               86
 
+// One record per model in RADIO_MODELSINDEX_PATH, validated against the
+// size and the FAT timestamps of the model file
+PACK(struct ModelIndexEntry {
+  char modelFilename[LEN_MODEL_FILENAME];
+  uint32_t fileSize;
+  uint16_t fileDate;
+  uint16_t fileTime;
+  ModelHeader header;
+});
+
 class ModelCell
 {
   public:
     ModelCell(const char * name):
-      buffer(NULL)
+      buffer(NULL),
+      valid(false)
     {
       strncpy(this->modelFilename, name, sizeof(this->modelFilename));
     }
@@ -64,7 +75,7 @@ class ModelCell
       if (strncmp(modelFilename, g_eeGeneral.currModelFilename, LEN_MODEL_FILENAME) == 0)
         header = g_model.header;
       else
-        error = readModel(modelFilename, (uint8_t *)&header, sizeof(header));
+        error = readHeader(header);
 
       buffer->clear(TEXT_BGCOLOR);
 
@@ -101,9 +112,18 @@ class ModelCell
       buffer->drawSolidHorizontalLine(0, 22, MODELCELL_WIDTH, LINE_COLOR);
     }
 
+    bool isUpToDate(const FILINFO & fno)
+    {
+      return valid && info.fileSize == fno.fsize && info.fileDate == fno.fdate && info.fileTime == fno.ftime;
+    }
+
+    const char * readHeader(ModelHeader & header);
+
     char modelFilename[LEN_MODEL_FILENAME+1];
     char modelName[LEN_MODEL_NAME+1];
     BitmapBuffer * buffer;
+    ModelIndexEntry info;
+    bool valid;
 };
 
 class ModelsCategory: public std::list<ModelCell *>
@@ -180,7 +200,9 @@ class ModelsCategory: public std::list<ModelCell *>
 class ModelsList
 {
   public:
-    ModelsList()
+    ModelsList():
+      indexLoaded(false),
+      indexDirty(false)
     {
     }
 
@@ -191,6 +213,11 @@ class ModelsList
 
     void clear()
     {
+      if (indexDirty) {
+        saveIndex();
+      }
+      indexLoaded = false;
+      indexDirty = false;
       for (std::list<ModelsCategory *>::iterator it = categories.begin(); it != categories.end(); ++it) {
         delete *it;
       }
@@ -241,6 +268,82 @@ class ModelsList
       return true;
     }
 
+    // Reads the index once, when the first model cell needs its header. Each
+    // record goes to all the cells of that file name, duplicates included
+    void loadIndex()
+    {
+      FIL indexFile;
+      ModelIndexEntry entry;
+      uint8_t buf[8];
+      UINT read;
+
+      if (indexLoaded) {
+        return;
+      }
+      indexLoaded = true;
+
+      if (f_open(&indexFile, RADIO_MODELSINDEX_PATH, FA_OPEN_EXISTING | FA_READ) != FR_OK) {
+        return;
+      }
+
+      if (f_read(&indexFile, buf, 8, &read) == FR_OK && read == 8 && *(uint32_t*)&buf[0] == OTX_FOURCC && buf[4] == EEPROM_VER && buf[5] == 'I' &&
+          f_size(&indexFile) == 8 + *(uint16_t*)&buf[6] * sizeof(ModelIndexEntry)) {
+        for (unsigned int i=0; i<*(uint16_t*)&buf[6]; i++) {
+          if (f_read(&indexFile, &entry, sizeof(entry), &read) != FR_OK || read != sizeof(entry)) {
+            break;
+          }
+          for (std::list<ModelsCategory *>::iterator cat = categories.begin(); cat != categories.end(); ++cat) {
+            for (ModelsCategory::iterator it = (*cat)->begin(); it != (*cat)->end(); ++it) {
+              if (!(*it)->valid && !strncmp((*it)->modelFilename, entry.modelFilename, LEN_MODEL_FILENAME)) {
+                (*it)->info = entry;
+                (*it)->valid = true;
+              }
+            }
+          }
+        }
+      }
+
+      f_close(&indexFile);
+    }
+
+    void saveIndex()
+    {
+      FIL indexFile;
+      uint8_t buf[8];
+      UINT written;
+      uint16_t count = 0;
+
+      if (f_open(&indexFile, RADIO_MODELSINDEX_PATH, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+        return;
+      }
+
+      // the count is written again once all the records are there
+      *(uint32_t*)&buf[0] = OTX_FOURCC;
+      buf[4] = EEPROM_VER;
+      buf[5] = 'I';
+      *(uint16_t*)&buf[6] = 0;
+      f_write(&indexFile, buf, 8, &written);
+
+      for (std::list<ModelsCategory *>::iterator cat = categories.begin(); cat != categories.end(); ++cat) {
+        for (ModelsCategory::iterator it = (*cat)->begin(); it != (*cat)->end(); ++it) {
+          if ((*it)->valid) {
+            if (f_write(&indexFile, &(*it)->info, sizeof(ModelIndexEntry), &written) != FR_OK || written != sizeof(ModelIndexEntry)) {
+              f_close(&indexFile);
+              return;
+            }
+            count++;
+          }
+        }
+      }
+
+      if (f_lseek(&indexFile, 6) == FR_OK) {
+        f_write(&indexFile, &count, sizeof(count), &written);
+      }
+
+      f_close(&indexFile);
+      indexDirty = false;
+    }
+
     unsigned int getModelIndex(ModelCell * model)
     {
       auto it = std::find(currentCategory->begin(), currentCategory->end(), model);
@@ -264,6 +367,10 @@ class ModelsList
       }
 
       f_close(&file);
+
+      if (indexDirty) {
+        saveIndex();
+      }
     }
 
     bool readNextLine(char * line, int maxlen)
@@ -330,9 +437,51 @@ class ModelsList
     ModelsCategory * currentCategory;
     ModelCell * currentModel;
     unsigned int modelsCount;
+    bool indexLoaded;
+    bool indexDirty;
 
   protected:
     FIL file;
 };
 
+extern ModelsList modelslist;
+
+// The header comes from the index while the model file keeps the same size
+// and timestamps, and from the file itself otherwise
+inline const char * ModelCell::readHeader(ModelHeader & header)
+{
+  char path[256];
+  FILINFO fno;
+
+  modelslist.loadIndex();
+
+  getModelPath(path, modelFilename);
+  if (f_stat(path, &fno) != FR_OK) {
+    valid = false;
+    return readModel(modelFilename, (uint8_t *)&header, sizeof(header));
+  }
+
+  if (isUpToDate(fno)) {
+    header = info.header;
+    return NULL;
+  }
+
+  const char * error = readModel(modelFilename, (uint8_t *)&header, sizeof(header));
+  if (error) {
+    valid = false;
+    return error;
+  }
+
+  TRACE("Models index: %s changed", modelFilename);
+  memset(&info, 0, sizeof(info));
+  strncpy(info.modelFilename, modelFilename, LEN_MODEL_FILENAME);
+  info.fileSize = fno.fsize;
+  info.fileDate = fno.fdate;
+  info.fileTime = fno.ftime;
+  info.header = header;
+  valid = true;
+  modelslist.indexDirty = true;
+  return NULL;
+}
+
 #endif // _MODELSLIST_H_
@@ -51,6 +51,9 @@ void storageReadAll();
 void storageDirty(uint8_t msk);
 void storageCheck(bool immediately);
 void storageFlushCurrentModel();
+#if defined(CPUARM)
+void invalidateModelPlans();
+#endif
 
 void preModelLoad();
 void postModelLoad(bool alarms);
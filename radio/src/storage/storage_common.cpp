@@ -39,6 +39,22 @@ void storageDirty(uint8_t msk)
 #endif
 }
 
+#if defined(CPUARM)
+// The inputs, mixes, curves, logical switches or sensors of the model were
+// edited, the plans compiled from them are rebuilt before their next use.
+// storageDirty(EE_MODEL) alone is enough for the values changed in flight
+// (trims, GVars, timers...)
+void invalidateModelPlans()
+{
+  invalidateMixerPlan();
+  invalidateLogicalSwitchesPlan();
+  invalidateTelemetrySensors();
+#if defined(CURVES_LUT)
+  invalidateCurvesLut();
+#endif
+}
+#endif
+
 void preModelLoad()
 {
 #if defined(CPUARM)
@@ -88,6 +104,10 @@ void postModelLoad(bool alarms)
 
   LOAD_MODEL_CURVES();
 
+#if defined(CPUARM)
+  invalidateModelPlans();
+#endif
+
   resumeMixerCalculations();
   if (pulsesStarted()) {
 #if defined(GUI)
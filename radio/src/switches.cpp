@@ -565,24 +565,154 @@ bool getSwitch(swsrc_t swtch)
 }
 
 #if defined(CPUARM)
+/*
+ * Logical switches plan
+ *
+ * The logical switches are compiled at model load into the list of the used ones, each with
+ * the mask of the logical switches it reads. A logical switch reading itself or one which
+ * comes after it gets the state of the previous pass, so the index order is a topological
+ * order of the dependencies inside a pass, and loops are broken the same way as before.
+ *
+ * A logical switch is evaluated again only when
+ *  - it reads a value, a physical switch or anything else the plan doesn't track
+ *  - one of the logical switches it reads changed during this pass or the previous one
+ *  - it uses the 100ms timer (timer, sticky, edge, delay or duration) and the timer ticked
+ * otherwise it would give the same result and its state is kept.
+ *
+ * So the pass only gets cheaper for the boolean switches of logical switches and for the
+ * timer based ones. Comparisons (a~x, a>x, a=b, d>=x...) and the switches reading a physical
+ * switch, a flight mode or a sensor are evaluated at each pass, as before: the sources changes
+ * aren't tracked, and reading the sources to find out is most of their evaluation cost.
+ */
+
+struct LogicalSwitchesPlan {
+  uint8_t count;
+  uint8_t order[MAX_LOGICAL_SWITCHES];
+  uint64_t dependencies[MAX_LOGICAL_SWITCHES];
+  uint64_t volatileSwitches;   // evaluated at each pass
+  uint64_t timerSwitches;      // evaluated after each timer tick
+};
+
+static LogicalSwitchesPlan lswPlan;
+static bool lswPlanDirty = true;
+static uint64_t lswChanged[MAX_FLIGHT_MODES];   // logical switches changed during the last pass of each flight mode
+static uint16_t lswEvaluatedModes = 0;          // flight modes evaluated since the plan was compiled
+static uint16_t lswTimerPendingModes = 0;       // flight modes not evaluated since the last timer tick
+
+void invalidateLogicalSwitchesPlan()
+{
+  lswPlanDirty = true;
+}
+
+// Returns false when the switch state isn't tracked by the plan
+static bool addLogicalSwitchDependency(swsrc_t swtch, uint64_t & dependencies)
+{
+  int idx = abs(swtch);
+  if (idx == SWSRC_NONE || idx == SWSRC_ON) {
+    return true;
+  }
+  else if (idx >= SWSRC_FIRST_LOGICAL_SWITCH && idx <= SWSRC_LAST_LOGICAL_SWITCH) {
+    dependencies |= (uint64_t)1 << (idx - SWSRC_FIRST_LOGICAL_SWITCH);
+    return true;
+  }
+  else {
+    return false;
+  }
+}
+
+static void compileLogicalSwitchesPlan()
+{
+  lswPlanDirty = false;
+  lswEvaluatedModes = 0;
+  memclear(&lswPlan, sizeof(lswPlan));
+
+  for (uint8_t idx=0; idx<MAX_LOGICAL_SWITCHES; idx++) {
+    LogicalSwitchData * ls = lswAddress(idx);
+    if (ls->func == LS_FUNC_NONE)
+      continue;
+
+    uint64_t mask = (uint64_t)1 << idx;
+    uint64_t & dependencies = lswPlan.dependencies[idx];
+    uint8_t family = lswFamily(ls->func);
+    bool tracked = addLogicalSwitchDependency(ls->andsw, dependencies);
+
+    if (family == LS_FAMILY_BOOL) {
+      if (!addLogicalSwitchDependency(ls->v1, dependencies))
+        tracked = false;
+      if (!addLogicalSwitchDependency(ls->v2, dependencies))
+        tracked = false;
+    }
+    else if (family == LS_FAMILY_TIMER || family == LS_FAMILY_STICKY || family == LS_FAMILY_EDGE) {
+      // the state is updated by logicalSwitchesTimerTick()
+      lswPlan.timerSwitches |= mask;
+    }
+    else {
+      tracked = false;
+    }
+
+    if (ls->delay || ls->duration)
+      lswPlan.timerSwitches |= mask;
+    if (!tracked)
+      lswPlan.volatileSwitches |= mask;
+
+    lswPlan.order[lswPlan.count++] = idx;
+  }
+}
+
+static bool updateLogicalSwitch(uint8_t idx, bool isCurrentPhase)
+{
+  LogicalSwitchContext & context = lswFm[mixerCurrentFlightMode].lsw[idx];
+  bool result = getLogicalSwitch(idx);
+  if (result == context.state)
+    return false;
+  if (isCurrentPhase) {
+    if (result)
+      PLAY_LOGICAL_SWITCH_ON(idx);
+    else
+      PLAY_LOGICAL_SWITCH_OFF(idx);
+  }
+  context.state = result;
+  return true;
+}
+
 /**
   @brief Calculates new state of logical switches for mixerCurrentFlightMode
 */
 void evalLogicalSwitches(bool isCurrentPhase)
 {
-  for (unsigned int idx=0; idx<MAX_LOGICAL_SWITCHES; idx++) {
-    LogicalSwitchContext & context = lswFm[mixerCurrentFlightMode].lsw[idx];
-    bool result = getLogicalSwitch(idx);
-    if (isCurrentPhase) {
-      if (result) {
-        if (!context.state) PLAY_LOGICAL_SWITCH_ON(idx);
-      }
-      else {
-        if (context.state) PLAY_LOGICAL_SWITCH_OFF(idx);
+  if (lswPlanDirty) {
+    compileLogicalSwitchesPlan();
+  }
+
+  uint8_t fm = mixerCurrentFlightMode;
+  uint16_t fmMask = 1 << fm;
+  uint64_t changed = 0;
+
+  if (!(lswEvaluatedModes & fmMask)) {
+    // first pass with this plan, the unused logical switches are turned off
+    for (uint8_t idx=0; idx<MAX_LOGICAL_SWITCHES; idx++) {
+      if (updateLogicalSwitch(idx, isCurrentPhase))
+        changed |= (uint64_t)1 << idx;
+    }
+    lswEvaluatedModes |= fmMask;
+  }
+  else {
+    uint64_t updated = lswPlan.volatileSwitches;
+    if (lswTimerPendingModes & fmMask)
+      updated |= lswPlan.timerSwitches;
+    uint64_t previousChanges = lswChanged[fm];
+    for (uint8_t i=0; i<lswPlan.count; i++) {
+      uint8_t idx = lswPlan.order[i];
+      uint64_t mask = (uint64_t)1 << idx;
+      if ((updated & mask) || (lswPlan.dependencies[idx] & (changed | previousChanges))) {
+        if (updateLogicalSwitch(idx, isCurrentPhase))
+          changed |= mask;
       }
     }
-    context.state = result;
   }
+
+  lswTimerPendingModes &= ~fmMask;
+  lswChanged[fm] = changed;
 }
 #endif
 
@@ -869,6 +999,7 @@ void checkSwitches()
 void logicalSwitchesTimerTick()
 {
 #if defined(CPUARM)
+  lswTimerPendingModes = (1 << MAX_FLIGHT_MODES) - 1;
   for (uint8_t fm=0; fm<MAX_FLIGHT_MODES; fm++) {
 #endif
     for (uint8_t i=0; i<MAX_LOGICAL_SWITCHES; i++) {
@@ -978,6 +1109,7 @@ void logicalSwitchesReset()
 #if defined(CPUARM)
   flightModeTransitionLast = 255;
   memset(lswFm, 0, sizeof(lswFm));
+  lswEvaluatedModes = 0;
 #else
   s_last_switch_value = 0;
 #endif
@@ -1011,5 +1143,17 @@ getvalue_t convertLswTelemValue(LogicalSwitchData * ls)
 void logicalSwitchesCopyState(uint8_t src, uint8_t dst)
 {
   lswFm[dst] = lswFm[src];
+  lswEvaluatedModes &= ~(1 << dst);
+}
+
+uint64_t logicalSwitchesStateDiff(uint8_t fm1, uint8_t fm2)
+{
+  uint64_t result = 0;
+  for (uint8_t i=0; i<MAX_LOGICAL_SWITCHES; i++) {
+    if (lswFm[fm1].lsw[i].state != lswFm[fm2].lsw[i].state) {
+      result |= (uint64_t)1 << i;
+    }
+  }
+  return result;
 }
 #endif
@@ -294,8 +294,12 @@ DRESULT disk_ioctl (
       break;
 
     case CTRL_SYNC:
-      while (SD_GetStatus() == SD_TRANSFER_BUSY); /* Complete pending write process (needed at _FS_READONLY == 0) */
+#if defined(DISK_CACHE)
+      res = diskCache.flush(drv);   /* Write the coalesced sectors */
+#else
       res = RES_OK;
+#endif
+      while (SD_GetStatus() == SD_TRANSFER_BUSY); /* Complete pending write process (needed at _FS_READONLY == 0) */
       break;
 
     default:
@@ -230,3 +230,28 @@ uint8_t telemetryGetByte(uint8_t * byte)
   return telemetryNoDMAFifo.pop(*byte);
 #endif
 }
+
+// the received bytes which can be read in place, released by telemetryReleaseBuffer()
+uint32_t telemetryGetBuffer(const uint8_t ** buffer)
+{
+#if defined(PCBX12S)
+  if (telemetryFifoMode & TELEMETRY_SERIAL_WITHOUT_DMA)
+    return telemetryNoDMAFifo.probeSpan(*buffer);
+  else
+    return telemetryDMAFifo.probeSpan(*buffer);
+#else
+  return telemetryNoDMAFifo.probeSpan(*buffer);
+#endif
+}
+
+void telemetryReleaseBuffer(uint32_t count)
+{
+#if defined(PCBX12S)
+  if (telemetryFifoMode & TELEMETRY_SERIAL_WITHOUT_DMA)
+    telemetryNoDMAFifo.skip(count);
+  else
+    telemetryDMAFifo.skip(count);
+#else
+  telemetryNoDMAFifo.skip(count);
+#endif
+}
@@ -195,3 +195,36 @@ uint8_t telemetryGetByte(uint8_t * byte)
   return telemetryFifo.pop(*byte);
 #endif
 }
+
+// the received bytes which can be read in place, released by telemetryReleaseBuffer()
+uint32_t telemetryGetBuffer(const uint8_t ** buffer)
+{
+#if defined(AUX_SERIAL)
+  if (telemetryProtocol == PROTOCOL_FRSKY_D_SECONDARY) {
+    if (auxSerialMode == UART_MODE_TELEMETRY)
+      return auxSerialRxFifo.probeSpan(*buffer);
+    else
+      return 0;
+  }
+  else {
+    return telemetryFifo.probeSpan(*buffer);
+  }
+#else
+  return telemetryFifo.probeSpan(*buffer);
+#endif
+}
+
+void telemetryReleaseBuffer(uint32_t count)
+{
+#if defined(AUX_SERIAL)
+  if (telemetryProtocol == PROTOCOL_FRSKY_D_SECONDARY) {
+    if (auxSerialMode == UART_MODE_TELEMETRY)
+      auxSerialRxFifo.skip(count);
+  }
+  else {
+    telemetryFifo.skip(count);
+  }
+#else
+  telemetryFifo.skip(count);
+#endif
+}
@@ -81,8 +81,14 @@ void toplcdOff()
 {
 }
 
+bool simuVirtualClock = false;
+uint64_t simuVirtualMicros = 0;
+
 uint64_t simuTimerMicros(void)
 {
+  if (simuVirtualClock)
+    return simuVirtualMicros;
+
 #if SIMPGMSPC_USE_QT
 
   static QElapsedTimer ticker;
@@ -119,6 +125,30 @@ uint64_t simuTimerMicros(void)
 #endif
 }
 
+void simuAdvanceClock(uint32_t micros)
+{
+  // the 10ms interrupt fires each time the virtual clock crosses a 10ms boundary
+  uint64_t target = simuVirtualMicros + micros;
+  while (target / 10000 > simuVirtualMicros / 10000) {
+    simuVirtualMicros = (simuVirtualMicros / 10000 + 1) * 10000;
+    per10ms();
+  }
+  simuVirtualMicros = target;
+}
+
+void simuSleep(unsigned ms)
+{
+  if (simuVirtualClock) {
+    simuAdvanceClock(ms * 1000);
+    return;
+  }
+#if defined(_MSC_VER) || !defined(__GNUC__)
+  Sleep(ms);
+#else
+  usleep(1000 * ms);
+#endif
+}
+
 uint16_t getTmr16KHz()
 {
   return simuTimerMicros() * 2 / 125;
@@ -365,6 +365,11 @@ extern char * main_thread_error;
 
 uint64_t simuTimerMicros(void);
 
+// virtual clock used by the headless runner: time only moves with simuAdvanceClock()
+extern bool simuVirtualClock;
+extern uint64_t simuVirtualMicros;
+void simuAdvanceClock(uint32_t micros);
+
 void simuInit();
 void StartSimu(bool tests=true, const char * sdPath = 0, const char * settingsPath = 0);
 void StopSimu();
@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Headless simulator runner
+ *
+ * Runs the firmware in a single thread on a virtual clock, as fast as the host
+ * can, driven by a script file. Two runs of the same script on the same SD card
+ * give the same output, which makes it usable for regression tests.
+ *
+ * Usage: simu-runner [--sd <dir>] [--settings <dir>] [--eeprom <file>] [--output <file>] <script>
+ *
+ * Script commands, one per line, '#' starts a comment:
+ *   analog <index> <value>        analog input value (-1024..1024 for sticks, pots and sliders)
+ *   switch <index> <state>        physical switch position (-1, 0, 1)
+ *   key <index> <0|1>             key released / pressed
+ *   trim <index> <0|1>            trim button released / pressed
+ *   telemetry <hex bytes>         bytes received on the telemetry port ("7E 98 10 ...")
+ *   model <name>                  load a model (file name on SD card radios, index on EEPROM radios)
+ *   wait <ticks>                  run the firmware for <ticks> x 10ms
+ *   dump channels                 write the channel outputs
+ *   dump switches                 write the logical switches states
+ *   dump lcd <file>               write the screen to a .ppm (color) or .pgm (monochrome) file
+ *
+ * Each dump line starts with the current tick number.
+ * The firmware writes the settings and models back as on the radio, CI jobs should run on a copy of the SD card.
+ */
+
+#include "opentx.h"
+#include "simulcd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RUNNER_PERMAIN_PERIOD          2    // perMain() every 20ms, as the menus task
+#define RUNNER_LINE_MAX                512
+
+int16_t g_anas[NUM_ANALOGS];
+
+uint16_t anaIn(uint8_t chan)
+{
+  return g_anas[chan];
+}
+
+uint16_t getAnalogValue(uint8_t index)
+{
+  return anaIn(index);
+}
+
+static uint32_t runnerTicks = 0;
+static FILE * runnerOutput = NULL;
+
+static void runnerTick()
+{
+  simuAdvanceClock(10000);
+  doMixerCalculations();
+#if defined(TELEMETRY_FRSKY) || defined(TELEMETRY_MAVLINK)
+  telemetryWakeup();
+#endif
+  if (++runnerTicks % RUNNER_PERMAIN_PERIOD == 0) {
+    perMain();
+  }
+}
+
+static void dumpChannels()
+{
+  fprintf(runnerOutput, "%u channels", runnerTicks);
+  for (int i=0; i<MAX_OUTPUT_CHANNELS; i++) {
+    fprintf(runnerOutput, " %d", channelOutputs[i]);
+  }
+  fprintf(runnerOutput, "\n");
+}
+
+static void dumpLogicalSwitches()
+{
+  fprintf(runnerOutput, "%u switches ", runnerTicks);
+  for (int i=0; i<MAX_LOGICAL_SWITCHES; i++) {
+    fputc(getSwitch(SWSRC_FIRST_LOGICAL_SWITCH + i) ? '1' : '0', runnerOutput);
+  }
+  fprintf(runnerOutput, "\n");
+}
+
+static bool dumpLcd(const char * filename)
+{
+  FILE * f = fopen(filename, "wb");
+  if (!f) {
+    perror(filename);
+    return false;
+  }
+
+#if defined(COLORLCD)
+  fprintf(f, "P6\n%d %d\n255\n", LCD_W, LCD_H);
+  for (int i=0; i<LCD_W*LCD_H; i++) {
+    display_t z = simuLcdBuf[i];
+    uint8_t rgb[3] = { uint8_t(255*((z&0xF800)>>11)/0x1F), uint8_t(255*((z&0x07E0)>>5)/0x3F), uint8_t(255*(z&0x001F)/0x1F) };
+    fwrite(rgb, 1, 3, f);
+  }
+#else
+  fprintf(f, "P5\n%d %d\n255\n", LCD_W, LCD_H);
+  for (int y=0; y<LCD_H; y++) {
+    for (int x=0; x<LCD_W; x++) {
+#if LCD_W >= 212
+      display_t z = simuLcdBuf[y / 2 * LCD_W + x];
+      uint8_t level = (y & 1) ? (z >> 4) : (z & 0x0F);
+      uint8_t gray = 255 - level * 255 / 15;
+#else
+      uint8_t gray = (simuLcdBuf[x+(y/8)*LCD_W] & (1<<(y%8))) ? 0 : 255;
+#endif
+      fputc(gray, f);
+    }
+  }
+#endif
+
+  fclose(f);
+  fprintf(runnerOutput, "%u lcd %s\n", runnerTicks, filename);
+  return true;
+}
+
+static bool runnerTelemetry(char * args)
+{
+  uint8_t buffer[RUNNER_LINE_MAX / 2];
+  uint32_t count = 0;
+
+  for (char * token = strtok(args, " \t"); token; token = strtok(NULL, " \t")) {
+    char * end;
+    unsigned long value = strtoul(token, &end, 16);
+    if (*end || value > 0xFF)
+      return false;
+    buffer[count++] = value;
+  }
+
+#if defined(STM32)
+  processTelemetryBuffer(buffer, count);
+#else
+  for (uint32_t i=0; i<count; i++) {
+    processTelemetryData(buffer[i]);
+  }
+#endif
+  return true;
+}
+
+static bool runnerCommand(char * line)
+{
+  char * command = strtok(line, " \t");
+  char * args = strtok(NULL, "");
+  int index, value;
+
+  if (!strcmp(command, "analog") && args && sscanf(args, "%d %d", &index, &value) == 2 && index >= 0 && index < NUM_ANALOGS) {
+    g_anas[index] = value;
+  }
+  else if (!strcmp(command, "switch") && args && sscanf(args, "%d %d", &index, &value) == 2 && index >= 0 && index < NUM_PSWITCH) {
+    simuSetSwitch(index, value);
+  }
+  else if (!strcmp(command, "key") && args && sscanf(args, "%d %d", &index, &value) == 2 && index >= 0 && index < NUM_KEYS) {
+    simuSetKey(index, value);
+  }
+  else if (!strcmp(command, "trim") && args && sscanf(args, "%d %d", &index, &value) == 2 && index >= 0 && index < NUM_TRIMS*2) {
+    simuSetTrim(index, value);
+  }
+  else if (!strcmp(command, "telemetry") && args) {
+    return runnerTelemetry(args);
+  }
+  else if (!strcmp(command, "model") && args) {
+#if defined(EEPROM)
+    loadModel(atoi(args));
+#else
+    const char * error = loadModel(args);
+    if (error) {
+      fprintf(stderr, "model %s: %s\n", args, error);
+      return false;
+    }
+#endif
+  }
+  else if (!strcmp(command, "wait") && args && sscanf(args, "%d", &value) == 1 && value >= 0) {
+    while (value--) {
+      runnerTick();
+    }
+  }
+  else if (!strcmp(command, "dump") && args) {
+    char * what = strtok(args, " \t");
+    char * filename = strtok(NULL, " \t");
+    if (!strcmp(what, "channels"))
+      dumpChannels();
+    else if (!strcmp(what, "switches"))
+      dumpLogicalSwitches();
+    else if (!strcmp(what, "lcd") && filename)
+      return dumpLcd(filename);
+    else
+      return false;
+  }
+  else {
+    return false;
+  }
+
+  return true;
+}
+
+static int runScript(const char * filename)
+{
+  FILE * f = fopen(filename, "r");
+  if (!f) {
+    perror(filename);
+    return 1;
+  }
+
+  char line[RUNNER_LINE_MAX];
+  int lineNumber = 0;
+  while (fgets(line, sizeof(line), f)) {
+    lineNumber++;
+    char * comment = strchr(line, '#');
+    if (comment)
+      *comment = '\0';
+    line[strcspn(line, "\r\n")] = '\0';
+    if (!line[strspn(line, " \t")])
+      continue;
+    if (!runnerCommand(line)) {
+      fprintf(stderr, "%s:%d: invalid command\n", filename, lineNumber);
+      fclose(f);
+      return 1;
+    }
+  }
+
+  fclose(f);
+  return 0;
+}
+
+int main(int argc, char ** argv)
+{
+  const char * sdPath = NULL;
+  const char * settingsPath = NULL;
+  const char * eepromFile = NULL;
+  const char * outputFile = NULL;
+  const char * scriptFile = NULL;
+
+  for (int i=1; i<argc; i++) {
+    if (!strcmp(argv[i], "--sd") && i+1 < argc)
+      sdPath = argv[++i];
+    else if (!strcmp(argv[i], "--settings") && i+1 < argc)
+      settingsPath = argv[++i];
+    else if (!strcmp(argv[i], "--eeprom") && i+1 < argc)
+      eepromFile = argv[++i];
+    else if (!strcmp(argv[i], "--output") && i+1 < argc)
+      outputFile = argv[++i];
+    else if (!scriptFile && argv[i][0] != '-')
+      scriptFile = argv[i];
+    else {
+      scriptFile = NULL;
+      break;
+    }
+  }
+
+  if (!scriptFile) {
+    fprintf(stderr, "Usage: %s [--sd <dir>] [--settings <dir>] [--eeprom <file>] [--output <file>] <script>\n", argv[0]);
+    return 1;
+  }
+
+  runnerOutput = outputFile ? fopen(outputFile, "w") : stdout;
+  if (!runnerOutput) {
+    perror(outputFile);
+    return 1;
+  }
+
+  // everything which could differ between two runs is fixed here
+  simuVirtualClock = true;
+  simuVirtualMicros = 0;
+  srand(0);
+#if defined(RTCLOCK)
+  g_rtcTime = 1500000000;
+#endif
+  g_tmr10ms = 1;
+  s_current_protocol[0] = 255;
+  menuLevel = 0;
+
+  simuInit();
+  simuFatfsSetPaths(sdPath, settingsPath);
+#if defined(EEPROM)
+  StartEepromThread(eepromFile);
+#else
+  UNUSED(eepromFile);
+#endif
+
+  boardInit();
+  opentxInit();
+
+  int result = runScript(scriptFile);
+
+#if defined(EEPROM)
+  StopEepromThread();
+#endif
+  if (runnerOutput != stdout)
+    fclose(runnerOutput);
+  return result;
+}
@@ -570,6 +570,8 @@ void telemetryPortInit(uint32_t baudrate, uint8_t mode);
 void telemetryPortSetDirectionOutput(void);
 void sportSendBuffer(uint8_t * buffer, uint32_t count);
 uint8_t telemetryGetByte(uint8_t * byte);
+uint32_t telemetryGetBuffer(const uint8_t ** buffer);
+void telemetryReleaseBuffer(uint32_t count);
 extern uint32_t telemetryErrors;
 
 // PCBREV driver
@@ -30,6 +30,11 @@ RTOS_DEFINE_STACK(mixerStack, MIXER_STACK_SIZE);
 RTOS_TASK_HANDLE audioTaskId;
 RTOS_DEFINE_STACK(audioStack, AUDIO_STACK_SIZE);
 
+#if defined(LOGS_BINARY)
+RTOS_TASK_HANDLE logsTaskId;
+RTOS_DEFINE_STACK(logsStack, LOGS_STACK_SIZE);
+#endif
+
 RTOS_MUTEX_HANDLE audioMutex;
 RTOS_MUTEX_HANDLE mixerMutex;
 
@@ -51,6 +56,9 @@ void stackPaint()
   menusStack.paint();
   mixerStack.paint();
   audioStack.paint();
+#if defined(LOGS_BINARY)
+  logsStack.paint();
+#endif
 #if defined(CLI)
   cliStack.paint();
 #endif
@@ -81,6 +89,57 @@ bool isForcePowerOffRequested()
 }
 
 uint32_t nextMixerTime[NUM_MODULES];
+static uint16_t mixerScheduleTmr[NUM_MODULES];
+static uint32_t mixerScheduleTime[NUM_MODULES];
+
+MixerStats mixerStats[NUM_MODULES+1];
+static volatile bool mixerStatsResetRequest;
+
+// the stats are reset by the mixer task itself, before its next run
+void resetMixerStats()
+{
+  mixerStatsResetRequest = true;
+}
+
+// Time between two (2MHz timer, RTOS time) pairs, in us. The 2MHz timer wraps
+// every 32ms, the RTOS time is used for the longer ones.
+static uint32_t getMixerStatsElapsed(uint16_t tmrFrom, uint32_t timeFrom, uint16_t tmrTo, uint32_t timeTo)
+{
+  if (timeTo - timeFrom < 16)
+    return uint16_t(tmrTo - tmrFrom) / 2;
+  else
+    return (timeTo - timeFrom) * 2000;
+}
+
+static void mixerStatsStart(uint8_t trigger, uint16_t start, uint32_t now)
+{
+  static bool started[NUM_MODULES+1];
+  static uint16_t lastStart[NUM_MODULES+1];
+  static uint32_t lastRunTime[NUM_MODULES+1];
+
+  if (mixerStatsResetRequest) {
+    mixerStatsResetRequest = false;
+    memclear(mixerStats, sizeof(mixerStats));
+    memclear(started, sizeof(started));
+  }
+
+  MixerStats & stats = mixerStats[trigger];
+
+  if (trigger != MIXER_STATS_TIMEOUT) {
+    // the lateness against nextMixerTime, not the delay asked for
+    uint32_t elapsed = getMixerStatsElapsed(mixerScheduleTmr[trigger], mixerScheduleTime[trigger], start, now);
+    uint32_t delay = (nextMixerTime[trigger] - mixerScheduleTime[trigger]) * 2000;
+    stats.latency.add(elapsed > delay ? elapsed - delay : 0);
+  }
+
+  if (started[trigger]) {
+    stats.period.add(getMixerStatsElapsed(lastStart[trigger], lastRunTime[trigger], start, now));
+  }
+
+  started[trigger] = true;
+  lastStart[trigger] = start;
+  lastRunTime[trigger] = now;
+}
 
 TASK_FUNCTION(mixerTask)
 {
@@ -106,6 +165,7 @@ TASK_FUNCTION(mixerTask)
 
     uint32_t now = RTOS_GET_TIME();
     bool run = false;
+    uint8_t trigger = MIXER_STATS_TIMEOUT;
 #if !defined(SIMU) && defined(STM32)
     if ((now - lastRunTime) >= (usbStarted() ? 5 : 10)) {     // run at least every 20ms (every 10ms if USB is active)
 #else
@@ -115,10 +175,12 @@ TASK_FUNCTION(mixerTask)
     }
     else if (now == nextMixerTime[0]) {
       run = true;
+      trigger = 0;
     }
 #if NUM_MODULES >= 2
     else if (now == nextMixerTime[1]) {
       run = true;
+      trigger = 1;
     }
 #endif
     if (!run) {
@@ -129,6 +191,7 @@ TASK_FUNCTION(mixerTask)
 
     if (!s_pulses_paused) {
       uint16_t t0 = getTmr2MHz();
+      mixerStatsStart(trigger, t0, now);
 
       DEBUG_TIMER_START(debugTimerMixer);
       RTOS_LOCK_MUTEX(mixerMutex);
@@ -159,6 +222,7 @@ TASK_FUNCTION(mixerTask)
         heartbeat = 0;
       }
 
+      mixerStats[trigger].duration.add(getMixerStatsElapsed(t0, now, getTmr2MHz(), RTOS_GET_TIME()));
       t0 = getTmr2MHz() - t0;
       if (t0 > maxMixerDuration) maxMixerDuration = t0 ;
     }
@@ -169,7 +233,9 @@ void scheduleNextMixerCalculation(uint8_t module, uint16_t delay)
 {
   // Schedule next mixer calculation time,
   // for now assume mixer calculation takes 2 ms.
-  nextMixerTime[module] = (uint32_t)RTOS_GET_TIME() + (delay)/2 - 1/*2ms*/;
+  mixerScheduleTmr[module] = getTmr2MHz();
+  mixerScheduleTime[module] = (uint32_t)RTOS_GET_TIME();
+  nextMixerTime[module] = mixerScheduleTime[module] + (delay)/2 - 1/*2ms*/;
   DEBUG_TIMER_STOP(debugTimerMixerCalcToUsage);
 }
 
@@ -296,6 +362,11 @@ void tasksStart()
 
   RTOS_CREATE_MUTEX(audioMutex);
   RTOS_CREATE_MUTEX(mixerMutex);
+  RTOS_CREATE_MUTEX(telemetryMutex);
+#if defined(LOGS_BINARY)
+  RTOS_CREATE_MUTEX(logsMutex);
+  RTOS_CREATE_TASK(logsTaskId, logsTask, "Logs", logsStack, LOGS_STACK_SIZE, LOGS_TASK_PRIO);
+#endif
 
   RTOS_CREATE_FLAG(openTxInitCompleteFlag);
 
@@ -27,6 +27,7 @@
 #define MENUS_STACK_SIZE       3000
 #define MIXER_STACK_SIZE       500 //504
 #define AUDIO_STACK_SIZE       500
+#define LOGS_STACK_SIZE        400
 #define TOUCH_STACK_SIZE       400  // TODO: this can be reduced a lot after debug (tracing) is done (on last check only 42 Words are actually used)
 #define BLUETOOTH_STACK_SIZE   504  // WTF: there is no BT task.... ???
 
@@ -34,6 +35,7 @@
 #define AUDIO_TASK_PRIO        7
 #define MENUS_TASK_PRIO        10
 #define CLI_TASK_PRIO          10
+#define LOGS_TASK_PRIO         11   // lower prio than GUI, SD card writes are not time critical
 #define TOUCH_TASK_PRIO        12   // lower prio than GUI! otherwise may block (runs at 1 tick)
 
 extern RTOS_TASK_HANDLE menusTaskId;
@@ -45,6 +47,14 @@ extern RTOS_DEFINE_STACK(mixerStack, MIXER_STACK_SIZE);
 extern RTOS_TASK_HANDLE audioTaskId;
 extern RTOS_DEFINE_STACK(audioStack, AUDIO_STACK_SIZE);
 
+#if defined(LOGS_BINARY)
+#define LOGS_TASK_PERIOD_TICKS 25   // 50ms
+
+extern RTOS_TASK_HANDLE logsTaskId;
+extern RTOS_DEFINE_STACK(logsStack, LOGS_STACK_SIZE);
+TASK_FUNCTION(logsTask);
+#endif
+
 extern RTOS_FLAG_HANDLE openTxInitCompleteFlag;
 
 void stackPaint();
@@ -57,4 +67,6 @@ extern RTOS_MUTEX_HANDLE mixerMutex;
 inline void pauseMixerCalculations() { RTOS_LOCK_MUTEX(mixerMutex); }
 inline void resumeMixerCalculations() { RTOS_UNLOCK_MUTEX(mixerMutex); }
 
+extern RTOS_MUTEX_HANDLE telemetryMutex;
+
 #endif // _TASKS_ARM_H_
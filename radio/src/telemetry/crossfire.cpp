@@ -244,6 +244,41 @@ void processCrossfireTelemetryData(uint8_t data)
   }
 }
 
+void processCrossfireTelemetryBuffer(const uint8_t * data, uint32_t count)
+{
+  while (count > 0) {
+    if (telemetryRxBufferCount == 0) {
+      // look for the start of the next frame
+      const uint8_t * start = (const uint8_t *)memchr(data, RADIO_ADDRESS, count);
+      if (!start) {
+        TRACE("[XF] address error, %d bytes skipped", count);
+        return;
+      }
+      count -= start - data;
+      data = start;
+    }
+
+    uint8_t length = telemetryRxBuffer[1];
+    if (telemetryRxBufferCount < 2 || length + 2 <= 4) {
+      processCrossfireTelemetryData(*data++);
+      count--;
+      continue;
+    }
+
+    // the frame length is known, the remaining bytes are copied at once
+    uint32_t size = min<uint32_t>(count, length + 2 - telemetryRxBufferCount);
+    memcpy(&telemetryRxBuffer[telemetryRxBufferCount], data, size);
+    telemetryRxBufferCount += size;
+    data += size;
+    count -= size;
+
+    if (telemetryRxBufferCount == length + 2) {
+      processCrossfireTelemetryFrame();
+      telemetryRxBufferCount = 0;
+    }
+  }
+}
+
 void crossfireSetDefault(int index, uint8_t id, uint8_t subId)
 {
   TelemetrySensor & telemetrySensor = g_model.telemetrySensors[index];
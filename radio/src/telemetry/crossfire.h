@@ -47,6 +47,7 @@
 
 
 void processCrossfireTelemetryData(uint8_t data);
+void processCrossfireTelemetryBuffer(const uint8_t * data, uint32_t count);
 void crossfireSetDefault(int index, uint8_t id, uint8_t subId);
 bool isCrossfireOutputBufferAvailable();
 bool crossfireGet(uint8_t* buffer, uint8_t& dataSize);
@@ -154,6 +154,33 @@ void processFlySkyTelemetryData(uint8_t data)
   }
 }
 
+void processFlySkyTelemetryBuffer(const uint8_t * data, uint32_t count)
+{
+  while (count > 0) {
+    if (telemetryRxBufferCount == 0) {
+      // look for the start of the next packet
+      const uint8_t * start = (const uint8_t *)memchr(data, 0xAA, count);
+      if (!start) {
+        TRACE("[IBUS] invalid start byte, %d bytes skipped", count);
+        return;
+      }
+      count -= start - data;
+      data = start;
+    }
+
+    uint32_t size = min<uint32_t>(count, FLYSKY_TELEMETRY_LENGTH - telemetryRxBufferCount);
+    memcpy(&telemetryRxBuffer[telemetryRxBufferCount], data, size);
+    telemetryRxBufferCount += size;
+    data += size;
+    count -= size;
+
+    if (telemetryRxBufferCount >= FLYSKY_TELEMETRY_LENGTH) {
+      processFlySkyPacket(telemetryRxBuffer+1);
+      telemetryRxBufferCount = 0;
+    }
+  }
+}
+
 const FlySkySensor *getFlySkySensor(uint16_t id)
 {
   for (const FlySkySensor * sensor = flySkySensors; sensor->id; sensor++) {
@@ -36,10 +36,10 @@ extern uint8_t TrotCount;
 extern uint8_t TezRotary;
 #endif
 
+static uint8_t dataState = STATE_DATA_IDLE;
+
 NOINLINE void processFrskyTelemetryData(uint8_t data)
 {
-  static uint8_t dataState = STATE_DATA_IDLE;
-
 #if defined(PCBSKY9X) && defined(BLUETOOTH)
   // TODO if (g_model.bt_telemetry)
   btPushByte(data);
@@ -152,6 +152,73 @@ NOINLINE void processFrskyTelemetryData(uint8_t data)
 #endif
 }
 
+#if defined(TELEMETRY_FRSKY_SPORT)
+static bool isFrskyTelemetryForwarded()
+{
+#if defined(PCBSKY9X) && defined(BLUETOOTH)
+  return true;
+#endif
+
+#if defined(SERIAL2)
+  if (g_eeGeneral.serial2Mode == UART_MODE_TELEMETRY_MIRROR) {
+    return true;
+  }
+#endif
+
+#if defined(BLUETOOTH)
+  if (g_eeGeneral.bluetoothMode == BLUETOOTH_TELEMETRY && bluetoothState == BLUETOOTH_STATE_CONNECTED) {
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+// S.PORT only: the bytes between the delimiters are copied at once
+void processFrskyTelemetryBuffer(const uint8_t * data, uint32_t count)
+{
+  if (isFrskyTelemetryForwarded()) {
+    // each byte is forwarded
+    for (uint32_t i=0; i<count; i++) {
+      processFrskyTelemetryData(data[i]);
+    }
+    return;
+  }
+
+  while (count > 0) {
+    if (dataState == STATE_DATA_IDLE) {
+      const uint8_t * start = (const uint8_t *)memchr(data, START_STOP, count);
+      if (!start) {
+        return;
+      }
+      count -= start - data;
+      data = start;
+    }
+    else if (dataState == STATE_DATA_IN_FRAME) {
+      uint32_t size = min<uint32_t>(count, FRSKY_SPORT_PACKET_SIZE - telemetryRxBufferCount);
+      uint32_t len = 0;
+      while (len < size && data[len] != START_STOP && data[len] != BYTESTUFF) {
+        len++;
+      }
+      if (len > 0) {
+        memcpy(&telemetryRxBuffer[telemetryRxBufferCount], data, len);
+        telemetryRxBufferCount += len;
+        data += len;
+        count -= len;
+        if (telemetryRxBufferCount >= FRSKY_SPORT_PACKET_SIZE) {
+          sportProcessPacket(telemetryRxBuffer);
+          dataState = STATE_DATA_IDLE;
+        }
+        continue;
+      }
+    }
+
+    processFrskyTelemetryData(*data++);
+    count--;
+  }
+}
+#endif
+
 #if defined(FRSKY_HUB) && !defined(CPUARM)
 void frskyUpdateCells(void)
 {
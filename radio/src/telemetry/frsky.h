@@ -514,5 +514,6 @@ void frskyUpdateCells();
 #endif
 
 void processFrskyTelemetryData(uint8_t data);
+void processFrskyTelemetryBuffer(const uint8_t * data, uint32_t count);
 
 #endif // _FRSKY_H_
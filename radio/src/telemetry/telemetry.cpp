@@ -81,6 +81,33 @@ void processTelemetryData(uint8_t data)
   processFrskyTelemetryData(data);
 }
 
+#if defined(STM32)
+void processTelemetryBuffer(const uint8_t * data, uint32_t count)
+{
+#if defined(CROSSFIRE)
+  if (telemetryProtocol == PROTOCOL_PULSES_CROSSFIRE) {
+    processCrossfireTelemetryBuffer(data, count);
+    return;
+  }
+#endif
+#if defined(MULTIMODULE)
+  if (telemetryProtocol == PROTOCOL_FLYSKY_IBUS) {
+    processFlySkyTelemetryBuffer(data, count);
+    return;
+  }
+#endif
+#if defined(TELEMETRY_FRSKY_SPORT)
+  if (telemetryProtocol == PROTOCOL_FRSKY_SPORT) {
+    processFrskyTelemetryBuffer(data, count);
+    return;
+  }
+#endif
+  for (uint32_t i=0; i<count; i++) {
+    processTelemetryData(data[i]);
+  }
+}
+#endif
+
 void telemetryWakeup()
 {
 #if defined(CPUARM)
@@ -97,13 +124,18 @@ void telemetryWakeup()
 #endif
 
 #if defined(STM32)
-  uint8_t data;
-  if (telemetryGetByte(&data)) {
+  const uint8_t * data;
+  uint32_t count = telemetryGetBuffer(&data);
+  if (count > 0) {
     LOG_TELEMETRY_WRITE_START();
     do {
-      processTelemetryData(data);
-      LOG_TELEMETRY_WRITE_BYTE(data);
-    } while (telemetryGetByte(&data));
+      // the received bytes are parsed in place, then released
+      processTelemetryBuffer(data, count);
+      for (uint32_t i=0; i<count; i++) {
+        LOG_TELEMETRY_WRITE_BYTE(data[i]);
+      }
+      telemetryReleaseBuffer(count);
+    } while ((count = telemetryGetBuffer(&data)) > 0);
   }
 #elif defined(PCBSKY9X)
   if (telemetryProtocol == PROTOCOL_FRSKY_D_SECONDARY) {
@@ -132,12 +164,7 @@ void telemetryWakeup()
 #endif
 
 #if defined(CPUARM)
-  for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
-    const TelemetrySensor & sensor = g_model.telemetrySensors[i];
-    if (sensor.type == TELEM_TYPE_CALCULATED) {
-      telemetryItems[i].eval(sensor);
-    }
-  }
+  evalTelemetrySensors();
 #endif
 
 #if defined(VARIO)
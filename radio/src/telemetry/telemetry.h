@@ -126,6 +126,18 @@ PACK(struct CellValue
 
 int setTelemetryValue(TelemetryProtocol protocol, uint16_t id, uint8_t subId, uint8_t instance, int32_t value, uint32_t unit, uint32_t prec);
 void delTelemetryIndex(uint8_t index);
+void invalidateTelemetrySensors();
+void evalTelemetrySensors();
+
+#if defined(DEBUG)
+struct TelemetryLookupStats {
+  uint32_t lookups;
+  uint32_t time;          // in 0.5us
+  uint32_t rebuilds;
+  tmr10ms_t start;
+};
+extern TelemetryLookupStats telemetryLookupStats;
+#endif
 int8_t availableTelemetryIndex();
 int lastUsedTelemetryIndex();
 
@@ -182,6 +194,9 @@ inline uint8_t modelTelemetryProtocol()
   #include "telemetry_sensors.h"
 #endif
 
+void processTelemetryData(uint8_t data);
+void processTelemetryBuffer(const uint8_t * data, uint32_t count);
+
 #if defined(LOG_TELEMETRY) && !defined(SIMU)
 void logTelemetryWriteStart();
 void logTelemetryWriteByte(uint8_t data);
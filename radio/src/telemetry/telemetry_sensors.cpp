@@ -36,6 +36,8 @@ void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t val, uint32
 {
   int32_t newVal = val;
 
+  changes++;
+
   if (unit == UNIT_CELLS) {
     uint32_t data = uint32_t(newVal);
     uint8_t cellsCount = (data >> 24);
@@ -220,7 +222,9 @@ void TelemetryItem::per10ms(const TelemetrySensor & sensor)
           return;
         }
         else if (currentItem.isOld()) {
-          lastReceived = TELEMETRY_VALUE_OLD;
+          if (!isOld()) {
+            setOld();
+          }
           return;
         }
         int32_t current = convertTelemetryValue(currentItem.value, currentSensor.unit, currentSensor.prec, UNIT_AMPS, 1);
@@ -229,7 +233,11 @@ void TelemetryItem::per10ms(const TelemetrySensor & sensor)
           currentItem.consumption.prescale -= 3600;
           setValue(sensor, value+1, sensor.unit, sensor.prec);
         }
-        lastReceived = now();
+        if (lastReceived != now()) {
+          // the sensors using this one are evaluated again only when it changes
+          lastReceived = now();
+          changes++;
+        }
       }
       break;
 
@@ -245,7 +253,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
       if (sensor.cell.source) {
         TelemetryItem & cellsItem = telemetryItems[sensor.cell.source-1];
         if (cellsItem.isOld()) {
-          lastReceived = TELEMETRY_VALUE_OLD;
+          setOld();
         }
         else {
           unsigned int index = sensor.cell.index;
@@ -294,7 +302,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
           return;
         }
         else if (gpsItem.isOld()) {
-          lastReceived = TELEMETRY_VALUE_OLD;
+          setOld();
           return;
         }
         if (sensor.dist.alt) {
@@ -303,7 +311,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
             return;
           }
           else if (altItem->isOld()) {
-            lastReceived = TELEMETRY_VALUE_OLD;
+            setOld();
             return;
           }
         }
@@ -358,7 +366,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
               return;
             }
             else if (telemetryItem.isOld()) {
-              lastReceived = TELEMETRY_VALUE_OLD;
+              setOld();
               return;
             }
           }
@@ -384,7 +392,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
       if (sensor.formula == TELEM_FORMULA_AVERAGE) {
         if (count == 0) {
           if (available)
-            lastReceived = TELEMETRY_VALUE_OLD;
+            setOld();
           return;
         }
         else {
@@ -410,6 +418,7 @@ void delTelemetryIndex(uint8_t index)
   memclear(&g_model.telemetrySensors[index], sizeof(TelemetrySensor));
   telemetryItems[index].clear();
   storageDirty(EE_MODEL);
+  invalidateModelPlans();
 }
 
 int8_t availableTelemetryIndex()
@@ -434,32 +443,272 @@ int lastUsedTelemetryIndex()
   return -1;
 }
 
+// Index of the custom sensors by (id, subId, instance), the instance is not
+// part of the key when g_model.ignoreSensorIds is set. Sensors sharing the
+// same key are chained, in the g_model.telemetrySensors[] order.
+// It is rebuilt in the spare table, then the current table pointer is swapped,
+// so that setTelemetryValue() can run its lookups without locking from the
+// telemetry and the Lua tasks. Only the rebuild is done with telemetryMutex locked.
+#define TELEMETRY_SENSORS_INDEX_SIZE   (2*MAX_TELEMETRY_SENSORS)
+
+struct TelemetrySensorsIndexEntry {
+  uint16_t id;
+  uint8_t subId;
+  uint8_t instance;
+  int8_t first;           // first sensor with this key, -1 when the entry is free
+};
+
+struct TelemetrySensorsIndex {
+  TelemetrySensorsIndexEntry entries[TELEMETRY_SENSORS_INDEX_SIZE];
+  int8_t next[MAX_TELEMETRY_SENSORS];
+  uint8_t ignoreIds;
+};
+
+static TelemetrySensorsIndex telemetrySensorsIndexes[2];
+static TelemetrySensorsIndex * volatile telemetrySensorsIndex = &telemetrySensorsIndexes[0];
+static volatile bool telemetrySensorsIndexDirty = true;
+RTOS_MUTEX_HANDLE telemetryMutex;
+#if defined(DEBUG)
+TelemetryLookupStats telemetryLookupStats;
+#endif
+
+// Calculated sensors evaluation order, each sensor after the calculated
+// sensors it uses, and the changes counters of its sources at the time of
+// its last evaluation
+#define TELEMETRY_CALC_MAX_SOURCES     4
+
+static uint8_t telemetryEvalOrder[MAX_TELEMETRY_SENSORS];
+static uint8_t telemetryEvalCount;
+static uint8_t telemetryEvalChanges[MAX_TELEMETRY_SENSORS][TELEMETRY_CALC_MAX_SOURCES];
+static bool telemetryEvalOrderDirty = true;
+static bool telemetryEvalAll = true;
+
+void invalidateTelemetrySensors()
+{
+  telemetrySensorsIndexDirty = true;
+  telemetryEvalOrderDirty = true;
+  telemetryEvalAll = true;
+
+#if defined(LUA)
+  luaInvalidateSensorsLabels();
+#endif
+}
+
+static inline uint8_t getTelemetrySensorsIndexHash(uint16_t id, uint8_t subId, uint8_t instance)
+{
+  return (id * 31 + subId * 7 + instance) % TELEMETRY_SENSORS_INDEX_SIZE;
+}
+
+static TelemetrySensorsIndexEntry * findTelemetrySensorsIndexEntry(TelemetrySensorsIndex * index, uint16_t id, uint8_t subId, uint8_t instance)
+{
+  uint8_t hash = getTelemetrySensorsIndexHash(id, subId, instance);
+  for (uint8_t i=0; i<TELEMETRY_SENSORS_INDEX_SIZE; i++) {
+    TelemetrySensorsIndexEntry & entry = index->entries[(hash + i) % TELEMETRY_SENSORS_INDEX_SIZE];
+    if (entry.first < 0 || (entry.id == id && entry.subId == subId && entry.instance == instance)) {
+      return &entry;
+    }
+  }
+  return NULL;
+}
+
+static void buildTelemetrySensorsIndex()
+{
+  RTOS_LOCK_MUTEX(telemetryMutex);
+
+  // an invalidation during the rebuild sets the flag again
+  telemetrySensorsIndexDirty = false;
+
+  TelemetrySensorsIndex * index = (telemetrySensorsIndex == &telemetrySensorsIndexes[0] ? &telemetrySensorsIndexes[1] : &telemetrySensorsIndexes[0]);
+
+  for (uint8_t i=0; i<TELEMETRY_SENSORS_INDEX_SIZE; i++) {
+    index->entries[i].first = -1;
+  }
+
+  index->ignoreIds = g_model.ignoreSensorIds;
+
+  // backwards, so that the chains are in the sensors order
+  for (int i=MAX_TELEMETRY_SENSORS-1; i>=0; i--) {
+    TelemetrySensor & telemetrySensor = g_model.telemetrySensors[i];
+    index->next[i] = -1;
+    if (telemetrySensor.type == TELEM_TYPE_CUSTOM) {
+      uint8_t instance = (index->ignoreIds ? 0 : telemetrySensor.instance);
+      TelemetrySensorsIndexEntry * entry = findTelemetrySensorsIndexEntry(index, telemetrySensor.id, telemetrySensor.subId, instance);
+      if (entry->first < 0) {
+        entry->id = telemetrySensor.id;
+        entry->subId = telemetrySensor.subId;
+        entry->instance = instance;
+      }
+      else {
+        index->next[i] = entry->first;
+      }
+      entry->first = i;
+    }
+  }
+
+  telemetrySensorsIndex = index;
+
+  RTOS_UNLOCK_MUTEX(telemetryMutex);
+
+#if defined(DEBUG)
+  telemetryLookupStats.rebuilds++;
+#endif
+}
+
+// the sources read by TelemetryItem::eval()
+static uint8_t getCalculatedSensorSources(const TelemetrySensor & sensor, uint8_t * sources)
+{
+  uint8_t count = 0;
+
+  switch (sensor.formula) {
+    case TELEM_FORMULA_CELL:
+      if (sensor.cell.source)
+        sources[count++] = sensor.cell.source - 1;
+      break;
+
+    case TELEM_FORMULA_DIST:
+      if (sensor.dist.gps) {
+        sources[count++] = sensor.dist.gps - 1;
+        if (sensor.dist.alt)
+          sources[count++] = sensor.dist.alt - 1;
+      }
+      break;
+
+    case TELEM_FORMULA_ADD:
+    case TELEM_FORMULA_AVERAGE:
+    case TELEM_FORMULA_MIN:
+    case TELEM_FORMULA_MAX:
+    case TELEM_FORMULA_MULTIPLY:
+    {
+      int maxitems = (sensor.formula == TELEM_FORMULA_MULTIPLY ? 2 : TELEMETRY_CALC_MAX_SOURCES);
+      for (int i=0; i<maxitems; i++) {
+        int8_t source = sensor.calc.sources[i];
+        if (source)
+          sources[count++] = abs(source) - 1;
+      }
+      break;
+    }
+
+    default:
+      // TOTALIZE and CONSUMPTION are updated in setValue() and per10ms()
+      break;
+  }
+
+  for (uint8_t i=0; i<count; i++) {
+    if (sources[i] >= MAX_TELEMETRY_SENSORS)
+      return 0;
+  }
+
+  return count;
+}
+
+static void buildTelemetryEvalOrder()
+{
+  bool done[MAX_TELEMETRY_SENSORS];
+  uint8_t sources[TELEMETRY_CALC_MAX_SOURCES];
+
+  telemetryEvalOrderDirty = false;
+  telemetryEvalCount = 0;
+
+  for (int index=0; index<MAX_TELEMETRY_SENSORS; index++) {
+    const TelemetrySensor & sensor = g_model.telemetrySensors[index];
+    done[index] = (sensor.type != TELEM_TYPE_CALCULATED || getCalculatedSensorSources(sensor, sources) == 0);
+  }
+
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (int index=0; index<MAX_TELEMETRY_SENSORS; index++) {
+      if (!done[index]) {
+        uint8_t count = getCalculatedSensorSources(g_model.telemetrySensors[index], sources);
+        bool ready = true;
+        for (uint8_t i=0; i<count; i++) {
+          if (!done[sources[i]] && sources[i] != index) {
+            ready = false;
+            break;
+          }
+        }
+        if (ready) {
+          telemetryEvalOrder[telemetryEvalCount++] = index;
+          done[index] = true;
+          progress = true;
+        }
+      }
+    }
+  }
+
+  // loops between calculated sensors, they are evaluated in the sensors order
+  for (int index=0; index<MAX_TELEMETRY_SENSORS; index++) {
+    if (!done[index]) {
+      telemetryEvalOrder[telemetryEvalCount++] = index;
+    }
+  }
+}
+
+void evalTelemetrySensors()
+{
+  uint8_t sources[TELEMETRY_CALC_MAX_SOURCES];
+
+  if (telemetryEvalOrderDirty) {
+    buildTelemetryEvalOrder();
+  }
+
+  for (uint8_t i=0; i<telemetryEvalCount; i++) {
+    uint8_t index = telemetryEvalOrder[i];
+    const TelemetrySensor & sensor = g_model.telemetrySensors[index];
+    uint8_t count = getCalculatedSensorSources(sensor, sources);
+    bool changed = telemetryEvalAll;
+    for (uint8_t j=0; j<count; j++) {
+      uint8_t changes = telemetryItems[sources[j]].changes;
+      if (telemetryEvalChanges[index][j] != changes) {
+        telemetryEvalChanges[index][j] = changes;
+        changed = true;
+      }
+    }
+    if (changed) {
+      telemetryItems[index].eval(sensor);
+    }
+  }
+
+  telemetryEvalAll = false;
+}
+
 int setTelemetryValue(TelemetryProtocol protocol, uint16_t id,
                       uint8_t subId, uint8_t instance,
                       int32_t value, uint32_t unit, uint32_t prec)
 {
   bool available = false;
 
-  for (int index=0; index<MAX_TELEMETRY_SENSORS; index++)
-  {
-    TelemetrySensor & telemetrySensor = g_model.telemetrySensors[index];
+#if defined(DEBUG)
+  uint16_t t0 = getTmr2MHz();
+#endif
 
-    if ( telemetrySensor.type == TELEM_TYPE_CUSTOM && telemetrySensor.id == id && telemetrySensor.subId == subId
-         && (telemetrySensor.instance == instance  || g_model.ignoreSensorIds)
-        )
-    {
-      telemetryItems[index].setValue(telemetrySensor, value, unit, prec);
+  if (telemetrySensorsIndexDirty || telemetrySensorsIndex->ignoreIds != g_model.ignoreSensorIds) {
+    buildTelemetrySensorsIndex();
+  }
+
+  TelemetrySensorsIndex * sensorsIndex = telemetrySensorsIndex;
+  TelemetrySensorsIndexEntry * entry = findTelemetrySensorsIndexEntry(sensorsIndex, id, subId, sensorsIndex->ignoreIds ? 0 : instance);
+  if (entry) {
+    // sensors can share the same id and instance
+    for (int8_t index=entry->first; index>=0; index=sensorsIndex->next[index]) {
+      telemetryItems[index].setValue(g_model.telemetrySensors[index], value, unit, prec);
       available = true;
-      // we continue search here, because sensors can share the same id and instance
     }
   }
 
+#if defined(DEBUG)
+  telemetryLookupStats.lookups++;
+  telemetryLookupStats.time += (uint16_t)(getTmr2MHz() - t0);
+#endif
+
   if (available || !allowNewSensors) {
     return -1;
   }
 
   int index = availableTelemetryIndex();
   if (index >= 0) {
+    invalidateTelemetrySensors();
+
     switch (protocol) {
 #if defined(TELEMETRY_FRSKY_SPORT)
       case TELEM_PROTO_FRSKY_SPORT:
@@ -47,6 +47,7 @@ class TelemetryItem
     };
 
     uint8_t lastReceived;       // for detection of sensor loss
+    uint8_t changes;            // incremented on each new value or state change, for the calculated sensors evaluation
 
     union {
       struct {
@@ -91,8 +92,10 @@ class TelemetryItem
 
     void clear()
     {
+      uint8_t count = changes;
       memset(reinterpret_cast<void*>(this), 0, sizeof(TelemetryItem));
       lastReceived = TELEMETRY_VALUE_UNAVAILABLE;
+      changes = count + 1;
     }
 
     void eval(const TelemetrySensor & sensor);
@@ -129,6 +132,7 @@ class TelemetryItem
     inline void setOld()
     {
       lastReceived = TELEMETRY_VALUE_OLD;
+      changes++;
     }
 
     void gpsReceived(); // TODO seems not used
@@ -261,4 +261,7 @@ void applyTemplate(uint8_t idx)
     }
 
     storageDirty(EE_MODEL);
+#if defined(CPUARM)
+    invalidateModelPlans();
+#endif
 }
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <chrono>
+#include "gtests.h"
+
+#if defined(CPUARM) && defined(VIRTUAL_INPUTS)
+
+// The previous implementation: jitter filter in getADC(), calibration and center curve in evalInputs()
+static void referenceFilter(const uint16_t * raw, uint16_t * filtered)
+{
+  for (uint8_t x=0; x<NUM_ANALOGS; x++) {
+    uint16_t v = raw[x];
+    uint16_t previous = filtered[x] / JITTER_ALPHA;
+    uint16_t diff = (v > previous) ? (v - previous) : (previous - v);
+    if (!g_eeGeneral.jitterFilter && diff < (10*ANALOG_MULTIPLIER))
+      filtered[x] = (filtered[x] - previous) + v;
+    else
+      filtered[x] = v * JITTER_ALPHA;
+  }
+}
+
+static int16_t referenceCenterCurve(int16_t v)
+{
+  if (v > 30.0f)
+    v = v*(1024.0-9.0f)/(994.0f)-1024.0*(((1024.0-9.0f)/(994.0f))-1);
+  else if (v > 0)
+    v = (float)(3.0/10.0) * v;
+  else if (v >= -30.0f && v < 0)
+    v = (float)(3.0/10.0) * v;
+  else if (v < -30.0f)
+    v = v*(1024.0-9.0f)/(994.0f)+1024.0*(((1024.0-9.0f)/(994.0f))-1);
+  return v;
+}
+
+static int16_t referenceCalibration(const uint16_t * filtered, uint8_t i)
+{
+  int16_t v = filtered[i] / (JITTER_ALPHA * ANALOG_MULTIPLIER);
+  CalibData * calib = &g_eeGeneral.calib[i];
+  v -= calib->mid;
+  v = v * (int32_t) RESX / (max((int16_t) 100, (v > 0 ? calib->spanPos : calib->spanNeg)));
+  if (v < -RESX) v = -RESX;
+  if (v >  RESX) v =  RESX;
+  return referenceCenterCurve(v);
+}
+
+static void resetAnalogs()
+{
+  SYSTEM_RESET();
+  memclear(&analogs, sizeof(analogs));
+  for (uint8_t i=0; i<NUM_STICKS+NUM_POTS+NUM_SLIDERS; i++) {
+    g_eeGeneral.calib[i].mid = 1024 + i * 10;
+    g_eeGeneral.calib[i].spanNeg = 900 - i * 50;
+    g_eeGeneral.calib[i].spanPos = 1000 + i * 20;
+  }
+}
+
+// the sticks and pots move slowly with some jitter, and sometimes jump
+static uint16_t nextRawValue(uint16_t value)
+{
+  int step = (rand() % 100 == 0) ? (rand() % 2001 - 1000) : (rand() % 31 - 15);
+  return limit<int>(0, value + step, 4095);
+}
+
+TEST(Analogs, centerCurve)
+{
+  for (int v=-RESX; v<=RESX; v++) {
+    EXPECT_EQ(referenceCenterCurve(v), analogCenterCurve(v)) << "v=" << v;
+  }
+}
+
+TEST(Analogs, mmaFilterAndCalibration)
+{
+  resetAnalogs();
+  srand(7);
+
+  for (int jitterFilter=0; jitterFilter<2; jitterFilter++) {
+    g_eeGeneral.jitterFilter = jitterFilter;
+    uint16_t filtered[NUM_ANALOGS] = { 0 };
+    uint16_t expected[NUM_ANALOGS] = { 0 };
+
+    for (int cycle=0; cycle<5000; cycle++) {
+      for (uint8_t x=0; x<NUM_ANALOGS; x++) {
+        analogs.raw[x] = nextRawValue(analogs.raw[x]);
+      }
+      referenceFilter(analogs.raw, expected);
+      processAnalogs(filtered);
+      for (uint8_t x=0; x<NUM_ANALOGS; x++) {
+        ASSERT_EQ(expected[x], filtered[x]) << "cycle=" << cycle << " x=" << (int)x;
+      }
+      for (uint8_t i=0; i<NUM_STICKS+NUM_POTS+NUM_SLIDERS; i++) {
+        ASSERT_EQ(referenceCalibration(filtered, i), analogs.calibrated[i]) << "cycle=" << cycle << " i=" << (int)i;
+      }
+    }
+  }
+}
+
+TEST(Analogs, median3Filter)
+{
+  resetAnalogs();
+  uint16_t filtered[NUM_ANALOGS] = { 0 };
+
+  analogs.raw[0] = 2000;
+  setAnalogFilter(0, ANALOG_FILTER_MEDIAN3);
+  EXPECT_EQ(ANALOG_FILTER_MEDIAN3, analogs.filter[0]);
+
+  // a single glitch is removed
+  processAnalogs(filtered);
+  EXPECT_EQ(2000 * JITTER_ALPHA, filtered[0]);
+  analogs.raw[0] = 4000;
+  processAnalogs(filtered);
+  EXPECT_EQ(2000 * JITTER_ALPHA, filtered[0]);
+  analogs.raw[0] = 2002;
+  processAnalogs(filtered);
+  EXPECT_EQ(2002 * JITTER_ALPHA, filtered[0]);
+  processAnalogs(filtered);
+  EXPECT_EQ(2002 * JITTER_ALPHA, filtered[0]);
+
+  // a real move is delayed by one cycle
+  analogs.raw[0] = 3000;
+  processAnalogs(filtered);
+  EXPECT_EQ(2002 * JITTER_ALPHA, filtered[0]);
+  processAnalogs(filtered);
+  EXPECT_EQ(3000 * JITTER_ALPHA, filtered[0]);
+
+  setAnalogFilter(0, ANALOG_FILTER_MMA);
+  EXPECT_EQ(0u, analogs.otherFilters);
+}
+
+TEST(Analogs, oneEuroFilter)
+{
+  resetAnalogs();
+  uint16_t filtered[NUM_ANALOGS] = { 0 };
+
+  analogs.raw[0] = 2000;
+  setAnalogFilter(0, ANALOG_FILTER_ONE_EURO);
+
+  // +-2 jitter is attenuated
+  int minValue = 4096, maxValue = 0;
+  for (int cycle=0; cycle<200; cycle++) {
+    analogs.raw[0] = 2000 + ((cycle & 1) ? 2 : -2);
+    processAnalogs(filtered);
+    if (cycle >= 100) {
+      minValue = min<int>(minValue, filtered[0] / JITTER_ALPHA);
+      maxValue = max<int>(maxValue, filtered[0] / JITTER_ALPHA);
+    }
+  }
+  EXPECT_LE(maxValue - minValue, 1);
+
+  // a fast move is followed within a few cycles
+  analogs.raw[0] = 3500;
+  int cycles = 0;
+  do {
+    processAnalogs(filtered);
+    cycles++;
+  } while (filtered[0] / JITTER_ALPHA < 3490 && cycles < 100);
+  EXPECT_LE(cycles, 10);
+}
+
+// Disabled, run by the benchmarks target
+TEST(AnalogsBenchmark, DISABLED_CycleTime)
+{
+  const int loops = 20000;
+  volatile int32_t sum = 0;
+  uint16_t filtered[NUM_ANALOGS] = { 0 };
+  uint16_t raw[256][NUM_ANALOGS];
+
+  resetAnalogs();
+  srand(11);
+  for (unsigned l=0; l<DIM(raw); l++) {
+    for (uint8_t x=0; x<NUM_ANALOGS; x++) {
+      raw[l][x] = nextRawValue(l > 0 ? raw[l-1][x] : 2048);
+    }
+  }
+
+  // filter then calibration of each input, as getADC() and evalInputs() did
+  auto start = std::chrono::steady_clock::now();
+  for (int l=0; l<loops; l++) {
+    referenceFilter(raw[l % DIM(raw)], filtered);
+    for (uint8_t i=0; i<NUM_STICKS+NUM_POTS+NUM_SLIDERS; i++) {
+      sum += referenceCalibration(filtered, i);
+    }
+  }
+  auto previous = std::chrono::steady_clock::now() - start;
+
+  // the fused pass, with each filter on all the analogs
+  double fused[ANALOG_FILTER_COUNT];
+  for (uint8_t filter=0; filter<ANALOG_FILTER_COUNT; filter++) {
+    for (uint8_t x=0; x<NUM_ANALOGS; x++) {
+      setAnalogFilter(x, filter);
+    }
+    start = std::chrono::steady_clock::now();
+    for (int l=0; l<loops; l++) {
+      memcpy(analogs.raw, raw[l % DIM(raw)], sizeof(analogs.raw));
+      processAnalogs(filtered);
+      sum += analogs.calibrated[l % (NUM_STICKS+NUM_POTS+NUM_SLIDERS)];
+    }
+    fused[filter] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / loops;
+  }
+
+  printf("Analogs %d inputs: previous %.1fns/cycle, fused pass %.1fns/cycle (1-euro %.1fns, median %.1fns)\n", NUM_ANALOGS,
+         std::chrono::duration<double, std::nano>(previous).count() / loops,
+         fused[ANALOG_FILTER_MMA], fused[ANALOG_FILTER_ONE_EURO], fused[ANALOG_FILTER_MEDIAN3]);
+
+  resetAnalogs();
+}
+
+#endif // defined(CPUARM) && defined(VIRTUAL_INPUTS)
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <chrono>
+#include "gtests.h"
+
+#if defined(CPUARM)
+
+TEST(Audio, decodeWavSamples)
+{
+  int16_t samples[4];
+  uint8_t * data = (uint8_t *)samples;
+
+  data[0] = 0x00; data[1] = 0x80; data[2] = 0xD5; data[3] = 0x55;
+  EXPECT_EQ(4, (int)decodeWavSamples(samples, 4, CODEC_ID_PCM_ALAW));
+  EXPECT_EQ(-5504, samples[0]);
+  EXPECT_EQ(5504, samples[1]);
+  EXPECT_EQ(8, samples[2]);
+  EXPECT_EQ(-8, samples[3]);
+
+  data[0] = 0x00; data[1] = 0x80; data[2] = 0x7F; data[3] = 0xFF;
+  EXPECT_EQ(4, (int)decodeWavSamples(samples, 4, CODEC_ID_PCM_MULAW));
+  EXPECT_EQ(-32124, samples[0]);
+  EXPECT_EQ(32124, samples[1]);
+  EXPECT_EQ(0, samples[2]);
+  EXPECT_EQ(0, samples[3]);
+
+  EXPECT_EQ(2, (int)decodeWavSamples(samples, 5, CODEC_ID_PCM_S16LE));
+  EXPECT_EQ(0, (int)decodeWavSamples(samples, 4, 0));
+}
+
+TEST(Audio, mixWavSamples)
+{
+  audio_data_t result[4] = { AUDIO_DATA_SILENCE, AUDIO_DATA_SILENCE, AUDIO_DATA_MAX - 10, AUDIO_DATA_MIN + 10 };
+  const int16_t samples[4] = { 1000, -1000, 32000, -32000 };
+
+  EXPECT_EQ(4, (int)mixWavSamples(result, samples, 4, 1, 0, 0));
+  EXPECT_EQ(AUDIO_DATA_SILENCE + (1000 >> (16-AUDIO_BITS_PER_SAMPLE)), result[0]);
+  EXPECT_EQ(AUDIO_DATA_SILENCE - (1000 >> (16-AUDIO_BITS_PER_SAMPLE)), result[1]);
+  EXPECT_EQ(AUDIO_DATA_MAX, result[2]);
+  EXPECT_EQ(AUDIO_DATA_MIN, result[3]);
+}
+
+TEST(Audio, mixWavSamplesResampled)
+{
+  const int16_t samples[2] = { 4000, -4000 };
+  const int expected2[4] = { 2000, 4000, 0, -4000 };
+  const int expected4[8] = { 1000, 2000, 3000, 4000, 2000, 0, -2000, -4000 };
+
+  // linear interpolation from the last sample of the previous block
+  const unsigned int ratios[] = { 2, 4, 5 };
+  for (unsigned int r=0; r<DIM(ratios); r++) {
+    unsigned int ratio = ratios[r];
+    audio_data_t result[10];
+    for (int i=0; i<10; i++) {
+      result[i] = AUDIO_DATA_SILENCE;
+    }
+    EXPECT_EQ(2*ratio, mixWavSamples(result, samples, 2, ratio, 0, 0));
+    EXPECT_EQ(AUDIO_DATA_SILENCE + (4000 >> (16-AUDIO_BITS_PER_SAMPLE)), result[ratio-1]);
+    EXPECT_EQ(AUDIO_DATA_SILENCE - (4000 >> (16-AUDIO_BITS_PER_SAMPLE)), result[2*ratio-1]);
+    if (ratio == 2) {
+      for (int i=0; i<4; i++) {
+        EXPECT_EQ(AUDIO_DATA_SILENCE + (expected2[i] >> (16-AUDIO_BITS_PER_SAMPLE)), result[i]);
+      }
+    }
+    else if (ratio == 4) {
+      for (int i=0; i<8; i++) {
+        EXPECT_EQ(AUDIO_DATA_SILENCE + (expected4[i] >> (16-AUDIO_BITS_PER_SAMPLE)), result[i]);
+      }
+    }
+  }
+}
+
+// Disabled, run by the benchmarks target
+TEST(AudioBenchmark, DISABLED_MixWavSamples)
+{
+  static audio_data_t result[AUDIO_BUFFER_SIZE];
+  static int16_t input[AUDIO_BUFFER_SIZE];
+  const int loops = 20000;
+  volatile int sum = 0;
+
+  for (unsigned int ratio=1; ratio<=4; ratio*=2) {
+    unsigned int count = AUDIO_BUFFER_SIZE / ratio;
+
+    for (unsigned int i=0; i<count; i++) {
+      input[i] = (i * 1000) - 20000;
+    }
+
+    // one sample at a time, each sample repeated, as before
+    auto start = std::chrono::steady_clock::now();
+    for (int l=0; l<loops; l++) {
+      audio_data_t * output = result;
+      for (unsigned int i=0; i<count; i++) {
+        for (unsigned int j=0; j<ratio; j++) {
+          *output = limit<int>(AUDIO_DATA_MIN, *output + ((input[i] >> 2) >> (16-AUDIO_BITS_PER_SAMPLE)), AUDIO_DATA_MAX);
+          output++;
+        }
+      }
+      sum += result[l % AUDIO_BUFFER_SIZE];
+    }
+    auto single = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int l=0; l<loops; l++) {
+      mixWavSamples(result, input, count, ratio, 0, 2);
+      sum += result[l % AUDIO_BUFFER_SIZE];
+    }
+    auto block = std::chrono::steady_clock::now() - start;
+
+    printf("PCM x%d: sample by sample %.0fns/buffer, by blocks %.0fns/buffer\n", ratio,
+           std::chrono::duration<double, std::nano>(single).count() / loops,
+           std::chrono::duration<double, std::nano>(block).count() / loops);
+  }
+}
+
+#endif // defined(CPUARM)
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <chrono>
+#include "gtests.h"
+
+#if defined(CPUARM)
+
+static const uint8_t crcCheck[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+// Bit by bit references
+static uint8_t crc8Reference(const uint8_t * buf, uint32_t len)
+{
+  uint8_t crc = 0;
+  while (len--) {
+    crc ^= *buf++;
+    for (int i=0; i<8; i++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0xD5 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static uint16_t crc16Reference(uint8_t index, const uint8_t * buf, uint32_t len, uint16_t crc)
+{
+  while (len--) {
+    if (index == CRC_1021) {
+      crc ^= *buf++ << 8;
+      for (int i=0; i<8; i++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+      }
+    }
+    else {
+      // PXX: LSB first entries, MSB first update
+      uint16_t value = (crc >> 8) ^ *buf++;
+      for (int i=0; i<8; i++) {
+        value = (value & 0x0001) ? (value >> 1) ^ 0x8408 : value >> 1;
+      }
+      crc = (crc << 8) ^ value;
+    }
+  }
+  return crc;
+}
+
+TEST(Crc, knownValues)
+{
+  EXPECT_EQ(0xBC, crc8(crcCheck, sizeof(crcCheck)));
+  EXPECT_EQ(0x31C3, crc16(CRC_1021, crcCheck, sizeof(crcCheck)));           // XMODEM
+  EXPECT_EQ(0x29B1, crc16(CRC_1021, crcCheck, sizeof(crcCheck), 0xFFFF));   // CCITT-FALSE, FlySky
+  EXPECT_EQ(0x1189, crc16tab[CRC_1189].slice[0][1]);                         // PXX table
+  EXPECT_EQ(0x8408, crc16tab[CRC_1189].slice[0][128]);
+}
+
+TEST(Crc, slicesAndUpdates)
+{
+  uint8_t buffer[67];
+  for (unsigned i=0; i<sizeof(buffer); i++) {
+    buffer[i] = i * 73 + 19;
+  }
+
+  for (uint32_t len=0; len<=sizeof(buffer); len++) {
+    uint8_t crc8Bytes = 0;
+    uint16_t crc16Bytes[CRC16_COUNT] = { 0xFFFF, 0 };
+    for (uint32_t i=0; i<len; i++) {
+      crc8Bytes = crc8Update(crc8Bytes, buffer[i]);
+      for (int index=0; index<CRC16_COUNT; index++) {
+        crc16Bytes[index] = crc16Update(index, crc16Bytes[index], buffer[i]);
+      }
+    }
+
+    EXPECT_EQ(crc8Reference(buffer, len), crc8(buffer, len)) << "len=" << len;
+    EXPECT_EQ(crc8Reference(buffer, len), crc8Bytes) << "len=" << len;
+    EXPECT_EQ(crc16Reference(CRC_1021, buffer, len, 0xFFFF), crc16(CRC_1021, buffer, len, 0xFFFF)) << "len=" << len;
+    EXPECT_EQ(crc16Reference(CRC_1021, buffer, len, 0xFFFF), crc16Bytes[CRC_1021]) << "len=" << len;
+    EXPECT_EQ(crc16Reference(CRC_1189, buffer, len, 0), crc16(CRC_1189, buffer, len)) << "len=" << len;
+    EXPECT_EQ(crc16Reference(CRC_1189, buffer, len, 0), crc16Bytes[CRC_1189]) << "len=" << len;
+
+    // a frame received in two parts
+    uint32_t split = len / 3;
+    EXPECT_EQ(crc8(buffer, len), crc8(buffer + split, len - split, crc8(buffer, split))) << "len=" << len;
+    EXPECT_EQ(crc16(CRC_1021, buffer, len, 0xFFFF), crc16(CRC_1021, buffer + split, len - split, crc16(CRC_1021, buffer, split, 0xFFFF))) << "len=" << len;
+  }
+}
+
+// Disabled, run by the benchmarks target
+TEST(CrcBenchmark, DISABLED_Throughput)
+{
+  static uint8_t buffer[64];
+  const int loops = 100000;
+  volatile uint32_t sum = 0;
+
+  for (unsigned i=0; i<sizeof(buffer); i++) {
+    buffer[i] = i * 31 + 7;
+  }
+
+  for (uint32_t len=8; len<=sizeof(buffer); len*=2) {
+    // one byte at a time, as the previous implementations
+    auto start = std::chrono::steady_clock::now();
+    for (int l=0; l<loops; l++) {
+      uint16_t crc = 0xFFFF;
+      for (uint32_t i=0; i<len; i++) {
+        crc = crc16Update(CRC_1021, crc, buffer[i]);
+      }
+      sum += crc;
+      buffer[0] = l;
+    }
+    auto bytes = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int l=0; l<loops; l++) {
+      sum += crc16(CRC_1021, buffer, len, 0xFFFF);
+      buffer[0] = l;
+    }
+    auto slices = std::chrono::steady_clock::now() - start;
+
+    printf("CRC16 %d bytes: byte by byte %.1fns/frame, slice-by-4 %.1fns/frame\n", len,
+           std::chrono::duration<double, std::nano>(bytes).count() / loops,
+           std::chrono::duration<double, std::nano>(slices).count() / loops);
+  }
+}
+
+#endif // defined(CPUARM)
@@ -421,6 +421,7 @@ TEST(FrSkySPORT, frskySetCellVoltageTwoSensors)
   g_model.telemetrySensors[2].prec = 1;
   g_model.telemetrySensors[2].calc.sources[0] = 1;
   g_model.telemetrySensors[2].calc.sources[1] = 2;
+  invalidateModelPlans();
 
   telemetryWakeup();
 
@@ -553,4 +554,147 @@ TEST(FrSkySPORT, frskyCurrent)
   EXPECT_EQ(telemetryItems[0].valueMax, 505);
 }
 
+TEST(FrSkySPORT, sensorsSharingSameId)
+{
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  allowNewSensors = true;
+
+  // one Vfas sensor per instance
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, 0x0210, 0, 1, 1000, UNIT_VOLTS, 2);
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, 0x0210, 0, 2, 2000, UNIT_VOLTS, 2);
+  EXPECT_EQ(telemetryItems[0].value, 1000);
+  EXPECT_EQ(telemetryItems[1].value, 2000);
+
+  // a copy of the first sensor gets the same values
+  g_model.telemetrySensors[2] = g_model.telemetrySensors[0];
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, 0x0210, 0, 1, 1100, UNIT_VOLTS, 2);
+  EXPECT_EQ(telemetryItems[0].value, 1100);
+  EXPECT_EQ(telemetryItems[1].value, 2000);
+  EXPECT_EQ(telemetryItems[2].value, 1100);
+
+  // all the sensors with this id get the values when instances are ignored
+  g_model.ignoreSensorIds = 1;
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, 0x0210, 0, 3, 1200, UNIT_VOLTS, 2);
+  EXPECT_EQ(telemetryItems[0].value, 1200);
+  EXPECT_EQ(telemetryItems[1].value, 1200);
+  EXPECT_EQ(telemetryItems[2].value, 1200);
+  EXPECT_EQ(telemetryItems[3].value, 0);
+}
+
+#if defined(STM32)
+TEST(FrSkySPORT, processTelemetryBuffer)
+{
+  uint8_t packets[2][FRSKY_SPORT_PACKET_SIZE];
+  generateSportCellPacket(packets[0], 3, 0, 230, _V(416)); // 0x7E in the data, stuffed
+  generateSportCellPacket(packets[1], 3, 2, _V(415), _V(0));
+
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  allowNewSensors = true;
+  sportProcessTelemetryPacket(packets[0]);
+  sportProcessTelemetryPacket(packets[1]);
+  int32_t value = telemetryItems[0].value;
+  EXPECT_EQ(telemetryItems[0].cells.count, 3);
+
+  // the frames as received, after some noise
+  uint8_t stream[64];
+  unsigned int size = 0;
+  stream[size++] = 0x00;
+  stream[size++] = 0x12;
+  for (int i=0; i<2; i++) {
+    stream[size++] = START_STOP;
+    for (int j=0; j<FRSKY_SPORT_PACKET_SIZE; j++) {
+      uint8_t byte = packets[i][j];
+      if (byte == START_STOP || byte == BYTESTUFF) {
+        stream[size++] = BYTESTUFF;
+        byte ^= STUFF_MASK;
+      }
+      stream[size++] = byte;
+    }
+  }
+  EXPECT_EQ(size, 2 + 2*(1+FRSKY_SPORT_PACKET_SIZE) + 1);
+
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  allowNewSensors = true;
+  telemetryProtocol = PROTOCOL_FRSKY_SPORT;
+
+  // the bytes go through a small fifo, which wraps several times
+  Fifo<uint8_t, 16> fifo;
+  unsigned int pushed = 0, popped = 0;
+  while (popped < size) {
+    pushed += fifo.pushMany(stream + pushed, min<unsigned int>(size - pushed, 5));
+    const uint8_t * span;
+    uint32_t count = fifo.probeSpan(span);
+    processTelemetryBuffer(span, count);
+    fifo.skip(count);
+    popped += count;
+  }
+  EXPECT_TRUE(fifo.isEmpty());
+  EXPECT_EQ(telemetryItems[0].cells.count, 3);
+  EXPECT_EQ(telemetryItems[0].value, value);
+}
+#endif
+
+TEST(FrSkySPORT, chainedCalculatedSensors)
+{
+  uint8_t packet[FRSKY_SPORT_PACKET_SIZE];
+
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  allowNewSensors = true;
+
+  generateSportCellPacket(packet, 3, 0, _V(418), _V(416)); sportProcessTelemetryPacket(packet);
+  generateSportCellPacket(packet, 3, 2, _V(415), _V(  0)); sportProcessTelemetryPacket(packet);
+  EXPECT_EQ(telemetryItems[0].value, 1249);
+
+  // each sensor uses the next ones, they have to be evaluated backwards
+  g_model.telemetrySensors[3].type = TELEM_TYPE_CALCULATED;
+  g_model.telemetrySensors[3].formula = TELEM_FORMULA_CELL;
+  g_model.telemetrySensors[3].unit = UNIT_VOLTS;
+  g_model.telemetrySensors[3].prec = 2;
+  g_model.telemetrySensors[3].cell.source = 1;
+  g_model.telemetrySensors[3].cell.index = TELEM_CELL_INDEX_LOWEST;
+
+  g_model.telemetrySensors[2].type = TELEM_TYPE_CALCULATED;
+  g_model.telemetrySensors[2].formula = TELEM_FORMULA_ADD;
+  g_model.telemetrySensors[2].unit = UNIT_VOLTS;
+  g_model.telemetrySensors[2].prec = 2;
+  g_model.telemetrySensors[2].calc.sources[0] = 1;
+  g_model.telemetrySensors[2].calc.sources[1] = -4;
+
+  g_model.telemetrySensors[1].type = TELEM_TYPE_CALCULATED;
+  g_model.telemetrySensors[1].formula = TELEM_FORMULA_MAX;
+  g_model.telemetrySensors[1].unit = UNIT_VOLTS;
+  g_model.telemetrySensors[1].prec = 2;
+  g_model.telemetrySensors[1].calc.sources[0] = 3;
+  g_model.telemetrySensors[1].calc.sources[1] = 4;
+  invalidateModelPlans();
+
+  // the whole chain is evaluated in one run
+  telemetryWakeup();
+  EXPECT_EQ(telemetryItems[3].value, 415);
+  EXPECT_EQ(telemetryItems[2].value, 834);
+  EXPECT_EQ(telemetryItems[1].value, 834);
+
+  // nothing is evaluated again while the cells don't change
+  uint8_t changes[3] = { telemetryItems[1].changes, telemetryItems[2].changes, telemetryItems[3].changes };
+  telemetryWakeup();
+  telemetryWakeup();
+  EXPECT_EQ(telemetryItems[1].changes, changes[0]);
+  EXPECT_EQ(telemetryItems[2].changes, changes[1]);
+  EXPECT_EQ(telemetryItems[3].changes, changes[2]);
+
+  generateSportCellPacket(packet, 3, 0, _V(420), _V(410)); sportProcessTelemetryPacket(packet);
+  generateSportCellPacket(packet, 3, 2, _V(400), _V(  0)); sportProcessTelemetryPacket(packet);
+  EXPECT_EQ(telemetryItems[0].value, 1230);
+
+  telemetryWakeup();
+  EXPECT_EQ(telemetryItems[3].value, 400);
+  EXPECT_EQ(telemetryItems[2].value, 830);
+  EXPECT_EQ(telemetryItems[1].value, 830);
+  EXPECT_EQ(telemetryItems[1].valueMax, 834);
+}
+
 #endif  //#if defined(TELEMETRY_FRSKY_SPORT)
@@ -134,6 +134,10 @@ uint16_t getAnalogValue(uint8_t index)
   return anaIn(index);
 }
 
+const char * benchmarkJsonFile = NULL;
+const char * benchmarkBaselineFile = NULL;
+int benchmarkTolerance = 30; // percent
+
 static char _zchar2stringResult[200];
 const char * zchar2string(const char * zstring, int size)
 {
@@ -155,8 +159,16 @@ int main(int argc, char **argv)
 
   // use --verbose option to revert to gtest's default output format
   bool verbose = false;
-  if (argc > 1 && !strcmp(argv[1], "--verbose"))
-    verbose = true;
+  for (int i=1; i<argc; i++) {
+    if (!strcmp(argv[i], "--verbose"))
+      verbose = true;
+    else if (!strcmp(argv[i], "--benchmark-json") && i+1 < argc)
+      benchmarkJsonFile = argv[++i];
+    else if (!strcmp(argv[i], "--benchmark-baseline") && i+1 < argc)
+      benchmarkBaselineFile = argv[++i];
+    else if (!strcmp(argv[i], "--benchmark-tolerance") && i+1 < argc)
+      benchmarkTolerance = atoi(argv[++i]);
+  }
 
   if (!verbose) {
     TestEventListeners & listeners = UnitTest::GetInstance()->listeners();
@@ -33,6 +33,11 @@
 extern int32_t lastAct;
 extern uint16_t anaInValues[NUM_STICKS+NUM_POTS+NUM_SLIDERS];
 
+// benchmarks options, see tests/mixer_benchmark.cpp
+extern const char * benchmarkJsonFile;
+extern const char * benchmarkBaselineFile;
+extern int benchmarkTolerance;
+
 void doMixerCalculations();
 
 #if defined(PCBTARANIS) || defined(PCBHORUS)
@@ -58,6 +63,9 @@ inline void MODEL_RESET()
 {
   memset(&g_model, 0, sizeof(g_model));
   memset(&anaInValues, 0, sizeof(anaInValues));
+#if defined(CPUARM)
+  invalidateModelPlans();
+#endif
   extern uint8_t s_mixer_first_run_done;
   s_mixer_first_run_done = false;
   lastFlightMode = 255;
@@ -92,6 +100,7 @@ inline void TELEMETRY_RESET()
   }
 #endif
   memclear(g_model.telemetrySensors, sizeof(g_model.telemetrySensors));
+  invalidateTelemetrySensors();
 #endif
 }
 
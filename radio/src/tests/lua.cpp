@@ -26,6 +26,10 @@
 #define SWAP_DEFINED
 #include "opentx.h"
 
+extern "C" {
+  #include <lundump.h>
+}
+
 extern const char * zchar2string(const char * zstring, int size);
 #define EXPECT_ZSTREQ(c_string, z_string)   EXPECT_STREQ(c_string, zchar2string(z_string, sizeof(z_string)))
 
@@ -165,4 +169,112 @@ TEST(Lua, testModelInputs)
 
 }
 
+TEST(Lua, testFieldsByName)
+{
+  LuaField field;
+
+  MODEL_RESET();
+  str2zchar(g_model.telemetrySensors[0].label, "RxBt", TELEM_LABEL_LEN);
+  str2zchar(g_model.telemetrySensors[1].label, "VFAS", TELEM_LABEL_LEN);
+  str2zchar(g_model.telemetrySensors[2].label, "RxBt", TELEM_LABEL_LEN);
+  str2zchar(g_model.telemetrySensors[3].label, "Cur", TELEM_LABEL_LEN);
+  str2zchar(g_model.telemetrySensors[4].label, "Cur-", TELEM_LABEL_LEN);
+  invalidateTelemetrySensors();
+
+  EXPECT_TRUE(luaFindFieldByName("ail", field));
+  EXPECT_EQ(MIXSRC_Ail, field.id);
+  EXPECT_TRUE(luaFindFieldByName("tx-voltage", field));
+  EXPECT_EQ(MIXSRC_TX_VOLTAGE, field.id);
+  EXPECT_TRUE(luaFindFieldByName("ch12", field));
+  EXPECT_EQ(MIXSRC_CH1+11, field.id);
+  EXPECT_FALSE(luaFindFieldByName("ailx", field));
+
+  // the first sensor with this label
+  EXPECT_TRUE(luaFindFieldByName("RxBt", field));
+  EXPECT_EQ(MIXSRC_FIRST_TELEM, field.id);
+  EXPECT_TRUE(luaFindFieldByName("VFAS+", field));
+  EXPECT_EQ(MIXSRC_FIRST_TELEM+3*1+2, field.id);
+  EXPECT_TRUE(luaFindFieldByName("Cur-", field));
+  EXPECT_EQ(MIXSRC_FIRST_TELEM+3*3+1, field.id);
+  EXPECT_TRUE(luaFindFieldByName("Cur--", field));
+  EXPECT_EQ(MIXSRC_FIRST_TELEM+3*4+1, field.id);
+  EXPECT_FALSE(luaFindFieldByName("RxB", field));
+
+  luaExecStr("if getFieldInfo('VFAS').id ~= getFieldInfo('RxBt').id + 3 then error('getFieldInfo()') end");
+}
+
+TEST(Lua, testGcSlice)
+{
+  extern lua_State * lsScripts;
+  luaExecStr("garbage = {}");
+  luaGcStartFrame();
+  luaGcSlice(lsScripts);
+  uint32_t memUsed = luaGetMemUsed(lsScripts);
+
+  // the garbage is freed by a full collect when idle
+  luaExecStr("for i=1,1000 do garbage[i] = string.rep('x', 64) .. i end");
+  luaExecStr("garbage = nil");
+  EXPECT_GT(luaGetMemUsed(lsScripts), memUsed + LUA_GC_FULL_GROWTH);
+  uint16_t fullCollects = luaGcScripts.fullCollects;
+  luaGcStartFrame();
+  luaGcSlice(lsScripts, true);
+  EXPECT_EQ(fullCollects + 1, luaGcScripts.fullCollects);
+  EXPECT_LT(luaGetMemUsed(lsScripts), memUsed + LUA_GC_FULL_GROWTH);
+
+  // nothing allocated since, no other full collect
+  luaGcSlice(lsScripts, true);
+  EXPECT_EQ(fullCollects + 1, luaGcScripts.fullCollects);
+}
+
+#if (LUA_MEM_MAX == 0)
+static void fillLuaHeap(uint32_t memUsed)
+{
+  char script[160];
+  sprintf(script, "garbage = {} local i = 0 while collectgarbage('count') * 1024 < %u do i = i + 1 garbage[i] = string.rep('x', 64) .. i end garbage = nil", memUsed);
+  luaExecStr(script);
+}
+
+TEST(Lua, testGcSliceHeapGrowth)
+{
+  extern lua_State * lsScripts;
+  luaExecStr("kept = {} for i=1,1000 do kept[i] = string.rep('y', 64) .. i end");
+  luaGcStartFrame();
+  luaGcSlice(lsScripts, true);
+  uint32_t memCollected = luaGcScripts.memCollected;
+  uint16_t fullCollects = luaGcScripts.fullCollects;
+  ASSERT_GT(memCollected, 2 * LUA_GC_FULL_GROWTH);
+
+  // the scripts run at each cycle, the GC is never idle
+  fillLuaHeap(memCollected * LUA_GC_FULL_RATIO - LUA_GC_FULL_GROWTH / 2);
+  luaGcStartFrame();
+  luaGcSlice(lsScripts);
+  EXPECT_EQ(fullCollects, luaGcScripts.fullCollects);
+
+  // without LUA_MEM_MAX, a full collect is forced once the heap has grown enough
+  fillLuaHeap(memCollected * LUA_GC_FULL_RATIO + LUA_GC_FULL_GROWTH / 2);
+  luaGcStartFrame();
+  luaGcSlice(lsScripts);
+  EXPECT_EQ(fullCollects + 1, luaGcScripts.fullCollects);
+  EXPECT_LT(luaGetMemUsed(lsScripts), memCollected + LUA_GC_FULL_GROWTH);
+
+  luaExecStr("kept = nil");
+}
+#endif
+
+
+TEST(Lua, bytecodeFormat)
+{
+  // the bytecode written by the simulator is the one of the radio, whatever the host
+  lu_byte header[LUAC_HEADERSIZE];
+  luaU_header(header);
+  EXPECT_EQ(1, header[6]);  // little endian
+  EXPECT_EQ(4, header[7]);  // int
+  EXPECT_EQ(4, header[8]);  // string sizes
+  EXPECT_EQ(4, header[9]);  // instructions
+  EXPECT_EQ(8, header[10]); // numbers
+
+  luaExecStr("f = load(string.dump(function(x) return 'bytecode' .. x end))");
+  luaExecStr("assert(f(1) == 'bytecode1')");
+}
+
 #endif   // #if defined(LUA)
@@ -18,6 +18,7 @@
  * GNU General Public License for more details.
  */
 
+#include <chrono>
 #include "gtests.h"
 
 class TrimsTest : public OpenTxTest {};
@@ -407,6 +408,110 @@ TEST(Curves, LinearIntpol)
   EXPECT_EQ(applyCustomCurve(-192, 0), -192);
 }
 
+#if defined(CURVES_LUT)
+static void setupLookupTablesModel()
+{
+  SYSTEM_RESET();
+  MODEL_RESET();
+  MIXER_RESET();
+  modelDefault(0);
+  // CV1: smooth 5 points curve
+  g_model.curves[0].smooth = 1;
+  int8_t cv1[] = { -100, -20, 10, 60, 90 };
+  memcpy(&g_model.points[0], cv1, sizeof(cv1));
+  // CV2: custom 5 points curve
+  g_model.curves[1].type = CURVE_TYPE_CUSTOM;
+  int8_t cv2[] = { 100, 30, -40, 0, -100, -60, 10, 25 };
+  memcpy(&g_model.points[5], cv2, sizeof(cv2));
+  loadCurves();
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_Rud;
+  g_model.mixData[0].weight = 100;
+  g_model.mixData[0].curve.type = CURVE_REF_CUSTOM;
+  g_model.mixData[0].curve.value = 1;
+  g_model.mixData[1].destCh = 1;
+  g_model.mixData[1].srcRaw = MIXSRC_Ele;
+  g_model.mixData[1].weight = 100;
+  g_model.mixData[1].curve.type = CURVE_REF_CUSTOM;
+  g_model.mixData[1].curve.value = -2;
+  g_model.mixData[2].destCh = 2;
+  g_model.mixData[2].srcRaw = MIXSRC_Thr;
+  g_model.mixData[2].weight = 100;
+  g_model.mixData[2].curve.type = CURVE_REF_EXPO;
+  g_model.mixData[2].curve.value = 40;
+  g_model.mixData[3].destCh = 3;
+  g_model.mixData[3].srcRaw = MIXSRC_Ail;
+  g_model.mixData[3].weight = 100;
+  g_model.mixData[3].curve.type = CURVE_REF_EXPO;
+  g_model.mixData[3].curve.value = -75;
+  invalidateCurvesLut();
+}
+
+TEST(Curves, LookupTables)
+{
+  setupLookupTablesModel();
+
+  // tables are built a chunk at a time
+  int cycles = 1;
+  while (!updateCurvesLut()) {
+    cycles++;
+  }
+  EXPECT_GT(cycles, 1);
+
+  for (int x=-RESX-100; x<=RESX+100; x++) {
+    ASSERT_EQ(applyCustomCurve(x, 0), applyCurve(x, g_model.mixData[0].curve)) << "x=" << x;
+    ASSERT_EQ(applyCustomCurve(-x, 1), applyCurve(x, g_model.mixData[1].curve)) << "x=" << x;
+    ASSERT_EQ(expo(x, 40), applyCurve(x, g_model.mixData[2].curve)) << "x=" << x;
+    ASSERT_EQ(expo(x, -75), applyCurve(x, g_model.mixData[3].curve)) << "x=" << x;
+  }
+
+  // editing a curve disables its table until it is rebuilt
+  g_model.points[2] = 50;
+  invalidateModelPlans();
+  EXPECT_EQ(applyCustomCurve(0, 0), applyCurve(0, g_model.mixData[0].curve));
+  while (!updateCurvesLut());
+  for (int x=-RESX; x<=RESX; x++) {
+    ASSERT_EQ(applyCustomCurve(x, 0), applyCurve(x, g_model.mixData[0].curve)) << "x=" << x;
+  }
+}
+
+// Disabled, run by the benchmarks target
+TEST(CurvesBenchmark, DISABLED_LookupTables)
+{
+  setupLookupTablesModel();
+
+  const int loops = 200;
+  const int calls = loops * (2*RESX+1);
+  volatile int sum = 0;
+  for (int i=0; i<4; i++) {
+    CurveRef & curve = g_model.mixData[i].curve;
+
+    // tables are not used until they are rebuilt
+    invalidateCurvesLut();
+    auto start = std::chrono::steady_clock::now();
+    for (int l=0; l<loops; l++) {
+      for (int x=-RESX; x<=RESX; x++) {
+        sum += applyCurve(x, curve);
+      }
+    }
+    auto computed = std::chrono::steady_clock::now() - start;
+
+    while (!updateCurvesLut());
+    start = std::chrono::steady_clock::now();
+    for (int l=0; l<loops; l++) {
+      for (int x=-RESX; x<=RESX; x++) {
+        sum += applyCurve(x, curve);
+      }
+    }
+    auto lookup = std::chrono::steady_clock::now() - start;
+
+    printf("mix %d (%s %d): computed %.1fns/call, lookup %.1fns/call\n", i, curve.type == CURVE_REF_CUSTOM ? "curve" : "expo", curve.value,
+           std::chrono::duration<double, std::nano>(computed).count() / calls,
+           std::chrono::duration<double, std::nano>(lookup).count() / calls);
+  }
+}
+#endif
+
 
 #if !defined(CPUARM)
 TEST(FlightModes, nullFadeOut_posFadeIn)
@@ -547,6 +652,22 @@ TEST_F(MixerTest, InfiniteRecursiveChannels)
   EXPECT_EQ(chans[0], 0);
 }
 
+#if defined(CPUARM)
+TEST_F(MixerTest, CascadedChannelsReverseOrder)
+{
+  // CH1 <- CH2 <- ... <- CH7 <- MAX, deeper than the 5 passes of the old mixer loop
+  for (int i=0; i<7; i++) {
+    g_model.mixData[i].destCh = i;
+    g_model.mixData[i].srcRaw = (i < 6 ? MIXSRC_CH2+i : MIXSRC_MAX);
+    g_model.mixData[i].weight = 100;
+  }
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  for (int i=0; i<7; i++) {
+    EXPECT_EQ(chans[i], CHANNEL_MAX);
+  }
+}
+#endif
+
 TEST_F(MixerTest, BlockingChannel)
 {
   g_model.mixData[0].destCh = 0;
@@ -600,6 +721,95 @@ TEST_F(MixerTest, RecursiveAddChannelAfterInactivePhase)
   EXPECT_EQ(chans[1], CHANNEL_MAX);
 }
 
+#if defined(CPUARM) && defined(GVARS)
+#define FADE_STEPS 50
+
+// FM0 -> FM1 fade, stores CH1..CH4 outputs at each step
+static void runFlightModesFade(int16_t outputs[FADE_STEPS][4])
+{
+  // no fade in progress, whatever ran before
+  lastFlightMode = 255;
+  g_model.flightModeData[1].fadeIn = 0;
+  g_model.flightModeData[1].swtch = SWSRC_ON;
+  evalMixes(1);
+  g_model.flightModeData[1].swtch = SWSRC_NONE;
+  evalMixes(1);
+  EXPECT_EQ(1024, channelOutputs[0]);
+  EXPECT_EQ(1024, channelOutputs[1]);
+  EXPECT_EQ(1024, channelOutputs[2]);
+  EXPECT_EQ(1024, channelOutputs[3]);
+
+  g_model.flightModeData[1].fadeIn = 10;
+  g_model.flightModeData[1].swtch = SWSRC_ON;
+  evalMixes(1); // FM1 starts with a null weight
+  for (int i=0; i<FADE_STEPS; i++) {
+    evalMixes(1);
+    memcpy(outputs[i], channelOutputs, sizeof(outputs[i]));
+  }
+
+  // run mixes enough time to end the fade (otherwise the mixer internal state flightModesFade could affect other tests)
+  for (int i=0; i<100; i++) {
+    evalMixes(1);
+  }
+  EXPECT_EQ(1024, channelOutputs[0]);
+  EXPECT_EQ(0, channelOutputs[1]);
+  EXPECT_EQ(0, channelOutputs[2]);
+  EXPECT_EQ(0, channelOutputs[3]);
+}
+
+TEST_F(MixerTest, FlightModesFadeSharedChannels)
+{
+  g_model.flightModeData[0].gvars[0] = 100;
+  g_model.flightModeData[1].gvars[0] = 0;
+  // CH1 is the same in both flight modes
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = 100;
+  // CH2 weight is GV1
+  g_model.mixData[1].destCh = 1;
+  g_model.mixData[1].srcRaw = MIXSRC_MAX;
+  g_model.mixData[1].weight = -1024; // GV1
+  // CH3 is only active in FM0
+  g_model.mixData[2].destCh = 2;
+  g_model.mixData[2].srcRaw = MIXSRC_MAX;
+  g_model.mixData[2].flightModes = 0b11110;
+  g_model.mixData[2].weight = 100;
+  // CH4 uses CH2
+  g_model.mixData[3].destCh = 3;
+  g_model.mixData[3].srcRaw = MIXSRC_CH2;
+  g_model.mixData[3].weight = 100;
+
+  int16_t shared[FADE_STEPS][4];
+  runFlightModesFade(shared);
+  int16_t last = 1024;
+  for (int i=0; i<FADE_STEPS; i++) {
+    EXPECT_EQ(1024, shared[i][0]);
+    EXPECT_LT(shared[i][1], last);
+    EXPECT_GT(shared[i][1], 0);
+    EXPECT_EQ(shared[i][1], shared[i][2]);
+    EXPECT_EQ(shared[i][1], shared[i][3]);
+    last = shared[i][1];
+  }
+
+  // CH5 <-> CH6 loop: no mixer plan, each fading flight mode is fully evaluated
+  g_model.mixData[4].destCh = 4;
+  g_model.mixData[4].srcRaw = MIXSRC_CH6;
+  g_model.mixData[4].weight = 100;
+  g_model.mixData[5].destCh = 5;
+  g_model.mixData[5].srcRaw = MIXSRC_CH5;
+  g_model.mixData[5].weight = 100;
+  invalidateModelPlans();
+
+  int16_t full[FADE_STEPS][4];
+  runFlightModesFade(full);
+  for (int i=0; i<FADE_STEPS; i++) {
+    for (int ch=0; ch<4; ch++) {
+      EXPECT_EQ(full[i][ch], shared[i][ch]) << "step " << i << " CH" << ch+1;
+    }
+  }
+}
+#endif
+
 #if !defined(CPUARM)
 TEST_F(MixerTest, SlowOnSwitch)
 {
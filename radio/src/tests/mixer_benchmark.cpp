@@ -0,0 +1,339 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Mixer benchmark
+ *
+ * Times evalMixes() and doMixerCalculations() on synthetic models of growing size.
+ * The tests are disabled, they are run by the mixer-benchmark target:
+ *
+ *   gtests --gtest_also_run_disabled_tests --gtest_filter=MixerBenchmark.*
+ *          [--benchmark-json <file>] [--benchmark-baseline <file>] [--benchmark-tolerance <percent>]
+ *
+ * The results are written as JSON. When a baseline (the JSON written by a previous run)
+ * is given, each model is compared to it and the test fails when a model got slower
+ * than the tolerance (30% by default). The numbers are only meaningful compared to
+ * another run on the same machine.
+ */
+
+#include <chrono>
+#include "gtests.h"
+
+#if defined(CPUARM) && defined(VIRTUAL_INPUTS)
+
+#define BENCHMARK_CYCLES   5000
+#define BENCHMARK_REPEATS  9
+
+struct BenchmarkModel {
+  const char * name;
+  uint8_t inputs;
+  uint8_t mixes;
+  bool curves;
+  uint8_t gvars;
+  uint8_t logicalSwitches;
+  bool heli;
+  bool fade;
+};
+
+static const BenchmarkModel benchmarkModels[] = {
+  // name          inputs  mixes  curves  gvars  LS  heli   fade
+  { "minimal",          4,     4, false,      0,  0, false, false },
+  { "medium",          16,    32, false,      0,  0, false, false },
+  { "large",           32,    64, false,      0,  0, false, false },
+  { "curves",          32,    64, true,       0,  0, false, false },
+  { "gvars",           32,    64, false,      9,  0, false, false },
+  { "switches",        32,    64, false,      0, 64, false, false },
+  { "heli",            16,    32, false,      0,  0, true,  false },
+  { "fade",            32,    64, true,       9, 16, false, true  },
+  { "full",            32,    64, true,       9, 64, true,  true  },
+};
+
+struct BenchmarkResult {
+  double evalMixes;              // ns per cycle
+  double mixerCalculations;      // ns per cycle
+};
+
+// GVars are stored in the upper part of the weights range
+#define BENCHMARK_GVAR_WEIGHT(gv)      ((gv) - GV1_LARGE)
+
+static void generateBenchmarkModel(const BenchmarkModel & model)
+{
+  SYSTEM_RESET();
+  MODEL_RESET();
+  MIXER_RESET();
+  modelDefault(0);
+  clearInputs();
+  memclear(g_model.mixData, sizeof(g_model.mixData));
+  memclear(g_model.logicalSw, sizeof(g_model.logicalSw));
+
+  // inputs, one line per input, and one more on a logical switch when there is room for it
+  uint8_t expoLine = 0;
+  for (uint8_t i=0; i<model.inputs; i++) {
+    uint8_t lines = (model.logicalSwitches && model.inputs * 2 <= MAX_EXPOS) ? 2 : 1;
+    for (uint8_t l=0; l<lines; l++) {
+      ExpoData * ed = expoAddress(expoLine++);
+      ed->mode = 3;
+      ed->chn = i;
+      ed->srcRaw = MIXSRC_FIRST_STICK + i % (NUM_STICKS+NUM_POTS+NUM_SLIDERS);
+      ed->weight = 100 - i;
+      if (l == 0 && lines > 1)
+        ed->swtch = SWSRC_FIRST_LOGICAL_SWITCH + i % model.logicalSwitches;
+      if (model.curves) {
+        ed->curve.type = CURVE_REF_EXPO;
+        ed->curve.value = 10 + i;
+      }
+      if (model.fade && (i % 4) == 0) {
+        ed->flightModes = (l == 0 ? 0b00010 : 0);
+      }
+    }
+  }
+
+  // curves, a smooth one and a custom one
+  if (model.curves) {
+    g_model.curves[0].smooth = 1;
+    int8_t cv1[] = { -100, -20, 10, 60, 90 };
+    memcpy(&g_model.points[0], cv1, sizeof(cv1));
+    g_model.curves[1].type = CURVE_TYPE_CUSTOM;
+    int8_t cv2[] = { 100, 30, -40, 0, -100, -60, 10, 25 };
+    memcpy(&g_model.points[5], cv2, sizeof(cv2));
+    loadCurves();
+  }
+
+  // mixes, spread on the channels, some of them use other channels
+  uint8_t mixesPerChannel = max<uint8_t>(1, (model.mixes + MAX_OUTPUT_CHANNELS - 1) / MAX_OUTPUT_CHANNELS);
+  for (uint8_t i=0; i<model.mixes; i++) {
+    MixData * md = mixAddress(i);
+    md->destCh = i / mixesPerChannel;
+    md->srcRaw = MIXSRC_FIRST_INPUT + i % model.inputs;
+    md->mltpx = (i % mixesPerChannel) ? MLTPX_ADD : MLTPX_REP;
+    md->weight = 100 - i % 50;
+    if (md->destCh > 0 && (i % 8) == 7) {
+      md->srcRaw = MIXSRC_CH1 + md->destCh - 1;
+    }
+    if (model.curves) {
+      switch (i % 3) {
+        case 0:
+          md->curve.type = CURVE_REF_CUSTOM;
+          md->curve.value = 1 + i % 2;
+          break;
+        case 1:
+          md->curve.type = CURVE_REF_DIFF;
+          md->curve.value = 20;
+          break;
+        default:
+          md->curve.type = CURVE_REF_EXPO;
+          md->curve.value = 40;
+          break;
+      }
+    }
+    if (model.gvars && (i % 2) == 0) {
+      md->weight = BENCHMARK_GVAR_WEIGHT(i % model.gvars);
+    }
+    if (model.logicalSwitches && (i % 4) == 1) {
+      md->swtch = SWSRC_FIRST_LOGICAL_SWITCH + i % model.logicalSwitches;
+    }
+    if (model.fade && (i % 5) == 0) {
+      md->flightModes = 0b00001;
+    }
+  }
+
+  // logical switches on the inputs, chained by AND
+  for (uint8_t i=0; i<model.logicalSwitches; i++) {
+    LogicalSwitchData * cs = lswAddress(i);
+    if (i % 3 == 2) {
+      cs->func = LS_FUNC_AND;
+      cs->v1 = SWSRC_FIRST_LOGICAL_SWITCH + i - 2;
+      cs->v2 = SWSRC_FIRST_LOGICAL_SWITCH + i - 1;
+    }
+    else {
+      cs->func = (i % 2) ? LS_FUNC_VPOS : LS_FUNC_ANEG;
+      cs->v1 = MIXSRC_FIRST_INPUT + i % model.inputs;
+      cs->v2 = (i * 37) % 200 - 100;
+    }
+  }
+
+  for (uint8_t gv=0; gv<model.gvars; gv++) {
+    g_model.flightModeData[0].gvars[gv] = 50 + gv * 5;
+    g_model.flightModeData[1].gvars[gv] = model.fade && (gv % 2) ? -30 : 50 + gv * 5;
+  }
+
+  if (model.heli) {
+    g_model.swashR.type = SWASH_TYPE_120;
+    g_model.swashR.value = 80;
+    g_model.swashR.collectiveSource = MIXSRC_Thr;
+    g_model.swashR.elevatorSource = MIXSRC_Ele;
+    g_model.swashR.aileronSource = MIXSRC_Ail;
+    g_model.swashR.collectiveWeight = 100;
+    g_model.swashR.elevatorWeight = 100;
+    g_model.swashR.aileronWeight = 100;
+    for (uint8_t i=0; i<3 && i<model.mixes; i++) {
+      mixAddress(i)->srcRaw = MIXSRC_CYC1 + i;
+    }
+  }
+
+  if (model.fade) {
+    g_model.flightModeData[1].fadeIn = 255;
+    g_model.flightModeData[1].fadeOut = 255;
+    setTrimValue(1, 0, 100);
+  }
+
+  invalidateModelPlans();
+}
+
+static void moveBenchmarkSticks(uint32_t cycle)
+{
+  for (int i=0; i<NUM_STICKS+NUM_POTS+NUM_SLIDERS; i++) {
+    anaInValues[i] = (cycle * (7 + i * 13)) % (2*RESX) - RESX;
+  }
+}
+
+// a new fade starts at each measure, the fade time is longer than the measure
+static void startBenchmarkFade(const BenchmarkModel & model, int phase)
+{
+  if (model.fade) {
+    g_model.flightModeData[1].swtch = (phase % 2) ? SWSRC_NONE : SWSRC_ON;
+  }
+}
+
+static void stopBenchmarkFade()
+{
+  g_model.flightModeData[1].fadeIn = 0;
+  g_model.flightModeData[1].fadeOut = 0;
+  g_model.flightModeData[1].swtch = SWSRC_ON;
+  evalMixes(1);
+  g_model.flightModeData[1].swtch = SWSRC_NONE;
+  evalMixes(1);
+}
+
+template <class F>
+static double timeBenchmarkCycles(const BenchmarkModel & model, int phase, F cycle)
+{
+  // warm up the caches before the measure
+  for (uint32_t i=0; i<BENCHMARK_CYCLES/10; i++) {
+    moveBenchmarkSticks(i);
+    cycle();
+  }
+
+  startBenchmarkFade(model, phase);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i=0; i<BENCHMARK_CYCLES; i++) {
+    moveBenchmarkSticks(i);
+    cycle();
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / BENCHMARK_CYCLES;
+}
+
+static BenchmarkResult runBenchmarkModel(const BenchmarkModel & model)
+{
+  BenchmarkResult result;
+
+  generateBenchmarkModel(model);
+  evalMixes(1); // the mixer plan and the curves tables are built on the first cycles
+  while (!updateCurvesLut());
+
+  result.evalMixes = timeBenchmarkCycles(model, 0, [] { evalMixes(1); });
+  result.mixerCalculations = timeBenchmarkCycles(model, 1, [] { g_tmr10ms++; doMixerCalculations(); });
+
+  stopBenchmarkFade();
+  return result;
+}
+
+// the baseline is a JSON file written by a previous run, one model per line
+static bool readBenchmarkBaseline(const char * name, BenchmarkResult & result)
+{
+  FILE * f = fopen(benchmarkBaselineFile, "r");
+  if (!f)
+    return false;
+
+  char line[512];
+  char key[64];
+  bool found = false;
+  snprintf(key, sizeof(key), "\"name\": \"%s\"", name);
+  while (!found && fgets(line, sizeof(line), f)) {
+    const char * evalMixes = strstr(line, "\"eval_mixes_ns\": ");
+    const char * mixerCalculations = strstr(line, "\"mixer_calculations_ns\": ");
+    if (strstr(line, key) && evalMixes && mixerCalculations) {
+      result.evalMixes = atof(evalMixes + strlen("\"eval_mixes_ns\": "));
+      result.mixerCalculations = atof(mixerCalculations + strlen("\"mixer_calculations_ns\": "));
+      found = true;
+    }
+  }
+
+  fclose(f);
+  return found;
+}
+
+TEST(MixerBenchmark, DISABLED_Models)
+{
+  FILE * json = NULL;
+  if (benchmarkJsonFile) {
+    json = fopen(benchmarkJsonFile, "w");
+    ASSERT_TRUE(json != NULL) << "can't write " << benchmarkJsonFile;
+    fprintf(json, "{\n  \"benchmark\": \"mixer\",\n  \"cycles\": %d,\n  \"repeats\": %d,\n  \"models\": [\n", BENCHMARK_CYCLES, BENCHMARK_REPEATS);
+  }
+
+  // the repeats go through all the models in turn, so that a machine load peak
+  // doesn't disturb all the repeats of the same model. The fastest repeat is kept.
+  const int count = DIM(benchmarkModels);
+  BenchmarkResult results[DIM(benchmarkModels)];
+  for (int r=0; r<BENCHMARK_REPEATS; r++) {
+    for (int i=0; i<count; i++) {
+      BenchmarkResult result = runBenchmarkModel(benchmarkModels[i]);
+      if (r == 0 || result.evalMixes < results[i].evalMixes)
+        results[i].evalMixes = result.evalMixes;
+      if (r == 0 || result.mixerCalculations < results[i].mixerCalculations)
+        results[i].mixerCalculations = result.mixerCalculations;
+    }
+  }
+
+  for (int i=0; i<count; i++) {
+    const BenchmarkModel & model = benchmarkModels[i];
+    const BenchmarkResult & result = results[i];
+    BenchmarkResult baseline;
+    bool hasBaseline = benchmarkBaselineFile && readBenchmarkBaseline(model.name, baseline);
+    double ratio = hasBaseline ? result.evalMixes / baseline.evalMixes : 0;
+
+    printf("%-10s evalMixes %8.0fns doMixerCalculations %8.0fns", model.name, result.evalMixes, result.mixerCalculations);
+    if (hasBaseline)
+      printf(" (baseline %8.0fns, %+.1f%%)", baseline.evalMixes, (ratio - 1) * 100);
+    printf("\n");
+
+    if (json) {
+      fprintf(json, "    {\"name\": \"%s\", \"inputs\": %d, \"mixes\": %d, \"curves\": %s, \"gvars\": %d, \"logical_switches\": %d, \"heli\": %s, \"fade\": %s, "
+                    "\"eval_mixes_ns\": %.1f, \"mixer_calculations_ns\": %.1f",
+              model.name, model.inputs, model.mixes, model.curves ? "true" : "false", model.gvars, model.logicalSwitches,
+              model.heli ? "true" : "false", model.fade ? "true" : "false", result.evalMixes, result.mixerCalculations);
+      if (hasBaseline)
+        fprintf(json, ", \"baseline_eval_mixes_ns\": %.1f, \"baseline_mixer_calculations_ns\": %.1f, \"ratio\": %.3f", baseline.evalMixes, baseline.mixerCalculations, ratio);
+      fprintf(json, "}%s\n", i < count - 1 ? "," : "");
+    }
+
+    if (hasBaseline) {
+      EXPECT_LE(result.evalMixes, baseline.evalMixes * (100 + benchmarkTolerance) / 100) << model.name << ": evalMixes slower than the baseline";
+    }
+  }
+
+  if (json) {
+    fprintf(json, "  ]\n}\n");
+    fclose(json);
+  }
+}
+
+#endif // #if defined(CPUARM) && defined(VIRTUAL_INPUTS)
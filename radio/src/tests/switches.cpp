@@ -18,6 +18,7 @@
  * GNU General Public License for more details.
  */
 
+#include <vector>
 #include "gtests.h"
 
 #if !defined(VIRTUAL_INPUTS)
@@ -368,3 +369,64 @@ TEST(getSwitch, edgeRelease)
 
 }
 #endif // defined(PCBTARANIS)
+
+#if (defined(PCBTARANIS) || defined(PCBHORUS)) && defined(GVARS)
+static void setupLogicalSwitchesPlanModel()
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  setLogicalSwitch(0, LS_FUNC_VPOS, MIXSRC_GVAR1+1, 0);
+  setLogicalSwitch(1, LS_FUNC_AND, SWSRC_SW1, -SWSRC_SW5);              // L5 from the previous pass
+  setLogicalSwitch(2, LS_FUNC_XOR, SWSRC_SW3, SWSRC_SW2);               // itself
+  setLogicalSwitch(3, LS_FUNC_AND, SWSRC_SW2, SWSRC_ON);
+  setLogicalSwitch(4, LS_FUNC_STICKY, SWSRC_SW4, SWSRC_SW1+9);
+  setLogicalSwitch(5, LS_FUNC_EDGE, SWSRC_SW1, -129, 0);
+  setLogicalSwitch(6, LS_FUNC_TIMER, -125, -126, 0, 0, 0, SWSRC_SW1);
+  setLogicalSwitch(7, LS_FUNC_OR, SWSRC_SW4, SWSRC_NONE, 0, 3, 5);     // delay and duration
+  setLogicalSwitch(9, LS_FUNC_VPOS, MIXSRC_GVAR1, 0, 0, 0, 0, SWSRC_SW8);
+  setLogicalSwitch(10, LS_FUNC_AND, SWSRC_SW1+9, -SWSRC_SW7);
+}
+
+static std::vector<uint64_t> runLogicalSwitchesPlanModel(bool fullEvaluation)
+{
+  std::vector<uint64_t> result;
+
+  setupLogicalSwitchesPlanModel();
+  logicalSwitchesReset();
+  srand(42);
+
+  for (int tick=0; tick<3000; tick++) {
+    if (rand() % 16 == 0)
+      g_model.flightModeData[0].gvars[rand() % 2] = rand() % 200 - 100;
+    if (tick % 10 == 0)
+      logicalSwitchesTimerTick();
+    if (fullEvaluation)
+      invalidateLogicalSwitchesPlan();
+    evalLogicalSwitches();
+    uint64_t states = 0;
+    for (int i=0; i<MAX_LOGICAL_SWITCHES; i++) {
+      if (getSwitch(SWSRC_SW1+i))
+        states |= (uint64_t)1 << i;
+    }
+    result.push_back(states);
+  }
+
+  return result;
+}
+
+TEST(evalLogicalSwitches, planSameAsFullEvaluation)
+{
+  std::vector<uint64_t> full = runLogicalSwitchesPlanModel(true);
+  std::vector<uint64_t> plan = runLogicalSwitchesPlanModel(false);
+
+  uint64_t toggled = 0;
+  for (unsigned int tick=0; tick<full.size(); tick++) {
+    ASSERT_EQ(full[tick], plan[tick]) << "tick=" << tick;
+    if (tick > 0)
+      toggled |= full[tick] ^ full[tick-1];
+  }
+
+  // all the logical switches of the model changed at least once
+  EXPECT_EQ(0x6FF, toggled & 0x6FF);
+}
+#endif
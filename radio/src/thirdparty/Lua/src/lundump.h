@@ -22,6 +22,10 @@ LUAI_FUNC int luaU_dump (lua_State* L, const Proto* f, lua_Writer w, void* data,
 /* data to catch conversion errors */
 #define LUAC_TAIL		"\x19\x93\r\n\x1a\n"
 
+/* type of the string sizes in binary files: 32 bits on all the builds (OpenTX),
+   so that the simulators on 64 bits hosts read and write the bytecode of the radio */
+#define LUAC_SIZE_T		lu_int32
+
 /* size in bytes of header of binary files */
 #define LUAC_HEADERSIZE		(sizeof(LUA_SIGNATURE)-sizeof(char)+2+6+sizeof(LUAC_TAIL)-sizeof(char))
 
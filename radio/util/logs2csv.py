@@ -0,0 +1,143 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# This program converts the binary logs (.otl files, LOGS_BINARY firmware
+# option) to the CSV layout written by the radio, as read by Companion.
+
+from __future__ import division, print_function
+
+import argparse
+import os
+import struct
+import sys
+
+
+BLOCK_SIZE = 512
+MAGIC = b'OTXL'
+VERSION = 1
+RECORD_MARKER = ord('R')
+
+HEADER = struct.Struct('<4sBBH')
+
+FIELD_TIME = 1
+FIELD_DATETIME = 2
+FIELD_VALUE = 3
+FIELD_VALUE_PREC1 = 4
+FIELD_VALUE_PREC2 = 5
+FIELD_GPS = 6
+FIELD_SENSOR_DATETIME = 7
+FIELD_ANALOG = 8
+FIELD_SWITCH = 9
+FIELD_LOGICAL_SWITCHES = 10
+
+FIELD_FORMATS = {
+    FIELD_TIME: '<I',
+    FIELD_DATETIME: '<HBBBBBB',
+    FIELD_VALUE: '<i',
+    FIELD_VALUE_PREC1: '<i',
+    FIELD_VALUE_PREC2: '<i',
+    FIELD_GPS: '<ii',
+    FIELD_SENSOR_DATETIME: '<HBBBBB',
+    FIELD_ANALOG: '<h',
+    FIELD_SWITCH: '<b',
+    FIELD_LOGICAL_SWITCHES: '<II',
+}
+
+
+def formatPrec(value, prec):
+    # same as the radio: sign, then abs(quotient).abs(remainder)
+    divider = 10 ** prec
+    quot, rem = abs(value) // divider, abs(value) % divider
+    return "%s%d.%0*d" % ("-" if value < 0 else "", quot, prec, rem)
+
+
+def formatField(fieldType, values):
+    if fieldType == FIELD_TIME:
+        return "%d" % values
+    elif fieldType == FIELD_DATETIME:
+        return "%4d-%02d-%02d,%02d:%02d:%02d.%02d0" % values
+    elif fieldType == FIELD_VALUE or fieldType == FIELD_ANALOG or fieldType == FIELD_SWITCH:
+        return "%d" % values
+    elif fieldType == FIELD_VALUE_PREC1:
+        return formatPrec(values, 1)
+    elif fieldType == FIELD_VALUE_PREC2:
+        return formatPrec(values, 2)
+    elif fieldType == FIELD_GPS:
+        latitude, longitude = values
+        if latitude and longitude:
+            return "%s %s" % (formatPrec(latitude, 6), formatPrec(longitude, 6))
+        return ""
+    elif fieldType == FIELD_SENSOR_DATETIME:
+        return "%4d-%02d-%02d %02d:%02d:%02d" % values
+    elif fieldType == FIELD_LOGICAL_SWITCHES:
+        return "0x%08X%08X" % values
+    raise ValueError("unknown field type %d" % fieldType)
+
+
+class Section:
+    def __init__(self, data, offset):
+        magic, version, fieldsCount, self.recordSize = HEADER.unpack_from(data, offset)
+        if version != VERSION:
+            raise ValueError("unsupported logs version %d at offset %d" % (version, offset))
+        offset += HEADER.size
+        self.fields = []
+        for fieldType in bytearray(data[offset:offset + fieldsCount]):
+            fmt = struct.Struct(FIELD_FORMATS[fieldType])
+            self.fields.append((fieldType, fmt))
+        offset += fieldsCount
+        end = data.index(b'\n', offset)
+        self.columns = data[offset:end + 1].decode('latin-1')
+        self.end = end + 1
+
+    def formatRecord(self, data, offset):
+        result = []
+        offset += 1  # record marker
+        for fieldType, fmt in self.fields:
+            values = fmt.unpack_from(data, offset)
+            offset += fmt.size
+            result.append(formatField(fieldType, values if len(values) > 1 else values[0]))
+        return ",".join(result) + "\n"
+
+
+def convert(data, output):
+    offset = 0
+    section = None
+    columns = None
+    records = 0
+    while offset < len(data):
+        byte = bytearray(data[offset:offset + 1])[0]
+        if byte == 0:
+            # padding up to the next block
+            offset = (offset // BLOCK_SIZE + 1) * BLOCK_SIZE
+        elif data[offset:offset + len(MAGIC)] == MAGIC:
+            section = Section(data, offset)
+            if section.columns != columns:
+                columns = section.columns
+                output.write(columns)
+            offset = section.end
+        elif byte == RECORD_MARKER and section and offset + section.recordSize <= len(data):
+            output.write(section.formatRecord(data, offset))
+            offset += section.recordSize
+            records += 1
+        else:
+            print("Unexpected data at offset %d, skipping to the next block" % offset, file=sys.stderr)
+            offset = (offset // BLOCK_SIZE + 1) * BLOCK_SIZE
+    return records
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert binary radio logs to CSV")
+    parser.add_argument('input', help="binary log file (.otl)")
+    parser.add_argument('output', nargs='?', help="CSV file (default: input file with .csv extension)")
+    args = parser.parse_args()
+
+    output = args.output or os.path.splitext(args.input)[0] + ".csv"
+    with open(args.input, 'rb') as f:
+        data = f.read()
+    with open(output, 'w') as f:
+        records = convert(data, f)
+    print("%d records written to %s" % (records, output))
+
+
+if __name__ == "__main__":
+    main()
@@ -126,7 +126,8 @@ with open(outputFile, "w") as out:
 
     out.write("""
     // The list of Lua fields
-    // this aray is alphabetically sorted by the second field (name)
+    // this aray is alphabetically sorted by the second field (name),
+    // luaFindFieldByName() does a binary search in it
     const LuaSingleField luaSingleFields[] = {
     """)
     exports.sort(key=lambda x: x[1])  # sort by name